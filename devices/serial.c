@@ -1,7 +1,7 @@
 #include "devices/serial.h"
 #include <debug.h>
+#include <string.h>
 #include "devices/input.h"
-#include "devices/intq.h"
 #include "devices/timer.h"
 #include "threads/io.h"
 #include "threads/interrupt.h"
@@ -37,6 +37,12 @@
 #define IER_RECV 0x01           /* Interrupt when data received. */
 #define IER_XMIT 0x02           /* Interrupt when transmit finishes. */
 
+/* FIFO Control Register bits. */
+#define FCR_FIFO 0x01           /* Enable the 16-byte FIFOs. */
+
+/* Bytes the transmit FIFO holds once it is empty. */
+#define TX_FIFO_SIZE 16
+
 /* Line Control Register bits. */
 #define LCR_N81 0x03            /* No parity, 8 data bits, 1 stop bit. */
 #define LCR_DLAB 0x80           /* Divisor Latch Access Bit (DLAB). */
@@ -51,12 +57,22 @@
 /* Transmission mode. */
 static enum { UNINIT, POLL, QUEUE } mode;
 
-/* Data to be transmitted. */
-static struct intq txq;
+/* Data to be transmitted: a ring that the interrupt handler drains a
+   FIFO's worth at a time.  Indexes run freely and are reduced modulo
+   TXQ_SIZE, a power of 2, on use. */
+#define TXQ_SIZE 4096
+static uint8_t txq[TXQ_SIZE];
+static size_t txq_head;                 /* Next byte goes in here. */
+static size_t txq_tail;                 /* Next byte goes out from here. */
+static struct thread *txq_waiter;       /* Thread waiting for room. */
 
 static void set_serial (int bps);
 static void putc_poll (uint8_t);
 static void write_ier (void);
+static bool txq_empty (void);
+static bool txq_full (void);
+static uint8_t txq_getc (void);
+static bool txq_wait (enum intr_level);
 static intr_handler_func serial_interrupt;
 
 /* Initializes the serial port device for polling mode.
@@ -70,7 +86,6 @@ init_poll (void) {
 	outb (FCR_REG, 0);                    /* Disable FIFO. */
 	set_serial (115200);                  /* 115.2 kbps, N-8-1. */
 	outb (MCR_REG, MCR_OUT2);             /* Required to enable interrupts. */
-	intq_init (&txq);
 	mode = POLL;
 }
 
@@ -86,6 +101,7 @@ serial_init_queue (void) {
 	ASSERT (mode == POLL);
 
 	intr_register_ext (0x20 + 4, serial_interrupt, "serial");
+	outb (FCR_REG, FCR_FIFO);
 	mode = QUEUE;
 	old_level = intr_disable ();
 	write_ier ();
@@ -106,29 +122,61 @@ serial_putc (uint8_t byte) {
 	} else {
 		/* Otherwise, queue a byte and update the interrupt enable
 		   register. */
-		if (old_level == INTR_OFF && intq_full (&txq)) {
-			/* Interrupts are off and the transmit queue is full.
-			   If we wanted to wait for the queue to empty,
-			   we'd have to reenable interrupts.
-			   That's impolite, so we'll send a character via
-			   polling instead. */
-			putc_poll (intq_getc (&txq));
-		}
+		while (txq_full ())
+			if (!txq_wait (old_level))
+				putc_poll (txq_getc ());
 
-		intq_putc (&txq, byte);
+		txq[txq_head++ % TXQ_SIZE] = byte;
 		write_ier ();
 	}
 
 	intr_set_level (old_level);
 }
 
+/* Sends the N bytes in BUFFER to the serial port, queueing as many
+   at once as there is room for.  While the transmit queue is full,
+   sleeps until the interrupt handler drains it, if it can. */
+void
+serial_putbuf (const uint8_t *buffer, size_t n) {
+	enum intr_level old_level = intr_disable ();
+
+	if (mode != QUEUE) {
+		if (mode == UNINIT)
+			init_poll ();
+		while (n-- > 0)
+			putc_poll (*buffer++);
+	} else {
+		while (n > 0) {
+			size_t ofs = txq_head % TXQ_SIZE;
+			size_t chunk = TXQ_SIZE - (txq_head - txq_tail);
+
+			if (chunk == 0) {
+				if (!txq_wait (old_level))
+					putc_poll (txq_getc ());
+				continue;
+			}
+			if (chunk > TXQ_SIZE - ofs)
+				chunk = TXQ_SIZE - ofs;
+			if (chunk > n)
+				chunk = n;
+			memcpy (txq + ofs, buffer, chunk);
+			txq_head += chunk;
+			buffer += chunk;
+			n -= chunk;
+			write_ier ();
+		}
+	}
+
+	intr_set_level (old_level);
+}
+
 /* Flushes anything in the serial buffer out the port in polling
    mode. */
 void
 serial_flush (void) {
 	enum intr_level old_level = intr_disable ();
-	while (!intq_empty (&txq))
-		putc_poll (intq_getc (&txq));
+	while (!txq_empty ())
+		putc_poll (txq_getc ());
 	intr_set_level (old_level);
 }
 
@@ -171,7 +219,7 @@ write_ier (void) {
 
 	/* Enable transmit interrupt if we have any characters to
 	   transmit. */
-	if (!intq_empty (&txq))
+	if (!txq_empty ())
 		ier |= IER_XMIT;
 
 	/* Enable receive interrupt if we have room to store any
@@ -205,11 +253,54 @@ serial_interrupt (struct intr_frame *f UNUSED) {
 	while (!input_full () && (inb (LSR_REG) & LSR_DR) != 0)
 		input_putc (inb (RBR_REG));
 
-	/* As long as we have a byte to transmit, and the hardware is
-	   ready to accept a byte for transmission, transmit a byte. */
-	while (!intq_empty (&txq) && (inb (LSR_REG) & LSR_THRE) != 0)
-		outb (THR_REG, intq_getc (&txq));
+	/* Once the transmit FIFO is empty, refill it in one go, and
+	   again as long as it empties right away. */
+	while (!txq_empty () && (inb (LSR_REG) & LSR_THRE) != 0)
+		for (int i = 0; i < TX_FIFO_SIZE && !txq_empty (); i++)
+			outb (THR_REG, txq_getc ());
+
+	/* Wake up a writer waiting for room. */
+	if (txq_waiter != NULL && !txq_full ()) {
+		thread_unblock (txq_waiter);
+		txq_waiter = NULL;
+	}
 
 	/* Update interrupt enable register based on queue status. */
 	write_ier ();
 }
+
+/* Returns true if there is nothing to transmit. */
+static bool
+txq_empty (void) {
+	return txq_head == txq_tail;
+}
+
+/* Returns true if the transmit queue has no room. */
+static bool
+txq_full (void) {
+	return txq_head - txq_tail == TXQ_SIZE;
+}
+
+/* Removes and returns the next byte to transmit. */
+static uint8_t
+txq_getc (void) {
+	ASSERT (!txq_empty ());
+	return txq[txq_tail++ % TXQ_SIZE];
+}
+
+/* Sleeps until the interrupt handler makes room in the transmit
+   queue, if it can: the caller must not be an interrupt handler and
+   interrupts must have been on, OLD_LEVEL, when it was called, or
+   they could not come in to drain the queue.  Returns false if it
+   cannot.  Interrupts must be off. */
+static bool
+txq_wait (enum intr_level old_level) {
+	ASSERT (intr_get_level () == INTR_OFF);
+
+	if (old_level == INTR_OFF || intr_context () || txq_waiter != NULL)
+		return false;
+	txq_waiter = thread_current ();
+	write_ier ();
+	thread_block ();
+	return true;
+}
@@ -7,6 +7,9 @@
 #include "threads/io.h"
 #include "threads/synch.h"
 #include "threads/thread.h"
+#ifdef USERPROG
+#include "userprog/vdso.h"
+#endif
 
 /* See [8254] for hardware details of the 8254 timer chip. */
 
@@ -130,6 +133,9 @@ timer_print_stats (void) {
 static void
 timer_interrupt (struct intr_frame *args UNUSED) {
 	ticks++;
+#ifdef USERPROG
+	vdso_tick (ticks);
+#endif
 	thread_tick ();
 	if (thread_mlfqs){ // mlfqs 관련 변경
 		mlfqs_increment();
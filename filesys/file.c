@@ -1,6 +1,7 @@
 #include "filesys/file.h"
 #include <debug.h>
 #include "filesys/inode.h"
+#include "filesys/pipe.h"
 #include "threads/malloc.h"
 
 /* An open file. */
@@ -8,7 +9,7 @@
 // 	struct inode *inode;        /* File's inode. */
 // 	off_t pos;                  /* Current position. */
 // 	bool deny_write;            /* Has file_deny_write() been called? */
-// 	int dup_count;              /* duplicated count */
+// 	int ref_cnt;                /* References, e.g. fds sharing it via dup2. */
 // };
 
 /* Opens a file for the given INODE, of which it takes ownership,
@@ -21,7 +22,7 @@ file_open (struct inode *inode) {
 		file->inode = inode;
 		file->pos = 0;
 		file->deny_write = false;
-		file->dup_count = 0;
+		file->ref_cnt = 1;
 		return file;
 	} else {
 		inode_close (inode);
@@ -30,33 +31,67 @@ file_open (struct inode *inode) {
 	}
 }
 
-/* Opens and returns a new file for the same inode as FILE.
+/* Opens and returns a new file for the same inode as FILE, or another
+ * end of the same kind if FILE is a pipe end.
  * Returns a null pointer if unsuccessful. */
 struct file *
 file_reopen (struct file *file) {
+	if (file->pipe != NULL)
+		return file_open_pipe (file->pipe, file->pipe_write_end);
 	return file_open (inode_reopen (file->inode));
 }
 
 /* Duplicate the file object including attributes and returns a new file for the
- * same inode as FILE. Returns a null pointer if unsuccessful. */
+ * same inode as FILE, with a position of its own and a single reference.
+ * A pipe end is duplicated as another end of the same kind.
+ * Returns a null pointer if unsuccessful. */
 struct file *
 file_duplicate (struct file *file) {
-	struct file *nfile = file_open (inode_reopen (file->inode));
+	struct file *nfile;
+
+	if (file->pipe != NULL)
+		return file_open_pipe (file->pipe, file->pipe_write_end);
+	nfile = file_open (inode_reopen (file->inode));
 	if (nfile) {
 		nfile->pos = file->pos;
 		if (file->deny_write)
 			file_deny_write (nfile);
-		nfile->dup_count = file->dup_count;
 	}
 	return nfile;
 }
 
-/* Closes FILE. */
+/* Adds a reference to FILE, which then shares its position with the
+ * holder of the other references, and returns FILE. */
+struct file *
+file_dup (struct file *file) {
+	file->ref_cnt++;
+	return file;
+}
+
+/* Opens and returns a new read end, or write end if WRITE_END is true,
+ * of PIPE.  Returns a null pointer if an allocation fails. */
+struct file *
+file_open_pipe (struct pipe *pipe, bool write_end) {
+	struct file *file = calloc (1, sizeof *file);
+	if (file != NULL) {
+		file->pipe = pipe;
+		file->pipe_write_end = write_end;
+		file->ref_cnt = 1;
+		pipe_open (pipe, write_end);
+	}
+	return file;
+}
+
+/* Drops a reference to FILE and closes it with the last one. */
 void
 file_close (struct file *file) {
-	if (file != NULL) {
-		file_allow_write (file);
-		inode_close (file->inode);
+	if (file != NULL && --file->ref_cnt == 0) {
+		if (file->pipe != NULL)
+			pipe_close (file->pipe, file->pipe_write_end);
+		else {
+			file_allow_write (file);
+			inode_close (file->inode);
+		}
 		free (file);
 	}
 }
@@ -33,6 +33,7 @@ struct inode {
 	int open_cnt;                       /* Number of openers. */
 	bool removed;                       /* True if deleted, false otherwise. */
 	int deny_write_cnt;                 /* 0: writes ok, >0: deny writes. */
+	unsigned write_cnt;                 /* Writes since it was opened. */
 	struct inode_disk data;             /* Inode content. */
 };
 
@@ -124,6 +125,7 @@ inode_open (disk_sector_t sector) {
 	inode->sector = sector;
 	inode->open_cnt = 1;
 	inode->deny_write_cnt = 0;
+	inode->write_cnt = 0;
 	inode->removed = false;
 	disk_read (filesys_disk, inode->sector, &inode->data);
 	return inode;
@@ -239,6 +241,7 @@ inode_write_at (struct inode *inode, const void *buffer_, off_t size,
 
 	if (inode->deny_write_cnt)
 		return 0;
+	inode->write_cnt++;
 
 	while (size > 0) {
 		/* Sector to write, starting byte offset within sector. */
@@ -311,3 +314,10 @@ off_t
 inode_length (const struct inode *inode) {
 	return inode->data.length;
 }
+
+/* Returns the number of writes to INODE since it was opened, so that
+ * whoever keeps it open can tell whether its contents changed. */
+unsigned
+inode_write_count (const struct inode *inode) {
+	return inode->write_cnt;
+}
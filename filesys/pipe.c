@@ -0,0 +1,227 @@
+#include "filesys/pipe.h"
+#include <debug.h>
+#include <string.h>
+#include "filesys/file.h"
+#include "threads/interrupt.h"
+#include "threads/malloc.h"
+#include "threads/palloc.h"
+#include "threads/synch.h"
+#include "threads/vaddr.h"
+
+/* Bytes a pipe holds. */
+#define PIPE_SIZE PGSIZE
+
+/* A pipe: a ring of PIPE_SIZE bytes between one reader and one writer.
+
+   HEAD and TAIL run freely and are reduced modulo PIPE_SIZE on use.
+   Only the writer advances HEAD and only the reader advances TAIL, so
+   the two sides never take a lock in common.  Readers, and writers,
+   that share an end through fork() take turns through READ_LOCK, and
+   WRITE_LOCK.  A side with a single open end skips its lock: only a
+   holder of an end can fork() it, and dup2() shares an end within one
+   process, so no one else can enter that side while it is in use.
+
+   A side that finds the ring empty, or full, announces itself in
+   READER_WAITING, or WRITER_WAITING, checks again and sleeps on its
+   semaphore.  The other side ups the semaphore after moving HEAD or
+   TAIL if it sees the flag, so a wakeup cannot be lost between the
+   check and the sleep.  A stray up only makes a sleeper look again. */
+struct pipe {
+	uint8_t *buf;                       /* PIPE_SIZE bytes of data. */
+	size_t head;                        /* Next byte goes in here. */
+	size_t tail;                        /* Next byte comes out from here. */
+	int readers;                        /* Open read ends. */
+	int writers;                        /* Open write ends. */
+	struct lock read_lock;              /* Held by a shared reader. */
+	struct lock write_lock;             /* Held by a shared writer. */
+	bool reader_waiting;                /* Reader sleeps on READABLE? */
+	bool writer_waiting;                /* Writer sleeps on WRITABLE? */
+	struct semaphore readable;          /* Upped when data comes in. */
+	struct semaphore writable;          /* Upped when room comes free. */
+};
+
+/* Creates a pipe and opens both of its ends, storing them in
+   *READ_END and *WRITE_END.  Returns true if successful, false if
+   memory allocation fails. */
+bool
+pipe_create (struct file **read_end, struct file **write_end) {
+	struct pipe *pipe = malloc (sizeof *pipe);
+
+	if (pipe == NULL)
+		return false;
+	pipe->buf = palloc_get_page (0);
+	if (pipe->buf == NULL) {
+		free (pipe);
+		return false;
+	}
+	pipe->head = pipe->tail = 0;
+	pipe->readers = pipe->writers = 0;
+	lock_init (&pipe->read_lock);
+	lock_init (&pipe->write_lock);
+	pipe->reader_waiting = pipe->writer_waiting = false;
+	sema_init (&pipe->readable, 0);
+	sema_init (&pipe->writable, 0);
+
+	*read_end = file_open_pipe (pipe, false);
+	*write_end = *read_end != NULL ? file_open_pipe (pipe, true) : NULL;
+	if (*write_end == NULL) {
+		if (*read_end != NULL)
+			file_close (*read_end);
+		else {
+			palloc_free_page (pipe->buf);
+			free (pipe);
+		}
+		return false;
+	}
+	return true;
+}
+
+/* Wakes up the reader of PIPE if it is asleep. */
+static void
+wake_reader (struct pipe *pipe) {
+	barrier ();
+	if (pipe->reader_waiting) {
+		pipe->reader_waiting = false;
+		sema_up (&pipe->readable);
+	}
+}
+
+/* Wakes up the writer of PIPE if it is asleep. */
+static void
+wake_writer (struct pipe *pipe) {
+	barrier ();
+	if (pipe->writer_waiting) {
+		pipe->writer_waiting = false;
+		sema_up (&pipe->writable);
+	}
+}
+
+/* Counts one more open read end, or write end if WRITE_END is true,
+   of PIPE. */
+void
+pipe_open (struct pipe *pipe, bool write_end) {
+	enum intr_level old_level = intr_disable ();
+
+	if (write_end)
+		pipe->writers++;
+	else
+		pipe->readers++;
+	intr_set_level (old_level);
+}
+
+/* Closes a read end, or write end if WRITE_END is true, of PIPE.
+   Closing the last write end lets the reader see end of file and
+   closing the last read end makes writes fail, so the other side is
+   woken up.  PIPE is freed along with its last end. */
+void
+pipe_close (struct pipe *pipe, bool write_end) {
+	enum intr_level old_level = intr_disable ();
+	bool last;
+
+	if (write_end) {
+		ASSERT (pipe->writers > 0);
+		if (--pipe->writers == 0)
+			wake_reader (pipe);
+	} else {
+		ASSERT (pipe->readers > 0);
+		if (--pipe->readers == 0)
+			wake_writer (pipe);
+	}
+	last = pipe->readers == 0 && pipe->writers == 0;
+	intr_set_level (old_level);
+
+	if (last) {
+		palloc_free_page (pipe->buf);
+		free (pipe);
+	}
+}
+
+/* Reads up to SIZE bytes from PIPE into BUFFER.  If the pipe is empty
+   and BLOCK is true, first waits for data or for the last write end
+   to be closed.  Returns the number of bytes actually read, which is 0
+   at end of file. */
+off_t
+pipe_read (struct pipe *pipe, void *buffer_, off_t size, bool block) {
+	uint8_t *buffer = buffer_;
+	off_t bytes_read = 0;
+	bool shared = pipe->readers > 1;
+	size_t avail;
+
+	if (shared)
+		lock_acquire (&pipe->read_lock);
+	while ((avail = pipe->head - pipe->tail) == 0 && block
+			&& pipe->writers > 0) {
+		pipe->reader_waiting = true;
+		barrier ();
+		if (pipe->head == pipe->tail && pipe->writers > 0)
+			sema_down (&pipe->readable);
+		pipe->reader_waiting = false;
+	}
+	barrier ();
+
+	while (size > 0 && avail > 0) {
+		size_t ofs = pipe->tail % PIPE_SIZE;
+		size_t chunk = PIPE_SIZE - ofs;
+
+		if (chunk > avail)
+			chunk = avail;
+		if (chunk > (size_t) size)
+			chunk = size;
+		memcpy (buffer + bytes_read, pipe->buf + ofs, chunk);
+		barrier ();
+		pipe->tail += chunk;
+		bytes_read += chunk;
+		size -= chunk;
+		avail -= chunk;
+	}
+	if (bytes_read > 0)
+		wake_writer (pipe);
+	if (shared)
+		lock_release (&pipe->read_lock);
+
+	return bytes_read;
+}
+
+/* Writes SIZE bytes from BUFFER into PIPE, waiting for room as
+   needed.  Returns the number of bytes actually written, which is
+   less than SIZE only if the last read end is closed, or -1 if no byte
+   could be written for that reason. */
+off_t
+pipe_write (struct pipe *pipe, const void *buffer_, off_t size) {
+	const uint8_t *buffer = buffer_;
+	off_t bytes_written = 0;
+	bool shared = pipe->writers > 1;
+
+	if (shared)
+		lock_acquire (&pipe->write_lock);
+	while (size > 0 && pipe->readers > 0) {
+		size_t room = PIPE_SIZE - (pipe->head - pipe->tail);
+		size_t ofs = pipe->head % PIPE_SIZE;
+		size_t chunk = PIPE_SIZE - ofs;
+
+		if (room == 0) {
+			pipe->writer_waiting = true;
+			barrier ();
+			if (pipe->head - pipe->tail == PIPE_SIZE && pipe->readers > 0)
+				sema_down (&pipe->writable);
+			pipe->writer_waiting = false;
+			continue;
+		}
+		barrier ();
+
+		if (chunk > room)
+			chunk = room;
+		if (chunk > (size_t) size)
+			chunk = size;
+		memcpy (pipe->buf + ofs, buffer + bytes_written, chunk);
+		barrier ();
+		pipe->head += chunk;
+		bytes_written += chunk;
+		size -= chunk;
+		wake_reader (pipe);
+	}
+	if (shared)
+		lock_release (&pipe->write_lock);
+
+	return bytes_written > 0 || size == 0 ? bytes_written : -1;
+}
@@ -9,14 +9,20 @@ struct file {
 	struct inode *inode;        /* File's inode. */
 	off_t pos;                  /* Current position. */
 	bool deny_write;            /* Has file_deny_write() been called? */
-	int dup_count;              /* duplicated count */
+	int ref_cnt;                /* References, e.g. fds sharing it via dup2. */
+	struct file *fork_copy;     /* The child's copy while forking. */
+	struct pipe *pipe;          /* Pipe of a pipe end, else null. */
+	bool pipe_write_end;        /* Write end of PIPE? */
 };
 struct inode;
+struct pipe;
 
 /* Opening and closing files. */
 struct file *file_open (struct inode *);
 struct file *file_reopen (struct file *);
 struct file *file_duplicate (struct file *file);
+struct file *file_dup (struct file *);
+struct file *file_open_pipe (struct pipe *, bool write_end);
 void file_close (struct file *);
 struct inode *file_get_inode (struct file *);
 
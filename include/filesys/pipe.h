@@ -0,0 +1,16 @@
+#ifndef FILESYS_PIPE_H
+#define FILESYS_PIPE_H
+
+#include <stdbool.h>
+#include "filesys/off_t.h"
+
+struct file;
+struct pipe;
+
+bool pipe_create (struct file **read_end, struct file **write_end);
+void pipe_open (struct pipe *, bool write_end);
+void pipe_close (struct pipe *, bool write_end);
+off_t pipe_read (struct pipe *, void *, off_t size, bool block);
+off_t pipe_write (struct pipe *, const void *, off_t size);
+
+#endif /* filesys/pipe.h */
@@ -0,0 +1,59 @@
+#ifndef __LIB_AIO_H
+#define __LIB_AIO_H
+
+#include <stdint.h>
+
+/* Asynchronous file I/O through a submission/completion ring in user
+ * memory, registered with aio_setup().
+ *
+ * The process fills sq[sq_tail % AIO_SQ_ENTRIES] and advances sq_tail to
+ * queue operations without a system call.  aio_enter() hands up to
+ * TO_SUBMIT queued operations to a kernel worker, advancing sq_head, and
+ * returns once MIN_COMPLETE completions are waiting in the completion
+ * queue.  The kernel fills cq[cq_tail % AIO_CQ_ENTRIES] and advances
+ * cq_tail; the process consumes completions by advancing cq_head.
+ * Operations of one batch are carried out in order, but the results of a
+ * batch only become visible at a later aio_enter(). */
+
+#define AIO_SQ_ENTRIES 32       /* Submission queue slots. */
+#define AIO_CQ_ENTRIES 64       /* Completion queue slots. */
+
+/* Longest read or write one operation transfers. */
+#define AIO_MAX_LEN (64 * 1024)
+
+/* Operations. */
+enum aio_op {
+	AIO_NOP,                    /* Complete with 0. */
+	AIO_READ,                   /* pread(fd, buf, len, offset). */
+	AIO_WRITE,                  /* pwrite(fd, buf, len, offset). */
+	AIO_OPEN,                   /* open(buf), the result is the new fd. */
+	AIO_CLOSE,                  /* close(fd). */
+};
+
+/* One submitted operation. */
+struct aio_sqe {
+	uint64_t user_data;         /* Copied into the completion. */
+	void *buf;                  /* Buffer, or file name for AIO_OPEN. */
+	int fd;                     /* File descriptor. */
+	unsigned len;               /* Bytes to transfer. */
+	int32_t offset;             /* File offset, ignored for the console. */
+	uint8_t opcode;             /* One of enum aio_op. */
+};
+
+/* One completed operation. */
+struct aio_cqe {
+	uint64_t user_data;         /* From the submission. */
+	int res;                    /* What the system call would return. */
+};
+
+/* The ring. */
+struct aio_ring {
+	unsigned sq_head;           /* Next submission the kernel takes. */
+	unsigned sq_tail;           /* Next free submission slot. */
+	unsigned cq_head;           /* Next completion the process takes. */
+	unsigned cq_tail;           /* Next free completion slot. */
+	struct aio_sqe sq[AIO_SQ_ENTRIES];
+	struct aio_cqe cq[AIO_CQ_ENTRIES];
+};
+
+#endif /* lib/aio.h */
@@ -0,0 +1,18 @@
+#ifndef __LIB_MEMSTAT_H
+#define __LIB_MEMSTAT_H
+
+/* Memory usage of a process, as returned by the memstat() system call.
+ * All sizes are in pages. */
+struct memstat {
+	long long rss;              /* Pages with a frame of their own. */
+	long long swapped;          /* Anonymous pages swapped out. */
+	long long wss;              /* Resident pages used in the sample window. */
+	long long minor_faults;     /* Faults served without I/O. */
+	long long major_faults;     /* Faults that read a file or swap disk. */
+	long long evicted;          /* Pages taken away by the evictor. */
+	long long locked;           /* Pages locked in memory by mlock(). */
+	long long prefetched;       /* Pages loaded ahead of a predicted fault. */
+	long long prefetch_wasted;  /* Of those, dropped without being used. */
+};
+
+#endif /* lib/memstat.h */
@@ -0,0 +1,15 @@
+#ifndef __LIB_MMAN_H
+#define __LIB_MMAN_H
+
+/* Advice for the madvise() system call. */
+#define MADV_NORMAL     0       /* No special treatment. */
+#define MADV_RANDOM     1       /* Expect random access: no readahead. */
+#define MADV_SEQUENTIAL 2       /* Expect sequential access: read ahead
+                                   aggressively, drop pages once used. */
+#define MADV_WILLNEED   3       /* Expect access soon: load the range now. */
+#define MADV_DONTNEED   4       /* Not needed now: reclaim the range now. */
+#define MADV_FREE       5       /* Contents no longer needed: reclaim the
+                                   range without writing it out, unless it
+                                   is written to again first. */
+
+#endif /* lib/mman.h */
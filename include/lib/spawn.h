@@ -0,0 +1,21 @@
+#ifndef __LIB_SPAWN_H
+#define __LIB_SPAWN_H
+
+/* A change spawn() makes to the child's file descriptors before the new
+ * program runs, in the order given. */
+struct spawn_action {
+	int op;                     /* One of enum spawn_op. */
+	int fd;                     /* The descriptor. */
+	int newfd;                  /* Target of SPAWN_DUP2. */
+};
+
+enum spawn_op {
+	SPAWN_END,                  /* Ends the list of actions. */
+	SPAWN_DUP2,                 /* dup2(fd, newfd). */
+	SPAWN_CLOSE,                /* close(fd). */
+};
+
+/* Most actions one spawn() takes. */
+#define SPAWN_ACTIONS_MAX 16
+
+#endif /* lib/spawn.h */
@@ -36,6 +36,26 @@ enum {
 
 	SYS_MOUNT,
 	SYS_UMOUNT,
+
+	/* Extensions. */
+	SYS_MEMSTAT,                /* Report the memory usage of a process. */
+	SYS_MADVISE,                /* Advise on the use of a memory range. */
+	SYS_MLOCK,                  /* Lock a memory range in memory. */
+	SYS_MUNLOCK,                /* Unlock a memory range. */
+	SYS_READV,                  /* Read from a file into several buffers. */
+	SYS_WRITEV,                 /* Write several buffers to a file. */
+	SYS_PREAD,                  /* Read from a file at a given offset. */
+	SYS_PWRITE,                 /* Write to a file at a given offset. */
+	SYS_SENDFILE,               /* Copy from a file to a file or the console. */
+	SYS_AIO_SETUP,              /* Register an asynchronous I/O ring. */
+	SYS_AIO_ENTER,              /* Submit and complete asynchronous I/O. */
+	SYS_SPAWN,                  /* Start a new process running a program. */
+	SYS_VFORK,                  /* Clone current process, sharing its memory. */
+	SYS_WAITPID,                /* Wait for a child, or any child, to die. */
+	SYS_SYSSTAT,                /* Report system call counts and latencies. */
+	SYS_PIPE,                   /* Create a pipe. */
+
+	SYS_CNT                     /* Number of system call numbers. */
 };
 
 #endif /* lib/syscall-nr.h */
@@ -0,0 +1,20 @@
+#ifndef __LIB_SYSSTAT_H
+#define __LIB_SYSSTAT_H
+
+#include <stdint.h>
+
+/* Latency buckets.  Bucket I counts calls that took 2**I to 2**(I+1) - 1
+ * TSC cycles, the last one also every slower call. */
+#define SYSSTAT_BUCKETS 32
+
+/* Counters of one system call, as returned by the sysstat() system call
+ * for all processes since boot.  Calls that never return, such as exit()
+ * and a successful exec(), are counted but not timed. */
+struct sysstat {
+	uint64_t calls;                     /* Times it was called. */
+	uint64_t timed;                     /* Of those, times it returned. */
+	uint64_t cycles;                    /* TSC cycles spent in the timed ones. */
+	uint64_t hist[SYSSTAT_BUCKETS];     /* Log2 histogram of their cycles. */
+};
+
+#endif /* lib/sysstat.h */
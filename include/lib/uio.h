@@ -0,0 +1,15 @@
+#ifndef __LIB_UIO_H
+#define __LIB_UIO_H
+
+#include <stddef.h>
+
+/* One buffer of a readv() or writev() request. */
+struct iovec {
+	void *iov_base;             /* Start of the buffer. */
+	size_t iov_len;             /* Its size in bytes. */
+};
+
+/* Most buffers one readv() or writev() takes. */
+#define IOV_MAX 64
+
+#endif /* lib/uio.h */
@@ -4,6 +4,13 @@
 #include <stdbool.h>
 #include <debug.h>
 #include <stddef.h>
+#include <memstat.h>
+#include <sysstat.h>
+#include <mman.h>
+#include <uio.h>
+#include <aio.h>
+#include <spawn.h>
+#include <stdint.h>
 
 /* Process identifier. */
 typedef int pid_t;
@@ -42,6 +49,31 @@ int dup2(int oldfd, int newfd);
 void *mmap (void *addr, size_t length, int writable, int fd, off_t offset);
 void munmap (void *addr);
 
+/* Extensions. */
+bool memstat (struct memstat *);
+int madvise (void *addr, size_t length, int advice);
+int mlock (const void *addr, size_t length);
+int munlock (const void *addr, size_t length);
+int readv (int fd, const struct iovec *iov, int iovcnt);
+int writev (int fd, const struct iovec *iov, int iovcnt);
+int pread (int fd, void *buffer, unsigned length, off_t offset);
+int pwrite (int fd, const void *buffer, unsigned length, off_t offset);
+int sendfile (int out_fd, int in_fd, off_t *offset, unsigned count);
+int aio_setup (struct aio_ring *ring);
+int aio_enter (unsigned to_submit, unsigned min_complete);
+pid_t spawn (const char *file, char *const argv[],
+		const struct spawn_action *actions);
+pid_t vfork (void);
+pid_t waitpid (pid_t pid, int *status);
+int sysstat (struct sysstat *stats, unsigned cnt);
+int pipe (int fds[2]);
+
+/* Read from the vDSO page, without a system call. */
+int64_t vdso_ticks (void);
+uint64_t vdso_tsc_per_tick (void);
+int64_t vdso_time_us (void);
+pid_t vdso_gettid (void);
+
 /* Project 4 only. */
 bool chdir (const char *dir);
 bool mkdir (const char *dir);
@@ -0,0 +1,26 @@
+#ifndef __LIB_VDSO_H
+#define __LIB_VDSO_H
+
+#include <stdint.h>
+
+/* A page of kernel data that every process can read at VDSO_ADDR, but
+ * not write, so that it can look up the time or its own id without a
+ * system call.
+ *
+ * The timer interrupt updates the time fields.  It bumps SEQ before and
+ * after it does, so a reader that sees the same even SEQ before and after
+ * reading them read a consistent set.  TID is that of the process that
+ * runs right now: since there is one CPU, that is always the reader. */
+
+#define VDSO_ADDR 0x47500000
+
+struct vdso_data {
+	volatile uint32_t seq;          /* Odd while the time is updated. */
+	volatile int tid;               /* Thread id of the running process. */
+	volatile int64_t ticks;         /* Timer ticks since boot. */
+	volatile uint64_t tick_tsc;     /* TSC at the last tick. */
+	volatile uint64_t tsc_per_tick; /* TSC cycles per tick, 0 at first. */
+	uint32_t timer_freq;            /* Timer ticks per second. */
+};
+
+#endif /* lib/vdso.h */
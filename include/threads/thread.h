@@ -2,6 +2,7 @@
 #define THREADS_THREAD_H
 
 #include <debug.h>
+#include <hash.h>
 #include <list.h>
 #include <stdint.h>
 #include "threads/interrupt.h"
@@ -29,6 +30,19 @@ typedef int tid_t;
 #define PRI_DEFAULT 31                  /* Default priority. */
 #define PRI_MAX 63                      /* Highest priority. */
 
+/* 부모가 가진 자식 하나의 기록.  자식 스레드가 끝나면 스레드 페이지는 바로
+ * 해제되고, wait 할 때까지 이것만 좀비로 남음 */
+struct child {
+	tid_t tid;                          /* 자식의 tid */
+	int exit_status;                    /* 종료 상태, 자식이 끝날 때 채움 */
+	int ref_cnt;                        /* 부모, 자식 중 아직 놓지 않은 쪽 수 */
+	struct semaphore fork_sema;         /* 자식이 fork/load 를 마치면 up */
+	struct semaphore exit_sema;         /* 자식이 종료하면 up */
+	struct thread *parent;              /* 부모, 부모가 먼저 끝나면 NULL */
+	struct hash_elem elem;              /* 부모의 children 에 담아줄 elem */
+	struct list_elem exit_elem;         /* 부모의 exited_children 에 담아줄 elem */
+};
+
 /* A kernel thread or user process.
  *
  * Each thread structure is stored in its own 4 kB page.  The
@@ -109,30 +123,37 @@ struct thread {
 #ifdef USERPROG
 	/* Owned by userprog/process.c. */
 	uint64_t *pml4;                     /* Page map level 4 */
+	struct aio_ctx *aio;                /* Asynchronous I/O ring, if any. */
+	struct thread *vfork_parent;        /* Lender of the address space. */
+	char *stdout_buf;                   /* Unfinished console line, if any. */
+	size_t stdout_len;                  /* Bytes in stdout_buf. */
 #endif
 #ifdef VM
 	/* Table for whole virtual memory owned by thread. */
 	struct supplemental_page_table spt;
+	struct memstat mem;                 /* Memory usage counters. */
+	void *user_rsp;                     /* User rsp at system call entry. */
 #endif
 
 	/* Owned by thread.c. */
 	struct intr_frame tf;               /* Information for switching */
 	unsigned magic;                     /* Detects stack overflow. */
 
-	struct list child_list;             /* 자식 프로세스를 담아줄 리스트*/ //변경사항
-	struct list_elem child_elem;		/* child_list 에 담아줄 elem */ // 변경사항
+	struct hash children;               /* 자식 기록(struct child), tid 로 찾음 */ //변경사항
+	struct list exited_children;        /* 종료한 자식 기록, 종료한 순서대로 */
+	struct semaphore child_exit_sema;   /* 자식이 종료할 때마다 up */
+	struct child *child_rec;            /* 부모가 가진 나의 기록, 없으면 NULL */
 
-	struct semaphore wait_sema;			/* wait_sema 를 이용하여 자식 프로세스가 종료할때까지 대기함. 종료 상태를 저장 */
 	int exit_status;                    /* system call : exit , wait */ //변경사항
 
 	struct intr_frame parent_if;         /* 유저 스택의 정보를 인터럽트 프레임 안에 넣어서, 커널 스택으로 넘겨주기 위함 */ //변경사항 - 자식에게 넘겨줄 intr_frame
-	struct semaphore fork_sema;          /* 자식 프로세스를 정상적으로 로드하기 위해, 부모 프로세스가 sema_down/up하게 되는 세마포어 */ //fork가 완료될때 까지 부모가 기다리게 하는 forksema
-	struct semaphore free_sema;			 /*자식 프로세스 종료상태를 부모가 받을때까지 종료를 대기하게 하는 free_sema */
 	
 	// 변경사항
 	/* file descriptor 관련 추가 */
 	struct file **fd_table;             /* File Descriptor Table (FD Table) */
-	int fd_idx;                          /* File Descriptor Index (FD Idx) */
+	uint64_t *fd_used;                  /* Bitmap of live fds, after fd_table */
+	int fd_cap;                         /* Slots in fd_table, grows on demand */
+	int fd_cnt;                         /* Live fds */
 
 	/* project 2 extra */
     int stdin_count;
@@ -201,7 +222,19 @@ void mlfqs_increment (void);
 void mlfqs_recalc(void);
 
 /* Project 2 : FD(File Descriptor) 관련 변경 */
-#define FDT_PAGES 3
-#define FDCOUNT_LIMIT FDT_PAGES * (1<<9)
+#define FDCOUNT_LIMIT 1536          /* Most fds a process may have. */
+#define FD_TABLE_MIN 64             /* Initial slots, doubled when full. */
+
+bool fd_table_init (struct thread *, int cap);
+bool fd_table_reserve (struct thread *, int fd);
+void fd_table_destroy (struct thread *);
+void fd_table_set (struct thread *, int fd, struct file *);
+int fd_table_first_free (struct thread *);
+int fd_table_next (struct thread *, int fd);
+
+/* 자식 기록 관련 */
+bool child_table_init (struct thread *);
+void child_release (struct child *);
+void child_disown (tid_t);
 
 #endif /* threads/thread.h */
@@ -0,0 +1,12 @@
+#ifndef USERPROG_AIO_H
+#define USERPROG_AIO_H
+
+#include <aio.h>
+
+void aio_init (void);
+int aio_setup (struct aio_ring *);
+int aio_enter (unsigned to_submit, unsigned min_complete);
+void aio_destroy (void);
+void aio_print_stats (void);
+
+#endif /* userprog/aio.h */
@@ -1,11 +1,22 @@
 #ifndef USERPROG_EXCEPTION_H
 #define USERPROG_EXCEPTION_H
 
+#include <stdint.h>
+
 /* Page fault error code bits that describe the cause of the exception.  */
 #define PF_P 0x1    /* 0: not-present page. 1: access rights violation. */
 #define PF_W 0x2    /* 0: read, 1: write. */
 #define PF_U 0x4    /* 0: kernel, 1: user process. */
 
+/* Entry of the exception fixup table.  A page fault in the kernel at INSN
+ * that the VM cannot resolve resumes at FIXUP instead of killing the
+ * process.  Entries are emitted into section __ex_table next to the
+ * instructions, as two .quad values. */
+struct exception_fixup {
+	uintptr_t insn;
+	uintptr_t fixup;
+};
+
 void exception_init (void);
 void exception_print_stats (void);
 
@@ -3,14 +3,24 @@
 
 #include "threads/thread.h"
 
+/* Most bytes the arguments of a new process take on its stack. */
+#define ARG_MAX (128 * 1024)
+
 tid_t process_create_initd (const char *file_name);
 tid_t process_fork (const char *name, struct intr_frame *if_);
+struct spawn_action;
+tid_t process_spawn (char *args, size_t size, int argc,
+		const struct spawn_action *, int cnt);
+tid_t process_vfork (struct intr_frame *if_);
 int process_exec (void *f_name);
 int process_wait (tid_t);
+tid_t process_waitpid (tid_t, int *status);
 void process_exit (void);
 void process_activate (struct thread *next);
+void process_image_init (void);
+void process_print_stats (void);
 
 /* get child */
-struct thread * get_child(int pid);
+struct child * get_child(int pid);
 
 #endif /* userprog/process.h */
@@ -4,7 +4,23 @@
 #include "threads/synch.h"
 
 void syscall_init (void);
+void syscall_print_stats (void);
 
 struct lock filesys_lock;
 
+void exit (int status);
+void close (int fd);
+int dup2 (int oldfd, int newfd);
+
+/* File descriptor table of the current process. */
+struct file;
+struct file *process_get_file (int fd);
+int process_add_file (struct file *);
+struct file *process_detach_file (int fd);
+void process_close_all_files (void);
+
+/* Line-buffered console output of the current process. */
+void stdout_flush (void);
+void stdout_release (void);
+
 #endif /* userprog/syscall.h */
@@ -0,0 +1,20 @@
+#ifndef USERPROG_UACCESS_H
+#define USERPROG_UACCESS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Copying between kernel buffers and the user address space of the
+ * current process.  User ranges are checked a page at a time and a bad
+ * user address makes the copy fail instead of killing the kernel. */
+bool copy_from_user (void *dst, const void *usrc, size_t size);
+bool copy_to_user (void *udst, const void *src, size_t size);
+int strncpy_from_user (char *dst, const char *usrc, size_t size);
+
+/* Direct access to the frame behind a user page. */
+void *user_pin_page (void *uaddr, bool write);
+void user_unpin_page (void *uaddr, size_t size, bool written);
+
+void uaccess_print_stats (void);
+
+#endif /* userprog/uaccess.h */
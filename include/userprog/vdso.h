@@ -0,0 +1,16 @@
+#ifndef USERPROG_VDSO_H
+#define USERPROG_VDSO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <vdso.h>
+
+struct thread;
+
+void vdso_init (void);
+void vdso_tick (int64_t ticks);
+void vdso_activate (struct thread *);
+bool vdso_map (uint64_t *pml4);
+void vdso_unmap (uint64_t *pml4);
+
+#endif /* userprog/vdso.h */
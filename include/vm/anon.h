@@ -1,10 +1,33 @@
 #ifndef VM_ANON_H
 #define VM_ANON_H
 #include "vm/vm.h"
+#include "vm/zswap.h"
+#include "vm/ksm.h"
+#include <hash.h>
 struct page;
 enum vm_type;
 
+/* Where the contents of an anonymous page live while it has no frame. */
+enum anon_swap_state {
+	ANON_RESIDENT,              /* In its frame, or never swapped out. */
+	ANON_SWAP_ZERO,             /* All zeroes, nothing stored. */
+	ANON_SWAP_POOL,             /* In the compressed pool. */
+	ANON_SWAP_DISK,             /* In a swap disk slot. */
+	ANON_KSM                    /* Mapped read-only to a shared frame. */
+};
+
 struct anon_page {
+	enum anon_swap_state state;
+	union {
+		size_t swap_slot;           /* ANON_SWAP_DISK: slot on swap_disk. */
+		zswap_handle_t handle;      /* ANON_SWAP_POOL: compressed copy. */
+		struct ksm_node *ksm;       /* ANON_KSM: the shared frame. */
+	};
+
+	/* Same-page merging. */
+	uint64_t ksm_sum;               /* Checksum at the last scan. */
+	struct hash_elem ksm_elem;      /* Element of the unstable table. */
+	bool ksm_cand;                  /* In the unstable table? */
 };
 
 void vm_anon_init (void);
@@ -4,13 +4,32 @@
 #include "vm/vm.h"
 
 struct page;
+struct frame_share;
 enum vm_type;
 
 struct file_page {
+	struct file *file;             /* File of the owning vm_area. */
+	off_t ofs;                     /* Offset of the page in FILE. */
+	size_t read_bytes;             /* Bytes backed by FILE... */
+	size_t zero_bytes;             /* ...then bytes of zeroes. */
+	struct frame_share *share;     /* Shared frame it maps, if read-only. */
+	struct list_elem share_elem;   /* Element of the frame's mappers. */
+};
+
+/* Where the contents of a lazily loaded page come from: READ_BYTES bytes of
+ * FILE starting at OFS, followed by ZERO_BYTES zero bytes.  Used as the aux
+ * of every uninit page that has an initializer. */
+struct lazy_load_info {
+	struct file *file;
+	off_t ofs;
+	size_t read_bytes;
+	size_t zero_bytes;
 };
 
 void vm_file_init (void);
 bool file_backed_initializer (struct page *page, enum vm_type type, void *kva);
+bool file_lazy_load (struct page *page, void *aux);
+void file_backed_adopt (struct page *page);
 void *do_mmap(void *addr, size_t length, int writable,
 		struct file *file, off_t offset);
 void do_munmap (void *va);
@@ -0,0 +1,23 @@
+#ifndef VM_KSM_H
+#define VM_KSM_H
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Kernel same-page merging.  An optional kernel thread hashes the contents
+ * of resident anonymous pages and maps pages with identical contents
+ * read-only to one shared frame.  A write to a merged page gives it back a
+ * private copy. */
+
+struct page;
+struct ksm_node;
+
+/* Anonymous pages scanned per second, 0 (the default) to disable.
+ * Controlled by kernel command-line option "-ksm=PAGES". */
+extern size_t ksm_scan_rate;
+
+void ksm_init (void);
+bool ksm_unmerge (struct page *page, void *kva);
+void ksm_forget (struct page *page);
+void ksm_print_stats (void);
+
+#endif /* vm/ksm.h */
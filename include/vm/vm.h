@@ -1,7 +1,13 @@
 #ifndef VM_VM_H
 #define VM_VM_H
 #include <stdbool.h>
+#include <stdint.h>
+#include <hash.h>
+#include <list.h>
+#include <memstat.h>
+#include <mman.h>
 #include "threads/palloc.h"
+#include "devices/disk.h"
 
 enum vm_type {
 	/* page not initialized */
@@ -24,6 +30,9 @@ enum vm_type {
 	VM_MARKER_END = (1 << 31),
 };
 
+/* Marks the anonymous pages that make up the user stack. */
+#define VM_STACK VM_MARKER_0
+
 #include "vm/uninit.h"
 #include "vm/anon.h"
 #include "vm/file.h"
@@ -46,6 +55,15 @@ struct page {
 	struct frame *frame;   /* Back reference for frame */
 
 	/* Your implementation */
+	struct hash_elem spt_elem;     /* Element of supplemental_page_table. */
+	struct thread *owner;          /* Process whose spt holds this page. */
+	bool writable;                 /* Mapped writable into user space? */
+	bool zero_mapped;              /* Mapped read-only to the zero frame? */
+	uint8_t ws_history;            /* Bit N: accessed N samples ago. */
+	bool ws_ref;                   /* Accessed bit taken by the sampler. */
+	uint8_t advice;                /* MADV_* given by madvise(). */
+	bool locked;                   /* Locked in memory by mlock()? */
+	bool prefetched;               /* Prefetched, not accessed since? */
 
 	/* Per-type data are binded into the union.
 	 * Each function automatically detects the current union */
@@ -63,6 +81,9 @@ struct page {
 struct frame {
 	void *kva;
 	struct page *page;
+	struct list_elem frame_elem;   /* Element of the frame table. */
+	bool pinned;                   /* Never chosen as an eviction victim. */
+	struct frame_share *share;     /* Page-index entry if shared, or null. */
 };
 
 /* The function table for page operations.
@@ -85,6 +106,26 @@ struct page_operations {
  * We don't want to force you to obey any specific design for this struct.
  * All designs up to you for this. */
 struct supplemental_page_table {
+	struct hash pages;             /* struct page, keyed by va. */
+	struct list areas;             /* struct vm_area, file-backed ranges. */
+	void *stack_bottom;            /* Lowest page of the stack. */
+};
+
+/* A run of pages whose contents come from one file: a loadable segment of
+ * the executable or an mmap()ed region.  The fault handler watches the
+ * faults inside an area to decide how far to read ahead. */
+struct vm_area {
+	struct list_elem elem;         /* Element of supplemental_page_table. */
+	void *start;                   /* First page. */
+	void *end;                     /* One past the last page. */
+	struct file *file;             /* Backing file. */
+	bool mmapped;                  /* Created by mmap(), freed by munmap(). */
+	void *next_fault;              /* Next page of a sequential scan. */
+	size_t ra_pages;               /* Current readahead window, in pages. */
+	int advice;                    /* MADV_* given by madvise(). */
+	void *last_fault;              /* Page of the last fault, or predicted. */
+	intptr_t stride;               /* Bytes from the fault before it. */
+	int stride_cnt;                /* Faults in a row that were STRIDE apart. */
 };
 
 #include "threads/thread.h"
@@ -92,11 +133,22 @@ void supplemental_page_table_init (struct supplemental_page_table *spt);
 bool supplemental_page_table_copy (struct supplemental_page_table *dst,
 		struct supplemental_page_table *src);
 void supplemental_page_table_kill (struct supplemental_page_table *spt);
+void supplemental_page_table_move (struct thread *to, struct thread *from);
 struct page *spt_find_page (struct supplemental_page_table *spt,
 		void *va);
 bool spt_insert_page (struct supplemental_page_table *spt, struct page *page);
 void spt_remove_page (struct supplemental_page_table *spt, struct page *page);
 
+/* Ticks between two working-set samples, 0 (the default) to disable.
+ * Controlled by kernel command-line option "-wss=TICKS". */
+extern int64_t vm_ws_sample_ticks;
+/* Maximum size of a user stack in bytes, 1 MB by default.
+ * Controlled by kernel command-line option "-stack=KB". */
+extern size_t vm_stack_limit;
+/* Print each process's memory usage when it exits?
+ * Controlled by kernel command-line option "-memstat". */
+extern bool vm_usage_dump;
+
 void vm_init (void);
 bool vm_try_handle_fault (struct intr_frame *f, void *addr, bool user,
 		bool write, bool not_present);
@@ -107,6 +159,28 @@ bool vm_alloc_page_with_initializer (enum vm_type type, void *upage,
 		bool writable, vm_initializer *init, void *aux);
 void vm_dealloc_page (struct page *page);
 bool vm_claim_page (void *va);
+bool vm_stack_grow_for (void *addr);
+bool vm_madvise (void *addr, size_t length, int advice);
+bool vm_mlock (void *addr, size_t length, bool lock);
 enum vm_type page_get_type (struct page *page);
 
+bool vm_pin_page (struct page *page);
+void vm_unpin_page (struct page *page);
+void vm_free_frame (struct page *page);
+void vm_zero_unmap (struct page *page);
+bool vm_pin_resident (struct page *page);
+void vm_share_unmap (struct page *page);
+void vm_share_retain (disk_sector_t inumber);
+void vm_share_release (disk_sector_t inumber);
+size_t vm_scan_anon (size_t cnt, void (*scan) (struct page *));
+void *vm_frame_steal (struct page *page);
+
+struct vm_area *vm_area_create (void *start, void *end, struct file *file,
+		bool mmapped);
+struct vm_area *vm_area_find (void *va);
+void vm_area_destroy (struct vm_area *area);
+void vm_print_stats (void);
+void vm_account_swap_free (struct page *page);
+void vm_print_usage (struct thread *t);
+
 #endif  /* VM_VM_H */
@@ -0,0 +1,36 @@
+#ifndef VM_ZSWAP_H
+#define VM_ZSWAP_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Compressed in-memory swap tier that sits in front of the swap disk.
+ * Anonymous pages are LZ-compressed into a pool of kernel pages, two per
+ * pool page (zbud), and only go to disk once the pool is full or the page
+ * does not compress. */
+
+/* Identifies one compressed page in the pool. */
+typedef uintptr_t zswap_handle_t;
+
+/* Maximum number of kernel pages in the compressed pool.
+ * Controlled by kernel command-line option "-zswap=PAGES". */
+extern size_t zswap_pool_limit;
+
+void zswap_init (void);
+bool zswap_store (const void *kva, zswap_handle_t *handle);
+bool zswap_load (zswap_handle_t handle, void *kva);
+void zswap_free (zswap_handle_t handle);
+
+/* Where a swapped-in page was found, for per-tier statistics. */
+enum zswap_tier {
+	ZSWAP_TIER_ZERO,            /* Deduplicated all-zero page. */
+	ZSWAP_TIER_POOL,            /* Compressed pool. */
+	ZSWAP_TIER_DISK,            /* Swap disk. */
+	ZSWAP_TIER_CNT
+};
+
+void zswap_count_out (enum zswap_tier);
+void zswap_count_in (enum zswap_tier, uint64_t cycles);
+void zswap_print_stats (void);
+
+#endif /* vm/zswap.h */
@@ -54,7 +54,7 @@ static __inline int64_t syscall (uint64_t num_, uint64_t a1_, uint64_t a2_,
 			((uint64_t) ARG2), 0, 0, 0))
 
 #define syscall4(NUMBER, ARG0, ARG1, ARG2, ARG3) ( \
-		syscall(((uint64_t *) NUMBER), \
+		syscall(((uint64_t) NUMBER), \
 			((uint64_t) ARG0), \
 			((uint64_t) ARG1), \
 			((uint64_t) ARG2), \
@@ -155,6 +155,99 @@ munmap (void *addr) {
 	syscall1 (SYS_MUNMAP, addr);
 }
 
+bool
+memstat (struct memstat *stat) {
+	return syscall1 (SYS_MEMSTAT, stat);
+}
+
+int
+madvise (void *addr, size_t length, int advice) {
+	return syscall3 (SYS_MADVISE, addr, length, advice);
+}
+
+int
+mlock (const void *addr, size_t length) {
+	return syscall2 (SYS_MLOCK, addr, length);
+}
+
+int
+munlock (const void *addr, size_t length) {
+	return syscall2 (SYS_MUNLOCK, addr, length);
+}
+
+int
+readv (int fd, const struct iovec *iov, int iovcnt) {
+	return syscall3 (SYS_READV, fd, iov, iovcnt);
+}
+
+int
+writev (int fd, const struct iovec *iov, int iovcnt) {
+	return syscall3 (SYS_WRITEV, fd, iov, iovcnt);
+}
+
+int
+pread (int fd, void *buffer, unsigned size, off_t offset) {
+	return syscall4 (SYS_PREAD, fd, buffer, size, offset);
+}
+
+int
+pwrite (int fd, const void *buffer, unsigned size, off_t offset) {
+	return syscall4 (SYS_PWRITE, fd, buffer, size, offset);
+}
+
+int
+sendfile (int out_fd, int in_fd, off_t *offset, unsigned count) {
+	return syscall4 (SYS_SENDFILE, out_fd, in_fd, offset, count);
+}
+
+int
+aio_setup (struct aio_ring *ring) {
+	return syscall1 (SYS_AIO_SETUP, ring);
+}
+
+int
+aio_enter (unsigned to_submit, unsigned min_complete) {
+	return syscall2 (SYS_AIO_ENTER, to_submit, min_complete);
+}
+
+pid_t
+spawn (const char *file, char *const argv[],
+		const struct spawn_action *actions) {
+	return (pid_t) syscall3 (SYS_SPAWN, file, argv, actions);
+}
+
+pid_t
+waitpid (pid_t pid, int *status) {
+	return (pid_t) syscall2 (SYS_WAITPID, pid, status);
+}
+
+int
+sysstat (struct sysstat *stats, unsigned cnt) {
+	return syscall2 (SYS_SYSSTAT, stats, cnt);
+}
+
+int
+pipe (int fds[2]) {
+	return syscall1 (SYS_PIPE, fds);
+}
+
+/* The child of vfork() returns from it and calls other functions on the
+ * parent's stack, overwriting the return address the parent later returns
+ * through.  So vfork() is written in assembly and keeps its return
+ * address in RDX, which the kernel preserves for both processes, while it
+ * is in the kernel. */
+__attribute__((used)) static const uint64_t vfork_nr = SYS_VFORK;
+asm (".text\n"
+		".globl vfork\n"
+		".type vfork, @function\n"
+		"vfork:\n"
+		"	popq %rdx\n"
+		"	movq vfork_nr(%rip), %rax\n"
+		"	syscall\n"
+		"	pushq %rdx\n"
+		"	ret\n"
+		".size vfork, .-vfork\n");
+
 bool
 chdir (const char *dir) {
 	return syscall1 (SYS_CHDIR, dir);
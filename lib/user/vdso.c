@@ -0,0 +1,61 @@
+#include <syscall.h>
+#include <vdso.h>
+
+/* The kernel's read-only page, see lib/vdso.h. */
+static const struct vdso_data *const vdso =
+	(const struct vdso_data *) VDSO_ADDR;
+
+static inline uint64_t
+rdtsc (void) {
+	uint32_t lo, hi;
+
+	asm volatile ("rdtsc" : "=a" (lo), "=d" (hi));
+	return ((uint64_t) hi << 32) | lo;
+}
+
+/* Returns the number of timer ticks since the OS booted. */
+int64_t
+vdso_ticks (void) {
+	return vdso->ticks;
+}
+
+/* Returns the number of TSC cycles per timer tick, or 0 if the kernel has
+ * not measured it yet. */
+uint64_t
+vdso_tsc_per_tick (void) {
+	return vdso->tsc_per_tick;
+}
+
+/* Returns the number of microseconds since the OS booted, finer than a
+ * tick where the TSC rate is known. */
+int64_t
+vdso_time_us (void) {
+	uint32_t seq;
+	int64_t ticks;
+	uint64_t tick_tsc, tsc_per_tick, tsc;
+	int64_t us;
+
+	do {
+		seq = vdso->seq;
+		ticks = vdso->ticks;
+		tick_tsc = vdso->tick_tsc;
+		tsc_per_tick = vdso->tsc_per_tick;
+		tsc = rdtsc ();
+	} while ((seq & 1) != 0 || seq != vdso->seq);
+
+	us = ticks * 1000000 / vdso->timer_freq;
+	if (tsc_per_tick != 0) {
+		uint64_t cycles = tsc - tick_tsc;
+
+		if (cycles > tsc_per_tick)
+			cycles = tsc_per_tick;
+		us += cycles * (1000000 / vdso->timer_freq) / tsc_per_tick;
+	}
+	return us;
+}
+
+/* Returns the thread id of the calling process. */
+pid_t
+vdso_gettid (void) {
+	return vdso->tid;
+}
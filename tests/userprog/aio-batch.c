@@ -0,0 +1,68 @@
+/* Queues eight writes to different parts of a file and submits
+   them with a single aio_enter(), then reads the parts back the
+   same way.  Every operation must complete with its user data and
+   the full length, and the data must round-trip. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/userprog/aio-ring.h"
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define OP_CNT 8
+#define CHUNK 1024
+
+static char out[OP_CNT][CHUNK];
+static char in[OP_CNT][CHUNK];
+
+/* Reaps OP_CNT completions and checks that each has a distinct
+   user data below OP_CNT and the result CHUNK. */
+static void
+reap_all (const char *what)
+{
+  bool seen[OP_CNT];
+  struct aio_cqe cqe;
+  int i;
+
+  memset (seen, 0, sizeof seen);
+  for (i = 0; i < OP_CNT; i++)
+    {
+      if (!ring_reap (&cqe))
+        fail ("%s: only %d completions", what, i);
+      if (cqe.user_data >= OP_CNT || seen[cqe.user_data])
+        fail ("%s: bad user data %lld", what, (long long) cqe.user_data);
+      if (cqe.res != CHUNK)
+        fail ("%s: operation %lld returned %d", what,
+              (long long) cqe.user_data, cqe.res);
+      seen[cqe.user_data] = true;
+    }
+  if (ring_reap (&cqe))
+    fail ("%s: extra completion", what);
+}
+
+void
+test_main (void)
+{
+  int fd;
+  int i;
+
+  CHECK (create ("batch", OP_CNT * CHUNK), "create \"batch\"");
+  CHECK ((fd = open ("batch")) > 1, "open \"batch\"");
+  ring_setup ();
+
+  for (i = 0; i < OP_CNT; i++)
+    {
+      memset (out[i], 'a' + i, CHUNK);
+      ring_queue (AIO_WRITE, fd, out[i], CHUNK, i * CHUNK, i);
+    }
+  CHECK (aio_enter (OP_CNT, OP_CNT) == OP_CNT, "submit %d writes", OP_CNT);
+  reap_all ("write");
+
+  for (i = 0; i < OP_CNT; i++)
+    ring_queue (AIO_READ, fd, in[i], CHUNK, i * CHUNK, i);
+  CHECK (aio_enter (OP_CNT, OP_CNT) == OP_CNT, "submit %d reads", OP_CNT);
+  reap_all ("read");
+
+  CHECK (!memcmp (in, out, sizeof in), "compare read data against written data");
+  close (fd);
+}
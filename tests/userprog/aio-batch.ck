@@ -0,0 +1,15 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(aio-batch) begin
+(aio-batch) create "batch"
+(aio-batch) open "batch"
+(aio-batch) submit 8 writes
+(aio-batch) submit 8 reads
+(aio-batch) compare read data against written data
+(aio-batch) end
+aio-batch: exit(0)
+EOF
+pass;
@@ -0,0 +1,65 @@
+/* Benchmark: reads a 256 kB file 1 kB at a time, once with a loop
+   of read() calls and once through the asynchronous I/O ring in
+   batches of AIO_SQ_ENTRIES, checks that both read the same data,
+   and reports the time each took. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/userprog/aio-ring.h"
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define CHUNK 1024
+#define SIZE (256 * 1024)
+
+static char data[SIZE];
+static char loop_buf[SIZE];
+static char ring_buf[SIZE];
+
+void
+test_main (void)
+{
+  int64_t start, loop_us, ring_us;
+  struct aio_cqe cqe;
+  int ofs, done;
+  int fd;
+
+  for (ofs = 0; ofs < SIZE; ofs++)
+    data[ofs] = ofs * 7 % 251;
+  CHECK (create ("bench", SIZE), "create \"bench\"");
+  CHECK ((fd = open ("bench")) > 1, "open \"bench\"");
+  CHECK (write (fd, data, SIZE) == SIZE, "write \"bench\"");
+  ring_setup ();
+
+  seek (fd, 0);
+  start = vdso_time_us ();
+  for (ofs = 0; ofs < SIZE; ofs += CHUNK)
+    if (read (fd, loop_buf + ofs, CHUNK) != CHUNK)
+      fail ("read at %d failed", ofs);
+  loop_us = vdso_time_us () - start;
+
+  start = vdso_time_us ();
+  for (ofs = done = 0; done < SIZE / CHUNK; )
+    {
+      while (ofs < SIZE && ring.sq_tail - ring.sq_head < AIO_SQ_ENTRIES)
+        {
+          ring_queue (AIO_READ, fd, ring_buf + ofs, CHUNK, ofs, ofs);
+          ofs += CHUNK;
+        }
+      aio_enter (AIO_SQ_ENTRIES, 1);
+      while (ring_reap (&cqe))
+        {
+          if (cqe.res != CHUNK)
+            fail ("AIO_READ at %lld returned %d", (long long) cqe.user_data,
+                  cqe.res);
+          done++;
+        }
+    }
+  ring_us = vdso_time_us () - start;
+
+  CHECK (!memcmp (loop_buf, data, SIZE), "read() loop data matches");
+  CHECK (!memcmp (ring_buf, data, SIZE), "aio ring data matches");
+  msg ("read() loop: %lld us", (long long) loop_us);
+  msg ("aio ring: %lld us", (long long) ring_us);
+  close (fd);
+}
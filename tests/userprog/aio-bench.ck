@@ -0,0 +1,24 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+
+our ($test);
+my (@output) = read_text_file ("$test.output");
+common_checks ("run", @output);
+
+fail "missing timing lines\n"
+  unless grep (/^\(aio-bench\) read\(\) loop: \d+ us$/, @output)
+    && grep (/^\(aio-bench\) aio ring: \d+ us$/, @output);
+@output = grep (!/^\(aio-bench\) (read\(\) loop|aio ring): \d+ us$/, @output);
+compare_output ("run", \@output, [<<'EOF']);
+(aio-bench) begin
+(aio-bench) create "bench"
+(aio-bench) open "bench"
+(aio-bench) write "bench"
+(aio-bench) read() loop data matches
+(aio-bench) aio ring data matches
+(aio-bench) end
+aio-bench: exit(0)
+EOF
+pass;
@@ -0,0 +1,51 @@
+/* A child queues large writes and exits without waiting for them.
+   The kernel must let the writes finish before it tears down the
+   child's ring, so the parent must find all of the data in the
+   file once the child is gone. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/userprog/aio-ring.h"
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define OP_CNT 8
+#define CHUNK (32 * 1024)
+
+static char buf[OP_CNT][CHUNK];
+
+void
+test_main (void)
+{
+  pid_t pid;
+  int status;
+  int fd;
+  int i;
+
+  CHECK (create ("inflight", OP_CNT * CHUNK), "create \"inflight\"");
+  for (i = 0; i < OP_CNT; i++)
+    memset (buf[i], 'a' + i, CHUNK);
+
+  if ((pid = fork ("child")) == 0)
+    {
+      if ((fd = open ("inflight")) < 2)
+        fail ("child: open failed");
+      ring_setup ();
+      for (i = 0; i < OP_CNT; i++)
+        ring_queue (AIO_WRITE, fd, buf[i], CHUNK, i * CHUNK, i);
+      if (aio_enter (OP_CNT, 0) != OP_CNT)
+        fail ("child: aio_enter failed");
+      exit (23);
+    }
+  status = wait (pid);
+  CHECK (status == 23, "wait for child");
+
+  memset (buf, 0, sizeof buf);
+  CHECK ((fd = open ("inflight")) > 1, "open \"inflight\"");
+  CHECK (read (fd, buf, sizeof buf) == sizeof buf, "read \"inflight\"");
+  for (i = 0; i < OP_CNT * CHUNK; i++)
+    if (buf[i / CHUNK][i % CHUNK] != 'a' + i / CHUNK)
+      fail ("byte %d is %d", i, buf[i / CHUNK][i % CHUNK]);
+  msg ("all writes reached the file");
+  close (fd);
+}
@@ -0,0 +1,16 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(aio-exit) begin
+(aio-exit) create "inflight"
+child: exit(23)
+(aio-exit) wait for child
+(aio-exit) open "inflight"
+(aio-exit) read "inflight"
+(aio-exit) all writes reached the file
+(aio-exit) end
+aio-exit: exit(0)
+EOF
+pass;
@@ -0,0 +1,44 @@
+/* Opens a file with AIO_OPEN and closes it with AIO_CLOSE.  The
+   descriptor the completion returns must work with read(), and
+   must be gone once AIO_CLOSE completes.  Opening a missing file
+   and closing a bad descriptor must complete with -1. */
+
+#include <syscall.h>
+#include "tests/userprog/aio-ring.h"
+#include "tests/userprog/sample.inc"
+#include "tests/lib.h"
+#include "tests/main.h"
+
+/* Submits the queued operation, waits for it and returns its
+   result. */
+static int
+run_one (void)
+{
+  struct aio_cqe cqe;
+
+  if (aio_enter (1, 1) != 1 || !ring_reap (&cqe))
+    fail ("operation did not complete");
+  return cqe.res;
+}
+
+void
+test_main (void)
+{
+  char buf[16];
+  int fd;
+
+  ring_setup ();
+
+  ring_queue (AIO_OPEN, 0, "sample.txt", 0, 0, 0);
+  CHECK ((fd = run_one ()) > 1, "AIO_OPEN \"sample.txt\"");
+  check_file_handle (fd, "sample.txt", sample, sizeof sample - 1);
+
+  ring_queue (AIO_CLOSE, fd, NULL, 0, 0, 0);
+  CHECK (run_one () == 0, "AIO_CLOSE");
+  CHECK (read (fd, buf, sizeof buf) == -1, "read from closed descriptor");
+
+  ring_queue (AIO_OPEN, 0, "no-such-file", 0, 0, 0);
+  CHECK (run_one () == -1, "AIO_OPEN \"no-such-file\"");
+  ring_queue (AIO_CLOSE, fd, NULL, 0, 0, 0);
+  CHECK (run_one () == -1, "AIO_CLOSE closed descriptor");
+}
@@ -0,0 +1,16 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(aio-open-close) begin
+(aio-open-close) AIO_OPEN "sample.txt"
+(aio-open-close) verified contents of "sample.txt"
+(aio-open-close) AIO_CLOSE
+(aio-open-close) read from closed descriptor
+(aio-open-close) AIO_OPEN "no-such-file"
+(aio-open-close) AIO_CLOSE closed descriptor
+(aio-open-close) end
+aio-open-close: exit(0)
+EOF
+pass;
@@ -0,0 +1,46 @@
+/* Helpers for the tests of the asynchronous I/O ring. */
+
+#include "tests/userprog/aio-ring.h"
+#include <syscall.h>
+#include "tests/lib.h"
+
+/* The ring shared with the kernel. */
+struct aio_ring ring;
+
+/* Registers RING with the kernel. */
+void
+ring_setup (void)
+{
+  if (aio_setup (&ring) != 0)
+    fail ("aio_setup failed");
+}
+
+/* Queues an operation in the next submission slot of RING. */
+void
+ring_queue (uint8_t opcode, int fd, void *buf, unsigned len,
+            int32_t offset, uint64_t user_data)
+{
+  struct aio_sqe *sqe = &ring.sq[ring.sq_tail % AIO_SQ_ENTRIES];
+
+  if (ring.sq_tail - ring.sq_head >= AIO_SQ_ENTRIES)
+    fail ("submission queue full");
+  sqe->user_data = user_data;
+  sqe->buf = buf;
+  sqe->fd = fd;
+  sqe->len = len;
+  sqe->offset = offset;
+  sqe->opcode = opcode;
+  ring.sq_tail++;
+}
+
+/* Takes the next completion out of RING into *CQE.  Returns false
+   if there is none. */
+bool
+ring_reap (struct aio_cqe *cqe)
+{
+  if (ring.cq_head == ring.cq_tail)
+    return false;
+  *cqe = ring.cq[ring.cq_head % AIO_CQ_ENTRIES];
+  ring.cq_head++;
+  return true;
+}
@@ -0,0 +1,15 @@
+#ifndef TESTS_USERPROG_AIO_RING_H
+#define TESTS_USERPROG_AIO_RING_H
+
+#include <aio.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+extern struct aio_ring ring;
+
+void ring_setup (void);
+void ring_queue (uint8_t opcode, int fd, void *buf, unsigned len,
+                 int32_t offset, uint64_t user_data);
+bool ring_reap (struct aio_cqe *);
+
+#endif /* tests/userprog/aio-ring.h */
@@ -0,0 +1,72 @@
+/* Runs more operations through the ring than either queue has
+   slots, so that both wrap around.  Completions that find the
+   completion queue full must wait in the kernel, not overwrite
+   completions that were not reaped yet, and come out in order
+   once there is room. */
+
+#include <syscall.h>
+#include "tests/userprog/aio-ring.h"
+#include "tests/lib.h"
+#include "tests/main.h"
+
+/* Queues and submits AIO_SQ_ENTRIES no-ops numbered from *NEXT. */
+static void
+submit_nops (uint64_t *next)
+{
+  int i;
+
+  for (i = 0; i < AIO_SQ_ENTRIES; i++)
+    ring_queue (AIO_NOP, 0, NULL, 0, 0, (*next)++);
+  if (aio_enter (AIO_SQ_ENTRIES, 0) != AIO_SQ_ENTRIES)
+    fail ("aio_enter did not take %d operations", AIO_SQ_ENTRIES);
+}
+
+/* Reaps CNT completions, which must be numbered from *EXPECT. */
+static void
+reap_nops (int cnt, uint64_t *expect)
+{
+  struct aio_cqe cqe;
+  int i;
+
+  for (i = 0; i < cnt; i++)
+    {
+      if (!ring_reap (&cqe))
+        fail ("missing completion %lld", (long long) *expect);
+      if (cqe.user_data != *expect || cqe.res != 0)
+        fail ("completion %lld came as %lld with %d", (long long) *expect,
+              (long long) cqe.user_data, cqe.res);
+      (*expect)++;
+    }
+}
+
+void
+test_main (void)
+{
+  uint64_t next = 0, expect = 0;
+  struct aio_cqe cqe;
+  int i;
+
+  ring_setup ();
+
+  /* Fill the completion queue without reaping, then submit more. */
+  for (i = 0; i < AIO_CQ_ENTRIES / AIO_SQ_ENTRIES + 1; i++)
+    submit_nops (&next);
+  CHECK (ring.cq_tail - ring.cq_head == AIO_CQ_ENTRIES,
+         "completion queue full");
+  reap_nops (AIO_CQ_ENTRIES, &expect);
+  CHECK (!ring_reap (&cqe), "nothing more until the next aio_enter");
+
+  /* The held-back completions come out at the next aio_enter(). */
+  aio_enter (0, 0);
+  reap_nops (AIO_SQ_ENTRIES, &expect);
+  msg ("held-back completions arrived in order");
+
+  /* Keep going around the ring a few times. */
+  for (i = 0; i < 8; i++)
+    {
+      submit_nops (&next);
+      reap_nops (AIO_SQ_ENTRIES, &expect);
+    }
+  CHECK (expect == next, "%lld operations completed in order",
+         (long long) next);
+}
@@ -0,0 +1,14 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(aio-wrap) begin
+(aio-wrap) completion queue full
+(aio-wrap) nothing more until the next aio_enter
+(aio-wrap) held-back completions arrived in order
+(aio-wrap) 352 operations completed in order
+(aio-wrap) end
+aio-wrap: exit(0)
+EOF
+pass;
@@ -0,0 +1,34 @@
+/* Passes child-bigargs more than a page of arguments, through
+   spawn() and through exec(). */
+
+#include <syscall.h>
+#include "tests/userprog/bigargs.h"
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define ARG_CNT 64
+#define ARG_LEN 100
+
+void
+test_main (void)
+{
+  char *argv[ARG_CNT + 3];
+  int argc, status;
+  pid_t pid;
+
+  argc = bigargs_vec (argv, ARG_CNT, ARG_LEN);
+  pid = spawn ("child-bigargs", argv, NULL);
+  status = wait (pid);
+  CHECK (status == argc, "spawn with %d arguments of %d bytes",
+         ARG_CNT, ARG_LEN);
+
+  pid = fork ("child-bigargs");
+  if (pid == 0)
+    {
+      exec (bigargs_cmd_line (ARG_CNT, ARG_LEN));
+      exit (-2);
+    }
+  status = wait (pid);
+  CHECK (status == argc, "exec with %d arguments of %d bytes",
+         ARG_CNT, ARG_LEN);
+}
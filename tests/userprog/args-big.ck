@@ -0,0 +1,14 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(args-big) begin
+child-bigargs: exit(66)
+(args-big) spawn with 64 arguments of 100 bytes
+child-bigargs: exit(66)
+(args-big) exec with 64 arguments of 100 bytes
+(args-big) end
+args-big: exit(0)
+EOF
+pass;
@@ -0,0 +1,38 @@
+/* Passes child-bigargs arguments just under ARG_MAX (128 kB),
+   which must work, and just over it, which must fail: spawn()
+   returns -1 and exec() terminates the process with -1. */
+
+#include <syscall.h>
+#include "tests/userprog/bigargs.h"
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define ARG_LEN 4000
+#define UNDER_CNT 30
+#define OVER_CNT 33
+
+void
+test_main (void)
+{
+  char *argv[OVER_CNT + 3];
+  int argc, status;
+  pid_t pid;
+
+  argc = bigargs_vec (argv, UNDER_CNT, ARG_LEN);
+  pid = spawn ("child-bigargs", argv, NULL);
+  status = wait (pid);
+  CHECK (status == argc, "spawn with 120 kB of arguments");
+
+  bigargs_vec (argv, OVER_CNT, ARG_LEN);
+  CHECK (spawn ("child-bigargs", argv, NULL) == -1,
+         "spawn with 132 kB of arguments fails");
+
+  pid = fork ("child");
+  if (pid == 0)
+    {
+      exec (bigargs_cmd_line (OVER_CNT, ARG_LEN));
+      exit (-2);
+    }
+  status = wait (pid);
+  CHECK (status == -1, "exec with 132 kB of arguments fails");
+}
@@ -0,0 +1,15 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(args-max) begin
+child-bigargs: exit(32)
+(args-max) spawn with 120 kB of arguments
+(args-max) spawn with 132 kB of arguments fails
+child: exit(-1)
+(args-max) exec with 132 kB of arguments fails
+(args-max) end
+args-max: exit(0)
+EOF
+pass;
@@ -0,0 +1,59 @@
+/* Builds large argument vectors for child-bigargs, in the form
+   it checks: "child-bigargs", a length L, then arguments of L
+   copies of one letter each. */
+
+#include "tests/userprog/bigargs.h"
+#include <stdio.h>
+#include <string.h>
+#include "tests/lib.h"
+
+#define MAX_BYTES (136 * 1024)
+
+static char strings[MAX_BYTES];
+static char len_str[16];
+
+/* Fills ARGV with CNT arguments of LEN bytes after the program
+   name and the length, followed by a null pointer.  Returns
+   argc. */
+int
+bigargs_vec (char *argv[], int cnt, size_t len)
+{
+  char *p = strings;
+  int i;
+
+  if ((size_t) cnt * (len + 1) > sizeof strings)
+    fail ("%d arguments of %zu bytes do not fit", cnt, len);
+  snprintf (len_str, sizeof len_str, "%zu", len);
+  argv[0] = "child-bigargs";
+  argv[1] = len_str;
+  for (i = 2; i < cnt + 2; i++)
+    {
+      memset (p, 'a' + i % 26, len);
+      p[len] = '\0';
+      argv[i] = p;
+      p += len + 1;
+    }
+  argv[i] = NULL;
+  return i;
+}
+
+/* Returns a command line with CNT arguments of LEN bytes after
+   the program name and the length. */
+char *
+bigargs_cmd_line (int cnt, size_t len)
+{
+  char *p;
+  int i;
+
+  p = strings + snprintf (strings, sizeof strings, "child-bigargs %zu", len);
+  if ((size_t) (p - strings) + (size_t) cnt * (len + 1) >= sizeof strings)
+    fail ("%d arguments of %zu bytes do not fit", cnt, len);
+  for (i = 2; i < cnt + 2; i++)
+    {
+      *p++ = ' ';
+      memset (p, 'a' + i % 26, len);
+      p += len;
+    }
+  *p = '\0';
+  return strings;
+}
@@ -0,0 +1,9 @@
+#ifndef TESTS_USERPROG_BIGARGS_H
+#define TESTS_USERPROG_BIGARGS_H 1
+
+#include <stddef.h>
+
+int bigargs_vec (char *argv[], int cnt, size_t len);
+char *bigargs_cmd_line (int cnt, size_t len);
+
+#endif /* tests/userprog/bigargs.h */
@@ -0,0 +1,31 @@
+/* Child process run by args-big and args-max tests.
+   argv[1] is a length L.  Checks that every later argv[I] is L
+   copies of letter 'a' + I % 26, and returns argc. */
+
+#include <stdlib.h>
+#include <string.h>
+#include "tests/lib.h"
+
+const char *test_name = "child-bigargs";
+
+int
+main (int argc, char *argv[])
+{
+  size_t len;
+  int i;
+
+  if (argc < 2)
+    fail ("no length argument");
+  len = atoi (argv[1]);
+  for (i = 2; i < argc; i++)
+    {
+      size_t j;
+
+      if (strlen (argv[i]) != len)
+        fail ("argv[%d] is %zu bytes, not %zu", i, strlen (argv[i]), len);
+      for (j = 0; j < len; j++)
+        if (argv[i][j] != 'a' + i % 26)
+          fail ("byte %zu of argv[%d] is '%c'", j, i, argv[i][j]);
+    }
+  return argc;
+}
@@ -0,0 +1,30 @@
+/* Child process run by fork-exec-rox and vfork-exec-rox tests.
+
+   Starts child-simple with fork() and exec(), or with vfork() and
+   exec() if the first command-line argument is "vfork", and waits
+   for it.  The child's copy of this program's file must be closed
+   by its exec(), so that once this process exits too the file can be
+   written again. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+
+const char *test_name = "child-fexec";
+
+int
+main (int argc, char *argv[])
+{
+  bool use_vfork = argc > 1 && !strcmp (argv[1], "vfork");
+  pid_t pid;
+
+  pid = use_vfork ? vfork () : fork ("child-simple");
+  if (pid == 0)
+    {
+      exec ("child-simple");
+      exit (-1);
+    }
+  if (pid < 0 || wait (pid) != 81)
+    return 1;
+  return 0;
+}
@@ -0,0 +1,8 @@
+/* Child process run by spawn-bench test.
+   Terminates at once without printing anything. */
+
+int
+main (void)
+{
+  return 0;
+}
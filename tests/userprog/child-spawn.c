@@ -0,0 +1,32 @@
+/* Child process run by spawn-actions test.
+
+   Checks that the file actions its parent passed to spawn() took
+   effect: the descriptor named by the first command-line argument
+   was dup2()ed onto the file, and the one named by the second was
+   closed. */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <syscall.h>
+#include "tests/userprog/sample.inc"
+#include "tests/lib.h"
+
+const char *test_name = "child-spawn";
+
+int
+main (int argc, char *argv[])
+{
+  char buf[16];
+
+  msg ("begin");
+  if (argc != 3 || !isdigit (*argv[1]) || !isdigit (*argv[2]))
+    fail ("bad command-line arguments");
+
+  check_file_handle (atoi (argv[1]), "sample.txt", sample, sizeof sample - 1);
+  CHECK (read (atoi (argv[2]), buf, sizeof buf) == -1,
+         "read closed fd %s", argv[2]);
+  msg ("end");
+
+  return 77;
+}
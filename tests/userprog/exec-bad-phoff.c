@@ -0,0 +1,54 @@
+/* Runs a file whose ELF header is fine but whose program headers lie
+   past its end, with spawn() and with exec().  Both must fail with the
+   same message as any other invalid executable. */
+
+#include <stdint.h>
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+/* ELF64 executable header. */
+struct elf_header
+  {
+    unsigned char ident[16];
+    uint16_t type, machine;
+    uint32_t version;
+    uint64_t entry, phoff, shoff;
+    uint32_t flags;
+    uint16_t ehsize, phentsize, phnum, shentsize, shnum, shstrndx;
+  };
+
+void
+test_main (void)
+{
+  char *argv[] = {"bad-elf", NULL};
+  struct elf_header h;
+  int handle;
+  pid_t pid;
+
+  memset (&h, 0, sizeof h);
+  memcpy (h.ident, "\177ELF\2\1\1", 7);
+  h.type = 2;
+  h.machine = 0x3e;
+  h.version = 1;
+  h.ehsize = sizeof h;
+  h.phentsize = 56;
+  h.phnum = 1;
+  h.phoff = 0x100000;
+
+  CHECK (create ("bad-elf", 0), "create \"bad-elf\"");
+  CHECK ((handle = open ("bad-elf")) > 1, "open \"bad-elf\"");
+  CHECK (write (handle, &h, sizeof h) == (int) sizeof h, "write \"bad-elf\"");
+  close (handle);
+
+  msg ("spawn(\"bad-elf\") = %d", spawn ("bad-elf", argv, NULL));
+
+  pid = fork ("child");
+  if (pid == 0)
+    {
+      exec ("bad-elf");
+      exit (0);
+    }
+  msg ("wait(exec()) = %d", wait (pid));
+}
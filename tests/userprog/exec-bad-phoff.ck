@@ -0,0 +1,32 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF', <<'EOF']);
+(exec-bad-phoff) begin
+(exec-bad-phoff) create "bad-elf"
+(exec-bad-phoff) open "bad-elf"
+(exec-bad-phoff) write "bad-elf"
+load: bad-elf: error loading executable
+bad-elf: exit(-1)
+(exec-bad-phoff) spawn("bad-elf") = -1
+load: bad-elf: error loading executable
+child: exit(-1)
+(exec-bad-phoff) wait(exec()) = -1
+(exec-bad-phoff) end
+exec-bad-phoff: exit(0)
+EOF
+(exec-bad-phoff) begin
+(exec-bad-phoff) create "bad-elf"
+(exec-bad-phoff) open "bad-elf"
+(exec-bad-phoff) write "bad-elf"
+load: bad-elf: error loading executable
+(exec-bad-phoff) spawn("bad-elf") = -1
+bad-elf: exit(-1)
+load: bad-elf: error loading executable
+child: exit(-1)
+(exec-bad-phoff) wait(exec()) = -1
+(exec-bad-phoff) end
+exec-bad-phoff: exit(0)
+EOF
+pass;
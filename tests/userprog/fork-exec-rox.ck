@@ -0,0 +1,17 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(fork-exec-rox) begin
+(child-simple) run
+child-simple: exit(81)
+child-fexec: exit(0)
+(fork-exec-rox) wait(exec()) = 0
+(fork-exec-rox) open "child-fexec"
+(fork-exec-rox) read "child-fexec"
+(fork-exec-rox) write "child-fexec"
+(fork-exec-rox) end
+fork-exec-rox: exit(0)
+EOF
+pass;
@@ -0,0 +1,46 @@
+/* Times sending data from a parent to a forked child through a pipe,
+   in chunks of the pipe's capacity. */
+
+#include <syscall.h>
+#include <vdso.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define CHUNK 4096
+#define TOTAL (1024 * 1024)
+
+static char buf[CHUNK];
+
+void
+test_main (void)
+{
+  int fds[2];
+  int64_t start, us;
+  pid_t pid;
+  int sent, status;
+
+  CHECK (pipe (fds) == 0, "pipe");
+  pid = fork ("child");
+  if (pid == 0)
+    {
+      int received = 0, n;
+
+      close (fds[1]);
+      while ((n = read (fds[0], buf, sizeof buf)) > 0)
+        received += n;
+      exit (received == TOTAL ? 0 : 1);
+    }
+  close (fds[0]);
+
+  start = vdso_time_us ();
+  for (sent = 0; sent < TOTAL; sent += CHUNK)
+    if (write (fds[1], buf, CHUNK) != CHUNK)
+      fail ("write at %d failed", sent);
+  close (fds[1]);
+  status = wait (pid);
+  us = vdso_time_us () - start;
+
+  CHECK (status == 0, "child received %d kB", TOTAL / 1024);
+  msg ("pipe: %lld us, %lld kB/s", (long long) us,
+       (long long) (us > 0 ? (int64_t) TOTAL / 1024 * 1000000 / us : 0));
+}
@@ -0,0 +1,21 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+
+our ($test);
+my (@output) = read_text_file ("$test.output");
+common_checks ("run", @output);
+
+fail "missing timing line\n"
+  unless grep (/^\(pipe-bench\) pipe: \d+ us, \d+ kB\/s$/, @output);
+@output = grep (!/^\(pipe-bench\) pipe: \d+ us, \d+ kB\/s$/, @output);
+compare_output ("run", \@output, [<<'EOF']);
+(pipe-bench) begin
+(pipe-bench) pipe
+child: exit(0)
+(pipe-bench) child received 1024 kB
+(pipe-bench) end
+pipe-bench: exit(0)
+EOF
+pass;
@@ -0,0 +1,53 @@
+/* Sends several times the pipe's capacity from a child to its parent,
+   so that the child blocks on a full pipe and the parent on an empty
+   one, and checks that every byte arrives in order. */
+
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define DATA_SIZE (4 * 4096 + 100)
+
+static char buf[DATA_SIZE];
+
+void
+test_main (void)
+{
+  int fds[2];
+  int received = 0, bad = -1, status;
+  pid_t pid;
+  int i;
+
+  CHECK (pipe (fds) == 0, "pipe");
+  pid = fork ("child");
+  if (pid == 0)
+    {
+      close (fds[0]);
+      for (i = 0; i < DATA_SIZE; i++)
+        buf[i] = i % 251;
+      if (write (fds[1], buf, DATA_SIZE) != DATA_SIZE)
+        exit (1);
+      exit (0);
+    }
+  close (fds[1]);
+
+  for (;;)
+    {
+      int n = read (fds[0], buf + received, DATA_SIZE - received);
+      if (n <= 0)
+        break;
+      received += n;
+    }
+  for (i = 0; i < received; i++)
+    if (buf[i] != (char) (i % 251))
+      {
+        bad = i;
+        break;
+      }
+
+  /* Print only once the child's exit message is out. */
+  status = wait (pid);
+  CHECK (received == DATA_SIZE, "received %d bytes", received);
+  CHECK (bad == -1, "data arrived in order");
+  CHECK (status == 0, "child wrote all of it");
+}
@@ -0,0 +1,15 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(pipe-block) begin
+(pipe-block) pipe
+child: exit(0)
+(pipe-block) received 16484 bytes
+(pipe-block) data arrived in order
+(pipe-block) child wrote all of it
+(pipe-block) end
+pipe-block: exit(0)
+EOF
+pass;
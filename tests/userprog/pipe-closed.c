@@ -0,0 +1,27 @@
+/* Writing a pipe returns -1 once every read end is closed: here the
+   child's, closed when it exits, and then the parent's own. */
+
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+void
+test_main (void)
+{
+  int fds[2], status;
+  pid_t pid;
+
+  CHECK (pipe (fds) == 0, "pipe");
+  CHECK (write (fds[1], "abc", 3) == 3, "write with the read end open");
+
+  pid = fork ("child");
+  if (pid == 0)
+    exit (0);
+
+  status = wait (pid);
+  CHECK (status == 0, "wait(child) = 0");
+  CHECK (write (fds[1], "def", 3) == 3, "write after the child closed its read end");
+
+  close (fds[0]);
+  CHECK (write (fds[1], "ghi", 3) == -1, "write with no reader = -1");
+}
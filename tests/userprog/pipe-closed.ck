@@ -0,0 +1,16 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(pipe-closed) begin
+(pipe-closed) pipe
+(pipe-closed) write with the read end open
+child: exit(0)
+(pipe-closed) wait(child) = 0
+(pipe-closed) write after the child closed its read end
+(pipe-closed) write with no reader = -1
+(pipe-closed) end
+pipe-closed: exit(0)
+EOF
+pass;
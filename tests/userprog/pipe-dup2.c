@@ -0,0 +1,52 @@
+/* Moves the write end of a pipe to another descriptor with dup2() and
+   forks.  The child inherits it, makes it its standard output too, and
+   writes through both; the parent reads everything up to end of file,
+   which comes once the child has exited and the parent has closed its
+   own copy. */
+
+#include <stdio.h>
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define WRITE_FD 30
+
+void
+test_main (void)
+{
+  char buf[64];
+  int fds[2];
+  int received = 0, status;
+  pid_t pid;
+
+  CHECK (pipe (fds) == 0, "pipe");
+  CHECK (dup2 (fds[1], WRITE_FD) == WRITE_FD, "dup2 write end to %d",
+         WRITE_FD);
+  close (fds[1]);
+
+  pid = fork ("child");
+  if (pid == 0)
+    {
+      close (fds[0]);
+      if (write (WRITE_FD, "inherited ", 10) != 10
+          || dup2 (WRITE_FD, STDOUT_FILENO) != STDOUT_FILENO
+          || write (STDOUT_FILENO, "stdout", 6) != 6)
+        exit (1);
+      exit (0);
+    }
+  close (WRITE_FD);
+
+  memset (buf, 0, sizeof buf);
+  for (;;)
+    {
+      int n = read (fds[0], buf + received, sizeof buf - 1 - received);
+      if (n <= 0)
+        break;
+      received += n;
+    }
+  status = wait (pid);
+
+  CHECK (status == 0, "wait(child) = 0");
+  CHECK (!strcmp (buf, "inherited stdout"), "read \"%s\"", buf);
+}
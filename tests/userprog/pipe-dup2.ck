@@ -0,0 +1,15 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(pipe-dup2) begin
+(pipe-dup2) pipe
+(pipe-dup2) dup2 write end to 30
+child: exit(0)
+(pipe-dup2) wait(child) = 0
+(pipe-dup2) read "inherited stdout"
+(pipe-dup2) end
+pipe-dup2: exit(0)
+EOF
+pass;
@@ -0,0 +1,37 @@
+/* Reading a pipe returns 0, end of file, only once every write end is
+   closed: here the parent's own, closed at once, and then the child's,
+   closed when it exits. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+void
+test_main (void)
+{
+  char buf[16];
+  int fds[2];
+  int first, second, status;
+  pid_t pid;
+
+  CHECK (pipe (fds) == 0, "pipe");
+  pid = fork ("child");
+  if (pid == 0)
+    {
+      close (fds[0]);
+      write (fds[1], "hello", 5);
+      exit (0);
+    }
+  close (fds[1]);
+
+  memset (buf, 0, sizeof buf);
+  first = read (fds[0], buf, sizeof buf);
+  second = read (fds[0], buf + 5, sizeof buf - 5);
+  status = wait (pid);
+
+  CHECK (first == 5 && !strcmp (buf, "hello"), "read \"hello\"");
+  CHECK (second == 0, "read at end of file returns 0");
+  CHECK (read (fds[0], buf, sizeof buf) == 0, "and keeps returning 0");
+  CHECK (status == 0, "wait(child) = 0");
+}
@@ -0,0 +1,16 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(pipe-eof) begin
+(pipe-eof) pipe
+child: exit(0)
+(pipe-eof) read "hello"
+(pipe-eof) read at end of file returns 0
+(pipe-eof) and keeps returning 0
+(pipe-eof) wait(child) = 0
+(pipe-eof) end
+pipe-eof: exit(0)
+EOF
+pass;
@@ -0,0 +1,39 @@
+/* pwrite() and pread() at explicit offsets leave the file position
+   alone.  Reads that start at or past the end of the file return
+   0, reads that cross it return what is left, and negative
+   offsets fail. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/userprog/boundary.h"
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define FILE_SIZE 100
+
+void
+test_main (void)
+{
+  char *across = (char *) get_boundary_area () - 5;
+  char buf[16];
+  int handle;
+
+  CHECK (create ("pos", FILE_SIZE), "create \"pos\"");
+  CHECK ((handle = open ("pos")) > 1, "open \"pos\"");
+  CHECK (pwrite (handle, "0123456789", 10, 20) == 10, "pwrite at 20");
+  CHECK (tell (handle) == 0, "position is still 0");
+
+  CHECK (pread (handle, across, 10, 20) == 10, "pread at 20 across a page");
+  if (memcmp (across, "0123456789", 10))
+    fail ("pread returned the wrong data");
+  CHECK (tell (handle) == 0, "position is still 0");
+
+  CHECK (pread (handle, buf, 10, FILE_SIZE - 5) == 5,
+         "pread across end of file returns 5");
+  CHECK (pread (handle, buf, 10, FILE_SIZE) == 0,
+         "pread at end of file returns 0");
+  CHECK (pread (handle, buf, 10, FILE_SIZE * 10) == 0,
+         "pread past end of file returns 0");
+  CHECK (pread (handle, buf, 10, -1) == -1, "pread at -1 fails");
+  CHECK (pwrite (handle, buf, 10, -1) == -1, "pwrite at -1 fails");
+}
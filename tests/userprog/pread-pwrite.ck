@@ -0,0 +1,21 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(pread-pwrite) begin
+(pread-pwrite) create "pos"
+(pread-pwrite) open "pos"
+(pread-pwrite) pwrite at 20
+(pread-pwrite) position is still 0
+(pread-pwrite) pread at 20 across a page
+(pread-pwrite) position is still 0
+(pread-pwrite) pread across end of file returns 5
+(pread-pwrite) pread at end of file returns 0
+(pread-pwrite) pread past end of file returns 0
+(pread-pwrite) pread at -1 fails
+(pread-pwrite) pwrite at -1 fails
+(pread-pwrite) end
+pread-pwrite: exit(0)
+EOF
+pass;
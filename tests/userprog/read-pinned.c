@@ -0,0 +1,36 @@
+/* Writes and reads back a large file with page-aligned buffers.
+   The data must move through the pinned user frames, not through
+   the copy functions: the .ck checks the byte counts that the
+   kernel prints at power off. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define SIZE (64 * 1024)
+
+static char buf[SIZE] __attribute__ ((aligned (4096)));
+
+void
+test_main (void)
+{
+  int handle;
+  size_t i;
+
+  for (i = 0; i < SIZE; i++)
+    buf[i] = i * 7 + (i >> 12);
+
+  CHECK (create ("large", 0), "create \"large\"");
+  CHECK ((handle = open ("large")) > 1, "open \"large\"");
+  CHECK (write (handle, buf, SIZE) == SIZE, "write %d bytes", SIZE);
+
+  memset (buf, 0, SIZE);
+  seek (handle, 0);
+  CHECK (read (handle, buf, SIZE) == SIZE, "read %d bytes", SIZE);
+  for (i = 0; i < SIZE; i++)
+    if (buf[i] != (char) (i * 7 + (i >> 12)))
+      fail ("byte %zu is 0x%02x", i, buf[i] & 0xff);
+  msg ("data matches");
+  close (handle);
+}
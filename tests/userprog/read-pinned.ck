@@ -0,0 +1,28 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+
+our ($test);
+my (@output) = read_text_file ("$test.output");
+common_checks ("run", @output);
+
+my ($copied, $pinned)
+  = map (/^User access: (\d+) bytes copied, (\d+) bytes through pinned/,
+	 @output);
+fail "missing user access statistics\n" if !defined $pinned;
+fail "only $pinned bytes moved through pinned frames\n"
+  if $pinned < 2 * 65536;
+fail "$copied bytes copied, file data must not be copied\n"
+  if $copied >= 16384;
+compare_output ("run", \@output, [<<'EOF']);
+(read-pinned) begin
+(read-pinned) create "large"
+(read-pinned) open "large"
+(read-pinned) write 65536 bytes
+(read-pinned) read 65536 bytes
+(read-pinned) data matches
+(read-pinned) end
+read-pinned: exit(0)
+EOF
+pass;
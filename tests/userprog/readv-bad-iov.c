@@ -0,0 +1,25 @@
+/* Passes readv() an iovec array at a kernel address.  The call
+   must either return -1 or terminate the process with exit code
+   -1. */
+
+#include <syscall.h>
+#include <uio.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+void
+test_main (void)
+{
+  struct iovec iov;
+  char buf[16];
+  int handle;
+
+  CHECK ((handle = open ("sample.txt")) > 1, "open \"sample.txt\"");
+  iov.iov_base = buf;
+  iov.iov_len = sizeof buf;
+  CHECK (readv (handle, &iov, 0) == -1, "readv of 0 segments fails");
+  CHECK (readv (handle, &iov, IOV_MAX + 1) == -1,
+         "readv of too many segments fails");
+  CHECK (readv (handle, (struct iovec *) 0xc0100000, 1) == -1,
+         "readv with a bad iovec array");
+}
@@ -0,0 +1,21 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF', <<'EOF']);
+(readv-bad-iov) begin
+(readv-bad-iov) open "sample.txt"
+(readv-bad-iov) readv of 0 segments fails
+(readv-bad-iov) readv of too many segments fails
+(readv-bad-iov) readv with a bad iovec array
+(readv-bad-iov) end
+readv-bad-iov: exit(0)
+EOF
+(readv-bad-iov) begin
+(readv-bad-iov) open "sample.txt"
+(readv-bad-iov) readv of 0 segments fails
+(readv-bad-iov) readv of too many segments fails
+(readv-bad-iov) readv with a bad iovec array
+readv-bad-iov: exit(-1)
+EOF
+pass;
@@ -0,0 +1,40 @@
+/* Reads "sample.txt" with readv() into three segments, the first
+   of which spans two pages in virtual address space.  The data
+   must arrive in order and the file position must advance. */
+
+#include <string.h>
+#include <syscall.h>
+#include <uio.h>
+#include "tests/userprog/boundary.h"
+#include "tests/userprog/sample.inc"
+#include "tests/lib.h"
+#include "tests/main.h"
+
+static char middle[7];
+static char rest[sizeof sample];
+
+void
+test_main (void)
+{
+  struct iovec iov[3];
+  char *across = (char *) get_boundary_area () - 10;
+  int handle, byte_cnt;
+
+  CHECK ((handle = open ("sample.txt")) > 1, "open \"sample.txt\"");
+
+  iov[0].iov_base = across;
+  iov[0].iov_len = 20;
+  iov[1].iov_base = middle;
+  iov[1].iov_len = sizeof middle;
+  iov[2].iov_base = rest;
+  iov[2].iov_len = sizeof sample - 1 - 20 - sizeof middle;
+  byte_cnt = readv (handle, iov, 3);
+  if (byte_cnt != sizeof sample - 1)
+    fail ("readv() returned %d instead of %zu", byte_cnt, sizeof sample - 1);
+  if (memcmp (across, sample, 20)
+      || memcmp (middle, sample + 20, sizeof middle)
+      || memcmp (rest, sample + 20 + sizeof middle, iov[2].iov_len))
+    fail ("segments differ from \"sample.txt\"");
+  msg ("readv \"sample.txt\" into 3 segments");
+  CHECK (tell (handle) == sizeof sample - 1, "tell \"sample.txt\"");
+}
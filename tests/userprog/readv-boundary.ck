@@ -0,0 +1,13 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(readv-boundary) begin
+(readv-boundary) open "sample.txt"
+(readv-boundary) readv "sample.txt" into 3 segments
+(readv-boundary) tell "sample.txt"
+(readv-boundary) end
+readv-boundary: exit(0)
+EOF
+pass;
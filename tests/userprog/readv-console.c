@@ -0,0 +1,30 @@
+/* writev() to the console prints its segments in order.  readv(),
+   pread() and pwrite() have no use for the console and must
+   return -1 on it. */
+
+#include <stdio.h>
+#include <syscall.h>
+#include <uio.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+void
+test_main (void)
+{
+  struct iovec iov[2];
+  char buf[16];
+
+  iov[0].iov_base = "hello, ";
+  iov[0].iov_len = 7;
+  iov[1].iov_base = "world\n";
+  iov[1].iov_len = 6;
+  CHECK (writev (STDOUT_FILENO, iov, 2) == 13, "writev to the console");
+
+  iov[0].iov_base = buf;
+  iov[0].iov_len = sizeof buf;
+  CHECK (readv (STDIN_FILENO, iov, 1) == -1, "readv from stdin fails");
+  CHECK (readv (STDOUT_FILENO, iov, 1) == -1, "readv from stdout fails");
+  CHECK (pread (STDIN_FILENO, buf, sizeof buf, 0) == -1,
+         "pread from stdin fails");
+  CHECK (pwrite (STDOUT_FILENO, "x", 1, 0) == -1, "pwrite to stdout fails");
+}
@@ -0,0 +1,16 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(readv-console) begin
+(readv-console) writev to the console
+hello, world
+(readv-console) readv from stdin fails
+(readv-console) readv from stdout fails
+(readv-console) pread from stdin fails
+(readv-console) pwrite to stdout fails
+(readv-console) end
+readv-console: exit(0)
+EOF
+pass;
@@ -0,0 +1,50 @@
+/* Copies a file that spans two pages to another file with
+   sendfile(), first from the input's position, then from an
+   explicit offset, then from past its end. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define FILE_SIZE 6000
+
+static char data[FILE_SIZE];
+static char buf[FILE_SIZE];
+
+void
+test_main (void)
+{
+  int in, out;
+  off_t ofs;
+  size_t i;
+
+  for (i = 0; i < FILE_SIZE; i++)
+    data[i] = 'a' + i % 26;
+  CHECK (create ("in", FILE_SIZE), "create \"in\"");
+  CHECK (create ("out", FILE_SIZE), "create \"out\"");
+  CHECK ((in = open ("in")) > 1, "open \"in\"");
+  CHECK ((out = open ("out")) > 1, "open \"out\"");
+  CHECK (write (in, data, FILE_SIZE) == FILE_SIZE, "write \"in\"");
+
+  seek (in, 0);
+  CHECK (sendfile (out, in, NULL, FILE_SIZE) == FILE_SIZE,
+         "sendfile \"in\" to \"out\"");
+  CHECK (tell (in) == FILE_SIZE && tell (out) == FILE_SIZE,
+         "both positions advanced");
+  seek (out, 0);
+  CHECK (read (out, buf, FILE_SIZE) == FILE_SIZE, "read \"out\"");
+  if (memcmp (buf, data, FILE_SIZE))
+    fail ("\"out\" differs from \"in\"");
+  msg ("\"out\" matches \"in\"");
+
+  ofs = 10;
+  seek (out, 0);
+  CHECK (sendfile (out, in, &ofs, 20) == 20, "sendfile 20 bytes from 10");
+  CHECK (ofs == 30, "offset advanced to 30");
+  CHECK (tell (in) == FILE_SIZE, "position of \"in\" unchanged");
+
+  ofs = FILE_SIZE + 100;
+  CHECK (sendfile (out, in, &ofs, 20) == 0,
+         "sendfile past end of file returns 0");
+}
@@ -0,0 +1,23 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(sendfile-file) begin
+(sendfile-file) create "in"
+(sendfile-file) create "out"
+(sendfile-file) open "in"
+(sendfile-file) open "out"
+(sendfile-file) write "in"
+(sendfile-file) sendfile "in" to "out"
+(sendfile-file) both positions advanced
+(sendfile-file) read "out"
+(sendfile-file) "out" matches "in"
+(sendfile-file) sendfile 20 bytes from 10
+(sendfile-file) offset advanced to 30
+(sendfile-file) position of "in" unchanged
+(sendfile-file) sendfile past end of file returns 0
+(sendfile-file) end
+sendfile-file: exit(0)
+EOF
+pass;
@@ -0,0 +1,30 @@
+/* Copies a file to the console with sendfile().  The console
+   cannot be the input, and stdin cannot be the output. */
+
+#include <stdio.h>
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+static const char text[] = "sendfile to the console\n";
+
+void
+test_main (void)
+{
+  int handle;
+  int size = strlen (text);
+
+  CHECK (create ("text", size), "create \"text\"");
+  CHECK ((handle = open ("text")) > 1, "open \"text\"");
+  CHECK (write (handle, text, size) == size, "write \"text\"");
+
+  seek (handle, 0);
+  CHECK (sendfile (STDOUT_FILENO, handle, NULL, size) == size,
+         "sendfile \"text\" to stdout");
+  seek (handle, 0);
+  CHECK (sendfile (STDIN_FILENO, handle, NULL, size) == -1,
+         "sendfile to stdin fails");
+  CHECK (sendfile (handle, STDIN_FILENO, NULL, size) == -1,
+         "sendfile from stdin fails");
+}
@@ -0,0 +1,17 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(sendfile-stdout) begin
+(sendfile-stdout) create "text"
+(sendfile-stdout) open "text"
+(sendfile-stdout) write "text"
+(sendfile-stdout) sendfile "text" to stdout
+sendfile to the console
+(sendfile-stdout) sendfile to stdin fails
+(sendfile-stdout) sendfile from stdin fails
+(sendfile-stdout) end
+sendfile-stdout: exit(0)
+EOF
+pass;
@@ -0,0 +1,39 @@
+/* Starts a child with spawn(), asking it to dup2() one of the
+   parent's descriptors onto a new number and to close another, and
+   checks that the actions changed only the child's descriptors. */
+
+#include <spawn.h>
+#include <stdio.h>
+#include <syscall.h>
+#include "tests/userprog/sample.inc"
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define NEWFD 20
+
+void
+test_main (void)
+{
+  char newfd_arg[16], closed_arg[16], buf[16];
+  char *argv[] = {"child-spawn", newfd_arg, closed_arg, NULL};
+  struct spawn_action actions[3];
+  int handle, closed;
+  pid_t pid;
+
+  CHECK ((handle = open ("sample.txt")) > 1, "open \"sample.txt\"");
+  CHECK ((closed = open ("sample.txt")) > 1, "open \"sample.txt\" again");
+
+  actions[0] = (struct spawn_action) {SPAWN_DUP2, handle, NEWFD};
+  actions[1] = (struct spawn_action) {SPAWN_CLOSE, closed, 0};
+  actions[2] = (struct spawn_action) {SPAWN_END, 0, 0};
+  snprintf (newfd_arg, sizeof newfd_arg, "%d", NEWFD);
+  snprintf (closed_arg, sizeof closed_arg, "%d", closed);
+
+  pid = spawn ("child-spawn", argv, actions);
+  CHECK (pid > 0, "spawn \"child-spawn\"");
+  msg ("wait(spawn()) = %d", wait (pid));
+
+  /* The actions ran in the child only. */
+  CHECK (read (NEWFD, buf, sizeof buf) == -1, "read fd %d", NEWFD);
+  check_file_handle (closed, "sample.txt", sample, sizeof sample - 1);
+}
@@ -0,0 +1,21 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(spawn-actions) begin
+(spawn-actions) open "sample.txt"
+(spawn-actions) open "sample.txt" again
+(spawn-actions) spawn "child-spawn"
+(child-spawn) begin
+(child-spawn) verified contents of "sample.txt"
+(child-spawn) read closed fd 3
+(child-spawn) end
+child-spawn: exit(77)
+(spawn-actions) wait(spawn()) = 77
+(spawn-actions) read fd 20
+(spawn-actions) verified contents of "sample.txt"
+(spawn-actions) end
+spawn-actions: exit(0)
+EOF
+pass;
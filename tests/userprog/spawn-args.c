@@ -0,0 +1,16 @@
+/* Passes spawn() arguments that contain spaces, and an empty one.
+   Each must reach the child as one argument, exactly as given. */
+
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+void
+test_main (void)
+{
+  char *argv[] = {"child-args", "two words", "", "  padded  ", NULL};
+  pid_t pid;
+
+  pid = spawn ("child-args", argv, NULL);
+  msg ("wait(spawn()) = %d", wait (pid));
+}
@@ -0,0 +1,73 @@
+/* Times starting a child that exits at once and waiting for it, done
+   three ways: fork() then exec(), vfork() then exec(), and spawn().
+   fork() copies the whole address space only for exec() to throw it
+   away; vfork() and spawn() copy none of it. */
+
+#include <stdio.h>
+#include <syscall.h>
+#include <vdso.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define CHILD_CNT 20
+
+/* Bytes of dirty memory that fork() has to copy. */
+#define BALLAST (64 * 1024)
+
+static char ballast[BALLAST];
+
+static void
+report (const char *how, int64_t start)
+{
+  msg ("%s: %lld us per child", how,
+       (long long) ((vdso_time_us () - start) / CHILD_CNT));
+}
+
+void
+test_main (void)
+{
+  char *argv[] = {"child-quiet", NULL};
+  int64_t start;
+  pid_t pid;
+  int i;
+
+  for (i = 0; i < BALLAST; i += 4096)
+    ballast[i] = 1;
+
+  start = vdso_time_us ();
+  for (i = 0; i < CHILD_CNT; i++)
+    {
+      pid = fork ("child");
+      if (pid == 0)
+        {
+          exec ("child-quiet");
+          exit (-1);
+        }
+      if (pid < 0 || wait (pid) != 0)
+        fail ("fork+exec+wait #%d failed", i);
+    }
+  report ("fork+exec+wait", start);
+
+  start = vdso_time_us ();
+  for (i = 0; i < CHILD_CNT; i++)
+    {
+      pid = vfork ();
+      if (pid == 0)
+        {
+          exec ("child-quiet");
+          exit (-1);
+        }
+      if (pid < 0 || wait (pid) != 0)
+        fail ("vfork+exec+wait #%d failed", i);
+    }
+  report ("vfork+exec+wait", start);
+
+  start = vdso_time_us ();
+  for (i = 0; i < CHILD_CNT; i++)
+    {
+      pid = spawn ("child-quiet", argv, NULL);
+      if (pid < 0 || wait (pid) != 0)
+        fail ("spawn+wait #%d failed", i);
+    }
+  report ("spawn+wait", start);
+}
@@ -0,0 +1,21 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+
+our ($test);
+my (@output) = read_text_file ("$test.output");
+common_checks ("run", @output);
+
+my ($how) = qr/(fork\+exec\+wait|vfork\+exec\+wait|spawn\+wait)/;
+fail "missing timing lines\n"
+  unless grep (/^\(spawn-bench\) $how: \d+ us per child$/, @output) == 3;
+fail "wrong number of children exited\n"
+  unless grep (/^(child|child-quiet|spawn-bench): exit\(0\)$/, @output) == 3 * 20 + 1;
+@output = grep (!/^\(spawn-bench\) $how: \d+ us per child$/
+		&& !/^(child|child-quiet|spawn-bench): exit\(0\)$/, @output);
+compare_output ("run", \@output, [<<'EOF']);
+(spawn-bench) begin
+(spawn-bench) end
+EOF
+pass;
@@ -0,0 +1,28 @@
+/* Console output is buffered a line at a time, but that must not
+   change its order.  The parent's unfinished line must come out
+   before fork() returns, ahead of the child's output and without
+   being copied into the child; the child's unfinished line must
+   come out before its exit message. */
+
+#include <stdio.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+void
+test_main (void)
+{
+  pid_t pid;
+  int status;
+
+  write (STDOUT_FILENO, "parent ", 7);
+  pid = fork ("child");
+  if (pid == 0)
+    {
+      write (STDOUT_FILENO, "and child\n", 10);
+      write (STDOUT_FILENO, "exiting: ", 9);
+      exit (5);
+    }
+  status = wait (pid);
+  msg ("wait(child) = %d", status);
+}
@@ -0,0 +1,13 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(stdout-order) begin
+parent and child
+exiting: child: exit(5)
+(stdout-order) wait(child) = 5
+(stdout-order) end
+stdout-order: exit(0)
+EOF
+pass;
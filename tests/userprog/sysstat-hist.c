@@ -0,0 +1,47 @@
+/* Calls filesize() a known number of times and checks what
+   sysstat() reports for it: every call counted and timed, and
+   every timed call in exactly one histogram bucket. */
+
+#include <syscall.h>
+#include <syscall-nr.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define CALL_CNT 100
+
+static struct sysstat before[SYS_FILESIZE + 1];
+static struct sysstat after[SYS_FILESIZE + 1];
+
+/* Returns the sum of the histogram buckets of STAT. */
+static uint64_t
+hist_sum (const struct sysstat *stat)
+{
+  uint64_t sum = 0;
+  int i;
+
+  for (i = 0; i < SYSSTAT_BUCKETS; i++)
+    sum += stat->hist[i];
+  return sum;
+}
+
+void
+test_main (void)
+{
+  const struct sysstat *b = &before[SYS_FILESIZE];
+  const struct sysstat *a = &after[SYS_FILESIZE];
+  int handle, i;
+
+  CHECK ((handle = open ("sample.txt")) > 1, "open \"sample.txt\"");
+  CHECK (sysstat (before, SYS_FILESIZE + 1) > SYS_FILESIZE, "sysstat");
+  for (i = 0; i < CALL_CNT; i++)
+    filesize (handle);
+  CHECK (sysstat (after, SYS_FILESIZE + 1) > SYS_FILESIZE, "sysstat");
+
+  CHECK (a->calls - b->calls == CALL_CNT, "%d filesize calls counted",
+         CALL_CNT);
+  CHECK (a->timed - b->timed == CALL_CNT, "%d filesize calls timed",
+         CALL_CNT);
+  CHECK (a->cycles > b->cycles, "filesize took some cycles");
+  CHECK (hist_sum (a) - hist_sum (b) == CALL_CNT,
+         "histogram holds %d more calls", CALL_CNT);
+}
@@ -0,0 +1,17 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(sysstat-hist) begin
+(sysstat-hist) open "sample.txt"
+(sysstat-hist) sysstat
+(sysstat-hist) sysstat
+(sysstat-hist) 100 filesize calls counted
+(sysstat-hist) 100 filesize calls timed
+(sysstat-hist) filesize took some cycles
+(sysstat-hist) histogram holds 100 more calls
+(sysstat-hist) end
+sysstat-hist: exit(0)
+EOF
+pass;
@@ -0,0 +1,44 @@
+/* Times reading the thread id and the tick count from the vDSO page
+   against a system call that does no work, tell() on the console,
+   so that the difference is the cost of trapping into the kernel. */
+
+#include <stdio.h>
+#include <syscall.h>
+#include <vdso.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define VDSO_CALLS 100000
+#define SYSCALLS 10000
+
+static void
+report (const char *how, int64_t start, int calls)
+{
+  msg ("%s: %lld ns per call", how,
+       (long long) ((vdso_time_us () - start) * 1000 / calls));
+}
+
+void
+test_main (void)
+{
+  volatile int64_t sink = 0;
+  int64_t start;
+  int i;
+
+  start = vdso_time_us ();
+  for (i = 0; i < VDSO_CALLS; i++)
+    sink += vdso_gettid ();
+  report ("vdso_gettid", start, VDSO_CALLS);
+
+  start = vdso_time_us ();
+  for (i = 0; i < VDSO_CALLS; i++)
+    sink += vdso_ticks ();
+  report ("vdso_ticks", start, VDSO_CALLS);
+
+  start = vdso_time_us ();
+  for (i = 0; i < SYSCALLS; i++)
+    sink += tell (STDIN_FILENO);
+  report ("tell syscall", start, SYSCALLS);
+
+  CHECK (vdso_gettid () == vdso_gettid (), "thread id is stable");
+}
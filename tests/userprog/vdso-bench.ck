@@ -0,0 +1,20 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+
+our ($test);
+my (@output) = read_text_file ("$test.output");
+common_checks ("run", @output);
+
+my ($how) = qr/(vdso_gettid|vdso_ticks|tell syscall)/;
+fail "missing timing lines\n"
+  unless grep (/^\(vdso-bench\) $how: \d+ ns per call$/, @output) == 3;
+@output = grep (!/^\(vdso-bench\) $how: \d+ ns per call$/, @output);
+compare_output ("run", \@output, [<<'EOF']);
+(vdso-bench) begin
+(vdso-bench) thread id is stable
+(vdso-bench) end
+vdso-bench: exit(0)
+EOF
+pass;
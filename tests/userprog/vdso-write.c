@@ -0,0 +1,31 @@
+/* Passes the read-only vDSO page to write(), which must copy it to
+   the file like any other readable buffer, and then to read(), which
+   must kill the process since the page is not writable. */
+
+#include <string.h>
+#include <syscall.h>
+#include <vdso.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+void
+test_main (void)
+{
+  const struct vdso_data *vdso = (const struct vdso_data *) VDSO_ADDR;
+  struct vdso_data copy;
+  int handle;
+
+  CHECK (create ("vdso", 0), "create \"vdso\"");
+  CHECK ((handle = open ("vdso")) > 1, "open \"vdso\"");
+  CHECK (write (handle, vdso, sizeof copy) == (int) sizeof copy,
+         "write vDSO page to \"vdso\"");
+
+  seek (handle, 0);
+  CHECK (read (handle, &copy, sizeof copy) == (int) sizeof copy,
+         "read \"vdso\"");
+  CHECK (copy.timer_freq == vdso->timer_freq, "timer frequency matches");
+
+  seek (handle, 0);
+  read (handle, (void *) VDSO_ADDR, sizeof copy);
+  fail ("should not have survived read() into the vDSO page");
+}
@@ -0,0 +1,14 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(vdso-write) begin
+(vdso-write) create "vdso"
+(vdso-write) open "vdso"
+(vdso-write) write vDSO page to "vdso"
+(vdso-write) read "vdso"
+(vdso-write) timer frequency matches
+vdso-write: exit(-1)
+EOF
+pass;
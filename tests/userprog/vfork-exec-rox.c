@@ -0,0 +1,29 @@
+/* Runs child-fexec, which starts child-simple with vfork() and exec().
+   Once both have exited, nothing runs child-fexec any more, so it
+   must be writable again. */
+
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+void
+test_main (void)
+{
+  char byte;
+  int handle;
+  pid_t pid;
+
+  pid = fork ("child-fexec");
+  if (pid == 0)
+    {
+      exec ("child-fexec vfork");
+      exit (-1);
+    }
+  msg ("wait(exec()) = %d", wait (pid));
+
+  CHECK ((handle = open ("child-fexec")) > 1, "open \"child-fexec\"");
+  CHECK (read (handle, &byte, 1) == 1, "read \"child-fexec\"");
+  seek (handle, 0);
+  CHECK (write (handle, &byte, 1) == 1, "write \"child-fexec\"");
+  close (handle);
+}
@@ -0,0 +1,17 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(vfork-exec-rox) begin
+(child-simple) run
+child-fexec: exit(81)
+child-fexec: exit(0)
+(vfork-exec-rox) wait(exec()) = 0
+(vfork-exec-rox) open "child-fexec"
+(vfork-exec-rox) read "child-fexec"
+(vfork-exec-rox) write "child-fexec"
+(vfork-exec-rox) end
+vfork-exec-rox: exit(0)
+EOF
+pass;
@@ -0,0 +1,24 @@
+/* vfork()s a child that exec()s another program at once, and checks
+   that the parent resumes with its own stack intact once the child
+   has left the borrowed address space. */
+
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+void
+test_main (void)
+{
+  volatile int canary = 0x1234;
+  pid_t pid;
+
+  pid = vfork ();
+  if (pid == 0)
+    {
+      exec ("child-simple");
+      exit (-1);
+    }
+  CHECK (pid > 0, "vfork");
+  msg ("wait(vfork()) = %d", wait (pid));
+  CHECK (canary == 0x1234, "canary intact");
+}
@@ -0,0 +1,27 @@
+/* vfork()s a child that writes to the parent's memory and exits.
+   The parent must not run until the child is done, must see the
+   child's write since the two share one address space, and must
+   get the child's exit status from wait(). */
+
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+static volatile int shared;
+
+void
+test_main (void)
+{
+  pid_t pid;
+
+  shared = 0;
+  pid = vfork ();
+  if (pid == 0)
+    {
+      shared = 42;
+      exit (5);
+    }
+  CHECK (pid > 0, "vfork");
+  CHECK (shared == 42, "child's write is visible");
+  msg ("wait(vfork()) = %d", wait (pid));
+}
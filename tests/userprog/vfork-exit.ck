@@ -0,0 +1,14 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(vfork-exit) begin
+vfork-exit: exit(5)
+(vfork-exit) vfork
+(vfork-exit) child's write is visible
+(vfork-exit) wait(vfork()) = 5
+(vfork-exit) end
+vfork-exit: exit(0)
+EOF
+pass;
@@ -0,0 +1,32 @@
+/* Forks more children than the kernel pool has room for thread
+   pages, and waits for none of them until all have been forked.
+   The children exit at once, and an unreaped child must not keep
+   its thread page, or forking runs out of memory.  Every child's
+   exit status must still be there for wait(). */
+
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define CHILD_CNT 1024
+
+static pid_t pids[CHILD_CNT];
+
+void
+test_main (void)
+{
+  int i;
+
+  for (i = 0; i < CHILD_CNT; i++)
+    {
+      pids[i] = fork ("child");
+      if (pids[i] == 0)
+        exit (81);
+      if (pids[i] < 0)
+        fail ("fork of child %d failed", i);
+    }
+  for (i = 0; i < CHILD_CNT; i++)
+    if (wait (pids[i]) != 81)
+      fail ("wait for child %d failed", i);
+  msg ("wait for %d children", CHILD_CNT);
+}
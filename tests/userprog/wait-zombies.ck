@@ -0,0 +1,11 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([join ("\n",
+		       "(wait-zombies) begin",
+		       ("child: exit(81)") x 1024,
+		       "(wait-zombies) wait for 1024 children",
+		       "(wait-zombies) end",
+		       "wait-zombies: exit(0)") . "\n"]);
+pass;
@@ -0,0 +1,45 @@
+/* Forks several children that exit with different statuses and reaps
+   them with waitpid(-1), which must return each child exactly once
+   with its own status, and then -1 once none are left. */
+
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define CHILD_CNT 4
+
+void
+test_main (void)
+{
+  pid_t pids[CHILD_CNT];
+  bool reaped[CHILD_CNT] = {false};
+  int i, j;
+
+  for (i = 0; i < CHILD_CNT; i++)
+    {
+      pids[i] = fork ("child");
+      if (pids[i] == 0)
+        exit (10 + i);
+      if (pids[i] < 0)
+        fail ("fork #%d failed", i);
+    }
+
+  for (i = 0; i < CHILD_CNT; i++)
+    {
+      int status;
+      pid_t pid = waitpid (-1, &status);
+
+      for (j = 0; j < CHILD_CNT; j++)
+        if (pids[j] == pid)
+          break;
+      if (j == CHILD_CNT)
+        fail ("waitpid(-1) returned %d, not a child", pid);
+      if (reaped[j])
+        fail ("waitpid(-1) returned child #%d twice", j);
+      if (status != 10 + j)
+        fail ("child #%d exited with %d, not %d", j, status, 10 + j);
+      reaped[j] = true;
+    }
+  msg ("reaped %d children", CHILD_CNT);
+  CHECK (waitpid (-1, NULL) == -1, "waitpid(-1) with no children left");
+}
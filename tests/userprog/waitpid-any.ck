@@ -0,0 +1,11 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(waitpid-any) begin
+(waitpid-any) reaped 4 children
+(waitpid-any) waitpid(-1) with no children left
+(waitpid-any) end
+EOF
+pass;
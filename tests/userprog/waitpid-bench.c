@@ -0,0 +1,58 @@
+/* Times a fan-out of children that exit at once: forks CHILD_CNT of
+   them and reaps them in fork order with wait(), then does the same
+   reaping them in exit order with waitpid(-1). */
+
+#include <syscall.h>
+#include <vdso.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define CHILD_CNT 16
+#define ROUND_CNT 4
+
+static pid_t pids[CHILD_CNT];
+
+static void
+fork_all (void)
+{
+  int i;
+
+  for (i = 0; i < CHILD_CNT; i++)
+    {
+      pids[i] = fork ("child");
+      if (pids[i] == 0)
+        exit (i);
+      if (pids[i] < 0)
+        fail ("fork #%d failed", i);
+    }
+}
+
+void
+test_main (void)
+{
+  int64_t start, wait_us = 0, waitpid_us = 0;
+  int round, i;
+
+  for (round = 0; round < ROUND_CNT; round++)
+    {
+      start = vdso_time_us ();
+      fork_all ();
+      for (i = 0; i < CHILD_CNT; i++)
+        if (wait (pids[i]) != i)
+          fail ("wait() for child #%d failed", i);
+      wait_us += vdso_time_us () - start;
+
+      start = vdso_time_us ();
+      fork_all ();
+      for (i = 0; i < CHILD_CNT; i++)
+        if (waitpid (-1, NULL) < 0)
+          fail ("waitpid(-1) #%d failed", i);
+      waitpid_us += vdso_time_us () - start;
+    }
+  CHECK (waitpid (-1, NULL) == -1, "all children reaped");
+
+  msg ("fork+wait: %lld us per child",
+       (long long) (wait_us / (ROUND_CNT * CHILD_CNT)));
+  msg ("fork+waitpid(-1): %lld us per child",
+       (long long) (waitpid_us / (ROUND_CNT * CHILD_CNT)));
+}
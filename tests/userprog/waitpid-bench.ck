@@ -0,0 +1,21 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+
+our ($test);
+my (@output) = read_text_file ("$test.output");
+common_checks ("run", @output);
+
+my ($how) = qr/(fork\+wait|fork\+waitpid\(-1\))/;
+fail "missing timing lines\n"
+  unless grep (/^\(waitpid-bench\) $how: \d+ us per child$/, @output) == 2;
+fail "wrong number of children exited\n"
+  unless grep (/^child: exit\(\d+\)$/, @output) == 2 * 4 * 16;
+@output = grep (!/^\(waitpid-bench\) $how: \d+ us per child$/, @output);
+compare_output ("run", IGNORE_EXIT_CODES => 1, \@output, [<<'EOF']);
+(waitpid-bench) begin
+(waitpid-bench) all children reaped
+(waitpid-bench) end
+EOF
+pass;
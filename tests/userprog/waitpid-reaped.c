@@ -0,0 +1,36 @@
+/* Reaps one of two exited children with wait() and then calls
+   waitpid(-1), which must return the other child, not the one that
+   wait() already reaped, and then -1. */
+
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+void
+test_main (void)
+{
+  pid_t first, second;
+  volatile int spin;
+  int status;
+
+  first = fork ("child");
+  if (first == 0)
+    exit (20);
+
+  /* The second child runs a while, so that the first one has most
+     likely exited and is on the list of exited children by the time
+     wait() reaps it. */
+  second = fork ("child");
+  if (second == 0)
+    {
+      for (spin = 0; spin < 1000000; spin++)
+        continue;
+      exit (21);
+    }
+
+  CHECK (first > 0 && second > 0, "fork two children");
+  msg ("wait(first) = %d", wait (first));
+  CHECK (waitpid (-1, &status) == second, "waitpid(-1) returns second");
+  msg ("status = %d", status);
+  CHECK (waitpid (-1, &status) == -1, "waitpid(-1) with no children left");
+}
@@ -0,0 +1,14 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(waitpid-reaped) begin
+(waitpid-reaped) fork two children
+(waitpid-reaped) wait(first) = 20
+(waitpid-reaped) waitpid(-1) returns second
+(waitpid-reaped) status = 21
+(waitpid-reaped) waitpid(-1) with no children left
+(waitpid-reaped) end
+EOF
+pass;
@@ -0,0 +1,22 @@
+/* Passes writev() a segment at a kernel address after a valid
+   one.  The call must either return -1 or terminate the process
+   with exit code -1. */
+
+#include <syscall.h>
+#include <uio.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+void
+test_main (void)
+{
+  struct iovec iov[2];
+  int handle;
+
+  CHECK ((handle = open ("sample.txt")) > 1, "open \"sample.txt\"");
+  iov[0].iov_base = "valid";
+  iov[0].iov_len = 5;
+  iov[1].iov_base = (char *) 0xc0100000;
+  iov[1].iov_len = 123;
+  CHECK (writev (handle, iov, 2) == -1, "writev from a bad segment");
+}
@@ -0,0 +1,17 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF', <<'EOF']);
+(writev-bad-base) begin
+(writev-bad-base) open "sample.txt"
+(writev-bad-base) writev from a bad segment
+(writev-bad-base) end
+writev-bad-base: exit(0)
+EOF
+(writev-bad-base) begin
+(writev-bad-base) open "sample.txt"
+(writev-bad-base) writev from a bad segment
+writev-bad-base: exit(-1)
+EOF
+pass;
@@ -0,0 +1,50 @@
+/* Writes a file with writev() from a segment that spans two pages
+   in virtual address space, a small segment and a whole aligned
+   page, then reads it back with read(). */
+
+#include <string.h>
+#include <syscall.h>
+#include <uio.h>
+#include "tests/userprog/boundary.h"
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define ACROSS_SIZE 100
+#define SMALL_SIZE 5
+#define FILE_SIZE (ACROSS_SIZE + SMALL_SIZE + 4096)
+
+static char page[4096] __attribute__ ((aligned (4096)));
+static char buf[FILE_SIZE];
+
+void
+test_main (void)
+{
+  struct iovec iov[3];
+  char *across = (char *) get_boundary_area () - ACROSS_SIZE / 2;
+  int handle, byte_cnt;
+
+  memset (across, 'a', ACROSS_SIZE);
+  memset (page, 'p', sizeof page);
+  iov[0].iov_base = across;
+  iov[0].iov_len = ACROSS_SIZE;
+  iov[1].iov_base = "small";
+  iov[1].iov_len = SMALL_SIZE;
+  iov[2].iov_base = page;
+  iov[2].iov_len = sizeof page;
+
+  CHECK (create ("vec", FILE_SIZE), "create \"vec\"");
+  CHECK ((handle = open ("vec")) > 1, "open \"vec\"");
+  byte_cnt = writev (handle, iov, 3);
+  if (byte_cnt != FILE_SIZE)
+    fail ("writev() returned %d instead of %d", byte_cnt, FILE_SIZE);
+  msg ("writev \"vec\" from 3 segments");
+  CHECK (tell (handle) == FILE_SIZE, "tell \"vec\"");
+
+  seek (handle, 0);
+  CHECK (read (handle, buf, FILE_SIZE) == FILE_SIZE, "read \"vec\"");
+  if (memcmp (buf, across, ACROSS_SIZE)
+      || memcmp (buf + ACROSS_SIZE, "small", SMALL_SIZE)
+      || memcmp (buf + ACROSS_SIZE + SMALL_SIZE, page, sizeof page))
+    fail ("\"vec\" differs from the segments written");
+  msg ("\"vec\" holds the segments in order");
+}
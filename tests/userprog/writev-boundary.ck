@@ -0,0 +1,16 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(writev-boundary) begin
+(writev-boundary) create "vec"
+(writev-boundary) open "vec"
+(writev-boundary) writev "vec" from 3 segments
+(writev-boundary) tell "vec"
+(writev-boundary) read "vec"
+(writev-boundary) "vec" holds the segments in order
+(writev-boundary) end
+writev-boundary: exit(0)
+EOF
+pass;
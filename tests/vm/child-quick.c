@@ -0,0 +1,8 @@
+/* Child process run by mmap-exec-stale test.
+   Terminates at once without printing anything. */
+
+int
+main (void)
+{
+  return 0;
+}
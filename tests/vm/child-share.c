@@ -0,0 +1,45 @@
+/* Child process of share-concurrent.
+   Reads every page of a large read-only table, sends the physical
+   address of each page to the parent through the pipe whose write
+   end is argv[1], then waits for the pipe whose read end is
+   argv[2] to reach end of file before exiting. */
+
+#include <stdlib.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+#include "tests/vm/share.h"
+
+const char *test_name = "child-share";
+
+static const char table[SHARE_PAGE_CNT * 4096] = { 1 };
+
+int
+main (int argc, char *argv[])
+{
+  const volatile char *p = table;
+  void *addrs[SHARE_PAGE_CNT];
+  struct memstat before, after;
+  char c;
+  int i;
+
+  if (argc != 3)
+    fail ("usage: child-share RESULT-FD RELEASE-FD");
+
+  memstat (&before);
+  for (i = 0; i < SHARE_PAGE_CNT; i++)
+    {
+      (void) p[i * 4096];
+      addrs[i] = get_phys_addr ((void *) &table[i * 4096]);
+    }
+  memstat (&after);
+  if (after.rss - before.rss >= SHARE_PAGE_CNT / 4)
+    fail ("read-only pages took %lld private frames",
+          after.rss - before.rss);
+
+  if (write (atoi (argv[1]), addrs, sizeof addrs) != sizeof addrs)
+    fail ("write to parent failed");
+  if (read (atoi (argv[2]), &c, 1) != 0)
+    fail ("release pipe did not reach end of file");
+  return 0;
+}
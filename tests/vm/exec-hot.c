@@ -0,0 +1,41 @@
+/* Runs the same program twice.  The second exec() must find its
+   image and its pages in the caches left behind by the first one,
+   so that it reads at most a few directory sectors from disk, much
+   less than the first exec(). */
+
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+/* Runs "child-quick" in a child process and returns the number of
+   sectors read from the file system disk meanwhile. */
+static long long
+run_child (void)
+{
+  long long read_cnt = get_fs_disk_read_cnt ();
+  pid_t pid;
+
+  pid = fork ("child-quick");
+  if (pid == 0)
+    {
+      exec ("child-quick");
+      exit (-1);
+    }
+  if (wait (pid) != 0)
+    fail ("\"child-quick\" failed");
+  return get_fs_disk_read_cnt () - read_cnt;
+}
+
+void
+test_main (void)
+{
+  long long cold, hot;
+
+  cold = run_child ();
+  msg ("cold exec");
+  hot = run_child ();
+  msg ("hot exec");
+  if (hot * 2 > cold)
+    fail ("hot exec read %lld sectors, cold exec only %lld", hot, cold);
+  msg ("hot exec read at most half as many sectors");
+}
@@ -0,0 +1,23 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+
+our ($test);
+my (@output) = read_text_file ("$test.output");
+common_checks ("run", @output);
+
+my ($hits) = map (/^Exec images: (\d+) hits/, @output);
+fail "missing exec image statistics\n" if !defined $hits;
+fail "second exec missed the exec image cache\n" if $hits < 1;
+compare_output ("run", \@output, [<<'EOF']);
+(exec-hot) begin
+child-quick: exit(0)
+(exec-hot) cold exec
+child-quick: exit(0)
+(exec-hot) hot exec
+(exec-hot) hot exec read at most half as many sectors
+(exec-hot) end
+exec-hot: exit(0)
+EOF
+pass;
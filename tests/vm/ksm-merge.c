@@ -0,0 +1,55 @@
+/* Fills many anonymous pages with the same contents and waits for
+   the same-page merging scanner, enabled by the kernel command
+   line, to merge them.  Writing each page afterward must give it
+   a private copy again without changing the others. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_SIZE 4096
+#define PAGE_CNT 64
+
+/* Longest wait for the scanner, in microseconds. */
+#define MERGE_TIMEOUT (10 * 1000 * 1000)
+
+static char pages[PAGE_CNT][PAGE_SIZE];
+
+void
+test_main (void)
+{
+  struct memstat filled, merged, stat;
+  int64_t start;
+  size_t i, j;
+
+  for (i = 0; i < PAGE_CNT; i++)
+    memset (pages[i], 'k', PAGE_SIZE);
+  memstat (&filled);
+  msg ("fill %d pages", PAGE_CNT);
+
+  start = vdso_time_us ();
+  for (;;)
+    {
+      memstat (&merged);
+      if (filled.rss - merged.rss >= PAGE_CNT * 3 / 4)
+        break;
+      if (vdso_time_us () - start > MERGE_TIMEOUT)
+        fail ("resident set shrank by only %lld pages",
+              filled.rss - merged.rss);
+    }
+  msg ("identical pages merged");
+
+  for (i = 0; i < PAGE_CNT; i++)
+    pages[i][i] = 'a' + i % 26;
+  memstat (&stat);
+  if (stat.rss - merged.rss < PAGE_CNT * 3 / 4)
+    fail ("written pages did not get their frames back");
+  msg ("writes unmerge the pages");
+
+  for (i = 0; i < PAGE_CNT; i++)
+    for (j = 0; j < PAGE_SIZE; j++)
+      if (pages[i][j] != (j == i ? 'a' + (char) (i % 26) : 'k'))
+        fail ("byte %zu of page %zu is 0x%02x", j, i, pages[i][j] & 0xff);
+  msg ("data matches");
+}
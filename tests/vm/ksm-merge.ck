@@ -0,0 +1,25 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+
+our ($test);
+my (@output) = read_text_file ("$test.output");
+common_checks ("run", @output);
+
+my ($merged, $unmerged)
+  = map (/^KSM: \d+ pages scanned \(\d+\/s\), (\d+) merged, (\d+) unmerged/,
+	 @output);
+fail "missing KSM statistics\n" if !defined $unmerged;
+fail "only $merged pages merged\n" if $merged < 48;
+fail "only $unmerged pages unmerged\n" if $unmerged < 48;
+compare_output ("run", \@output, [<<'EOF']);
+(ksm-merge) begin
+(ksm-merge) fill 64 pages
+(ksm-merge) identical pages merged
+(ksm-merge) writes unmerge the pages
+(ksm-merge) data matches
+(ksm-merge) end
+ksm-merge: exit(0)
+EOF
+pass;
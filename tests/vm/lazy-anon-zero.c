@@ -0,0 +1,44 @@
+/* Reads every page of a large bss array, then writes one byte to
+   each.  The reads must all map the shared zero frame and leave
+   the resident set alone; only the writes may give the pages
+   frames of their own. */
+
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_SIZE 4096
+#define PAGE_CNT 64
+
+static char zeros[PAGE_CNT * PAGE_SIZE];
+
+void
+test_main (void)
+{
+  struct memstat before, after;
+  size_t i;
+
+  memstat (&before);
+  for (i = 0; i < sizeof zeros; i++)
+    if (zeros[i] != 0)
+      fail ("byte %zu is 0x%02x", i, zeros[i] & 0xff);
+  memstat (&after);
+  if (after.rss - before.rss >= PAGE_CNT / 4)
+    fail ("reading %d zero pages took %lld frames",
+          PAGE_CNT, after.rss - before.rss);
+  msg ("reads share the zero page");
+
+  memstat (&before);
+  for (i = 0; i < PAGE_CNT; i++)
+    zeros[i * PAGE_SIZE] = i + 1;
+  memstat (&after);
+  if (after.rss - before.rss < PAGE_CNT)
+    fail ("writing %d zero pages took only %lld frames",
+          PAGE_CNT, after.rss - before.rss);
+  msg ("writes get frames of their own");
+
+  for (i = 0; i < sizeof zeros; i++)
+    if (zeros[i] != (i % PAGE_SIZE == 0 ? (char) (i / PAGE_SIZE + 1) : 0))
+      fail ("byte %zu is 0x%02x after writes", i, zeros[i] & 0xff);
+  msg ("data matches");
+}
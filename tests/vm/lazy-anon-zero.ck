@@ -0,0 +1,24 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+
+our ($test);
+my (@output) = read_text_file ("$test.output");
+common_checks ("run", @output);
+
+my ($shared, $copied)
+  = map (/^Zero page: (\d+) read faults shared, (\d+) copied on write/,
+	 @output);
+fail "missing zero page statistics\n" if !defined $copied;
+fail "only $shared read faults mapped the zero page\n" if $shared < 64;
+fail "only $copied writes broke the sharing\n" if $copied < 64;
+compare_output ("run", \@output, [<<'EOF']);
+(lazy-anon-zero) begin
+(lazy-anon-zero) reads share the zero page
+(lazy-anon-zero) writes get frames of their own
+(lazy-anon-zero) data matches
+(lazy-anon-zero) end
+lazy-anon-zero: exit(0)
+EOF
+pass;
@@ -0,0 +1,35 @@
+/* Reads every page of a large read-only array in the program's own
+   file, which is loaded lazily.  Fault-around and readahead must
+   load the pages in batches, so that the scan takes at most a tenth
+   as many page faults as there are pages. */
+
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_CNT 128
+#define SIZE (PAGE_CNT * 4096)
+
+static const char data[SIZE] = {1, 2, 3};
+
+void
+test_main (void)
+{
+  struct memstat before, after;
+  volatile char sink = 0;
+  long long faults;
+  int i;
+
+  memstat (&before);
+  for (i = 0; i < SIZE; i += 4096)
+    sink += data[i];
+  memstat (&after);
+
+  faults = (after.minor_faults + after.major_faults)
+           - (before.minor_faults + before.major_faults);
+  if (faults * 10 > PAGE_CNT)
+    fail ("reading %d pages took %lld faults", PAGE_CNT, faults);
+  msg ("read %d pages in at most %d faults", PAGE_CNT, PAGE_CNT / 10);
+  CHECK (data[0] == 1 && data[2] == 3 && data[SIZE - 1] == 0,
+         "data matches");
+}
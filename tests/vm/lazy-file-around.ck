@@ -0,0 +1,12 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(lazy-file-around) begin
+(lazy-file-around) read 128 pages in at most 12 faults
+(lazy-file-around) data matches
+(lazy-file-around) end
+lazy-file-around: exit(0)
+EOF
+pass;
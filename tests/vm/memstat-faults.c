@@ -0,0 +1,69 @@
+/* Checks the resident set and fault counters that memstat()
+   returns.  Writing fresh anonymous pages must add them to the
+   resident set with minor faults, or with prefetching; reading a
+   file mapping must take major faults; unmapping it must give the
+   frames back. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_SIZE 4096
+#define ANON_CNT 32
+#define FILE_CNT 4
+#define ACTUAL ((char *) 0x10000000)
+
+static char anon[ANON_CNT][PAGE_SIZE];
+static char buf[FILE_CNT * PAGE_SIZE];
+
+void
+test_main (void)
+{
+  struct memstat before, after;
+  int handle;
+  size_t i;
+
+  memstat (&before);
+  for (i = 0; i < ANON_CNT; i++)
+    anon[i][0] = 1;
+  memstat (&after);
+  if (after.rss - before.rss < ANON_CNT)
+    fail ("rss grew by %lld pages, not %d", after.rss - before.rss, ANON_CNT);
+  if ((after.minor_faults - before.minor_faults)
+      + (after.prefetched - before.prefetched) < ANON_CNT)
+    fail ("%lld minor faults and %lld prefetched pages for %d pages",
+          after.minor_faults - before.minor_faults,
+          after.prefetched - before.prefetched, ANON_CNT);
+  if (after.major_faults != before.major_faults)
+    fail ("fresh anonymous pages took major faults");
+  msg ("anonymous writes counted");
+
+  memset (buf, 'm', sizeof buf);
+  CHECK (create ("counted", sizeof buf), "create \"counted\"");
+  CHECK ((handle = open ("counted")) > 1, "open \"counted\"");
+  CHECK (write (handle, buf, sizeof buf) == sizeof buf,
+         "write \"counted\"");
+  CHECK (mmap (ACTUAL, sizeof buf, 1, handle, 0) != MAP_FAILED,
+         "mmap \"counted\"");
+
+  memstat (&before);
+  for (i = 0; i < FILE_CNT; i++)
+    if (ACTUAL[i * PAGE_SIZE] != 'm')
+      fail ("mapped page %zu does not match the file", i);
+  memstat (&after);
+  if (after.major_faults - before.major_faults < FILE_CNT)
+    fail ("%lld major faults for %d file pages",
+          after.major_faults - before.major_faults, FILE_CNT);
+  if (after.rss - before.rss < FILE_CNT)
+    fail ("rss grew by %lld pages, not %d", after.rss - before.rss, FILE_CNT);
+  msg ("file reads counted");
+
+  munmap (ACTUAL);
+  memstat (&before);
+  if (after.rss - before.rss < FILE_CNT)
+    fail ("munmap freed %lld pages, not %d",
+          after.rss - before.rss, FILE_CNT);
+  msg ("munmap counted");
+  close (handle);
+}
@@ -0,0 +1,17 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(memstat-faults) begin
+(memstat-faults) anonymous writes counted
+(memstat-faults) create "counted"
+(memstat-faults) open "counted"
+(memstat-faults) write "counted"
+(memstat-faults) mmap "counted"
+(memstat-faults) file reads counted
+(memstat-faults) munmap counted
+(memstat-faults) end
+memstat-faults: exit(0)
+EOF
+pass;
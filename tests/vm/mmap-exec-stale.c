@@ -0,0 +1,51 @@
+/* Runs a program, so that its read-only pages stay behind in the
+   page index after it exits, then overwrites the program file and
+   maps it read-only.  The mapping must show the new contents, not
+   the frames left behind. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define ACTUAL ((void *) 0x10000000)
+#define FILL 0x5a
+
+void
+test_main (void)
+{
+  char block[4096];
+  const char *map;
+  int handle, size, ofs;
+  pid_t pid;
+
+  pid = fork ("child-quick");
+  if (pid == 0)
+    {
+      exec ("child-quick");
+      exit (-1);
+    }
+  CHECK (wait (pid) == 0, "run \"child-quick\"");
+
+  CHECK ((handle = open ("child-quick")) > 1, "open \"child-quick\"");
+  size = filesize (handle);
+  memset (block, FILL, sizeof block);
+  for (ofs = 0; ofs < size; ofs += sizeof block)
+    {
+      int chunk = size - ofs < (int) sizeof block ? size - ofs
+                                                  : (int) sizeof block;
+      if (write (handle, block, chunk) != chunk)
+        fail ("write at offset %d failed", ofs);
+    }
+  msg ("overwrite \"child-quick\"");
+
+  CHECK ((map = mmap (ACTUAL, size, 0, handle, 0)) != MAP_FAILED,
+         "mmap \"child-quick\" with writable=0");
+  for (ofs = 0; ofs < size; ofs++)
+    if (map[ofs] != FILL)
+      fail ("byte %d of mapping is 0x%02x, not 0x%02x",
+            ofs, map[ofs] & 0xff, FILL);
+  msg ("mapping shows the new contents");
+  munmap ((void *) map);
+  close (handle);
+}
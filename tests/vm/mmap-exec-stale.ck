@@ -0,0 +1,16 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(mmap-exec-stale) begin
+child-quick: exit(0)
+(mmap-exec-stale) run "child-quick"
+(mmap-exec-stale) open "child-quick"
+(mmap-exec-stale) overwrite "child-quick"
+(mmap-exec-stale) mmap "child-quick" with writable=0
+(mmap-exec-stale) mapping shows the new contents
+(mmap-exec-stale) end
+mmap-exec-stale: exit(0)
+EOF
+pass;
@@ -0,0 +1,58 @@
+/* Writes to every page of a file mapping and calls
+   madvise(MADV_DONTNEED) on it.  The pages must leave memory
+   right away, the data written must reach the file, and reading
+   the mapping again must fault the data back in from the file. */
+
+#include <mman.h>
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_CNT 8
+#define SIZE (PAGE_CNT * 4096)
+#define ACTUAL ((char *) 0x10000000)
+
+static char buf[SIZE];
+
+void
+test_main (void)
+{
+  struct memstat before, after;
+  int handle;
+  int i;
+
+  CHECK (create ("dontneed", SIZE), "create \"dontneed\"");
+  CHECK ((handle = open ("dontneed")) > 1, "open \"dontneed\"");
+  CHECK (mmap (ACTUAL, SIZE, 1, handle, 0) != MAP_FAILED,
+         "mmap \"dontneed\"");
+  for (i = 0; i < SIZE; i++)
+    ACTUAL[i] = 'a' + i % 26;
+
+  memstat (&before);
+  CHECK (madvise (ACTUAL, SIZE, MADV_DONTNEED) == 0,
+         "madvise (MADV_DONTNEED)");
+  memstat (&after);
+  if (before.rss - after.rss < PAGE_CNT)
+    fail ("resident set shrank by %lld pages, not %d",
+          before.rss - after.rss, PAGE_CNT);
+  msg ("pages reclaimed");
+
+  CHECK (read (handle, buf, SIZE) == SIZE, "read \"dontneed\"");
+  for (i = 0; i < SIZE; i++)
+    if (buf[i] != 'a' + i % 26)
+      fail ("file byte %d is %d after write-back", i, buf[i]);
+  msg ("file holds the data written");
+
+  memstat (&before);
+  for (i = 0; i < SIZE; i++)
+    if (ACTUAL[i] != 'a' + i % 26)
+      fail ("mapped byte %d is %d after reclaim", i, ACTUAL[i]);
+  memstat (&after);
+  if (after.major_faults == before.major_faults)
+    fail ("pages came back without reading the file");
+  msg ("mapping reads the data back from the file");
+
+  munmap (ACTUAL);
+  close (handle);
+}
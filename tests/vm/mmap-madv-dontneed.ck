@@ -0,0 +1,17 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(mmap-madv-dontneed) begin
+(mmap-madv-dontneed) create "dontneed"
+(mmap-madv-dontneed) open "dontneed"
+(mmap-madv-dontneed) mmap "dontneed"
+(mmap-madv-dontneed) madvise (MADV_DONTNEED)
+(mmap-madv-dontneed) pages reclaimed
+(mmap-madv-dontneed) read "dontneed"
+(mmap-madv-dontneed) file holds the data written
+(mmap-madv-dontneed) mapping reads the data back from the file
+(mmap-madv-dontneed) end
+EOF
+pass;
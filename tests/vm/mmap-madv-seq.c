@@ -0,0 +1,64 @@
+/* Maps two equally large parts of a file and reads every page of
+   each, the second after madvise(MADV_SEQUENTIAL).  The advice
+   must let the kernel read ahead, so that the scan takes fewer
+   page faults, and the data must still match the file. */
+
+#include <mman.h>
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_CNT 64
+#define SIZE (PAGE_CNT * 4096)
+#define PLAIN ((char *) 0x10000000)
+#define SEQ ((char *) 0x20000000)
+
+/* Reads every page of the SIZE bytes at MAP, which maps the file
+   open as HANDLE from offset OFS, checks the first bytes of each
+   against the file, and returns the page faults it took. */
+static long long
+scan (char *map, int handle, int ofs)
+{
+  struct memstat before, after;
+  static char buf[64];
+  volatile char sink = 0;
+  int i;
+
+  memstat (&before);
+  for (i = 0; i < SIZE; i += 4096)
+    sink += map[i];
+  memstat (&after);
+
+  for (i = 0; i < SIZE; i += 4096)
+    {
+      seek (handle, ofs + i);
+      if (read (handle, buf, sizeof buf) != sizeof buf
+          || memcmp (buf, map + i, sizeof buf))
+        fail ("data at offset %d differs from the file", ofs + i);
+    }
+  return (after.minor_faults + after.major_faults)
+         - (before.minor_faults + before.major_faults);
+}
+
+void
+test_main (void)
+{
+  long long plain, seq;
+  int handle;
+
+  CHECK ((handle = open ("large.txt")) > 1, "open \"large.txt\"");
+  CHECK (mmap (PLAIN, SIZE, 1, handle, 0) != MAP_FAILED,
+         "mmap \"large.txt\" at offset 0");
+  CHECK (mmap (SEQ, SIZE, 1, handle, SIZE) != MAP_FAILED,
+         "mmap \"large.txt\" at offset %d", SIZE);
+  CHECK (madvise (SEQ, SIZE, MADV_SEQUENTIAL) == 0,
+         "madvise (MADV_SEQUENTIAL)");
+
+  plain = scan (PLAIN, handle, 0);
+  seq = scan (SEQ, handle, SIZE);
+  if (seq >= plain)
+    fail ("sequential scan took %lld faults, plain scan %lld", seq, plain);
+  msg ("sequential scan took fewer faults");
+  close (handle);
+}
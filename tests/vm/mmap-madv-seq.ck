@@ -0,0 +1,14 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(mmap-madv-seq) begin
+(mmap-madv-seq) open "large.txt"
+(mmap-madv-seq) mmap "large.txt" at offset 0
+(mmap-madv-seq) mmap "large.txt" at offset 262144
+(mmap-madv-seq) madvise (MADV_SEQUENTIAL)
+(mmap-madv-seq) sequential scan took fewer faults
+(mmap-madv-seq) end
+EOF
+pass;
@@ -0,0 +1,48 @@
+/* Maps part of a file and calls madvise(MADV_WILLNEED) on it.
+   The pages must then be in memory, so that reading all of them
+   takes no fault that has to wait for the file. */
+
+#include <mman.h>
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_CNT 32
+#define SIZE (PAGE_CNT * 4096)
+#define ACTUAL ((char *) 0x10000000)
+
+void
+test_main (void)
+{
+  struct memstat before, after;
+  static char buf[64];
+  volatile char sink = 0;
+  int handle;
+  int i;
+
+  CHECK ((handle = open ("large.txt")) > 1, "open \"large.txt\"");
+  CHECK (mmap (ACTUAL, SIZE, 1, handle, 0) != MAP_FAILED,
+         "mmap \"large.txt\"");
+  CHECK (madvise (ACTUAL, SIZE, MADV_WILLNEED) == 0,
+         "madvise (MADV_WILLNEED)");
+
+  memstat (&before);
+  for (i = 0; i < SIZE; i += 4096)
+    sink += ACTUAL[i];
+  memstat (&after);
+  if (after.major_faults != before.major_faults)
+    fail ("reading the range took %lld major faults",
+          after.major_faults - before.major_faults);
+  msg ("no major faults after MADV_WILLNEED");
+
+  for (i = 0; i < SIZE; i += 4096)
+    {
+      seek (handle, i);
+      if (read (handle, buf, sizeof buf) != sizeof buf
+          || memcmp (buf, ACTUAL + i, sizeof buf))
+        fail ("data at offset %d differs from the file", i);
+    }
+  msg ("mapped data matches the file");
+  close (handle);
+}
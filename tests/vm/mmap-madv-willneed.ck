@@ -0,0 +1,14 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(mmap-madv-willneed) begin
+(mmap-madv-willneed) open "large.txt"
+(mmap-madv-willneed) mmap "large.txt"
+(mmap-madv-willneed) madvise (MADV_WILLNEED)
+(mmap-madv-willneed) no major faults after MADV_WILLNEED
+(mmap-madv-willneed) mapped data matches the file
+(mmap-madv-willneed) end
+EOF
+pass;
@@ -0,0 +1,42 @@
+/* Writes every third page of a large array, then reads the same
+   pages back.  Once the stride is detected, the fault handler must
+   load the pages ahead of the walk, so that it takes far fewer
+   faults than pages; the .ck checks that few of the prefetched
+   pages went unused. */
+
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_SIZE 4096
+#define STRIDE 3
+#define TOUCH_CNT 256
+
+static char pages[TOUCH_CNT * STRIDE][PAGE_SIZE];
+
+void
+test_main (void)
+{
+  struct memstat before, after;
+  long long faults;
+  size_t i;
+
+  memstat (&before);
+  for (i = 0; i < TOUCH_CNT; i++)
+    pages[i * STRIDE][0] = i + 1;
+  memstat (&after);
+  faults = (after.minor_faults + after.major_faults)
+           - (before.minor_faults + before.major_faults);
+  if (faults >= TOUCH_CNT / 2)
+    fail ("%d strided writes took %lld faults", TOUCH_CNT, faults);
+  if (after.prefetched - before.prefetched < TOUCH_CNT / 2)
+    fail ("only %lld pages prefetched",
+          after.prefetched - before.prefetched);
+  msg ("strided writes were prefetched");
+
+  for (i = 0; i < TOUCH_CNT; i++)
+    if (pages[i * STRIDE][0] != (char) (i + 1))
+      fail ("page %zu holds 0x%02x", i * STRIDE,
+            pages[i * STRIDE][0] & 0xff);
+  msg ("data matches");
+}
@@ -0,0 +1,22 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+
+our ($test);
+my (@output) = read_text_file ("$test.output");
+common_checks ("run", @output);
+
+my ($accuracy)
+  = map (/^Prefetch: \d+ pages, \d+ used, \d+ wasted \((\d+)% accurate\)/,
+	 @output);
+fail "missing prefetch statistics\n" if !defined $accuracy;
+fail "prefetching was only $accuracy% accurate\n" if $accuracy < 80;
+compare_output ("run", \@output, [<<'EOF']);
+(page-stride) begin
+(page-stride) strided writes were prefetched
+(page-stride) data matches
+(page-stride) end
+page-stride: exit(0)
+EOF
+pass;
@@ -0,0 +1,45 @@
+/* Touches the lowest byte of a 128 kB stack object first, many
+   pages below the bottom of the stack, then writes all of it.
+   The first fault must grow the stack down to that byte in one
+   batch, so that writing the rest takes few more faults. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/arc4.h"
+#include "tests/cksum.h"
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define OBJ_SIZE (128 * 1024)
+#define PAGE_CNT (OBJ_SIZE / 4096)
+
+/* Fills a stack object from its lowest byte up and returns the
+   page faults that took. */
+static long long
+fill_stack_object (void)
+{
+  struct memstat before, after;
+  char stk_obj[OBJ_SIZE];
+  struct arc4 arc4;
+
+  memstat (&before);
+  stk_obj[0] = 0;
+  memset (stk_obj, 0, sizeof stk_obj);
+  memstat (&after);
+
+  arc4_init (&arc4, "foobar", 6);
+  arc4_crypt (&arc4, stk_obj, sizeof stk_obj);
+  msg ("cksum: %lu", cksum (stk_obj, sizeof stk_obj));
+  return (after.minor_faults + after.major_faults)
+         - (before.minor_faults + before.major_faults);
+}
+
+void
+test_main (void)
+{
+  long long faults = fill_stack_object ();
+
+  if (faults >= PAGE_CNT / 2)
+    fail ("%d pages of stack took %lld faults", PAGE_CNT, faults);
+  msg ("stack grew in a batch");
+}
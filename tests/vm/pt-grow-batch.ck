@@ -0,0 +1,11 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(pt-grow-batch) begin
+(pt-grow-batch) cksum: 2791045504
+(pt-grow-batch) stack grew in a batch
+(pt-grow-batch) end
+EOF
+pass;
@@ -0,0 +1,51 @@
+/* Maps a page of a file 256 kB below the top of the stack.  A
+   64 kB stack object must fit, but a 240 kB one would leave less
+   than the guard gap between the stack and the mapping, so
+   touching it must kill the process with exit code -1. */
+
+#include <round.h>
+#include <stdint.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+/* Writes every byte of the SIZE bytes at BUF, lowest first. */
+static void
+touch (volatile char *buf, size_t size)
+{
+  size_t i;
+
+  for (i = 0; i < size; i++)
+    buf[i] = i;
+}
+
+static void
+small (void)
+{
+  char stk_obj[64 * 1024];
+
+  touch (stk_obj, sizeof stk_obj);
+}
+
+static void
+large (void)
+{
+  char stk_obj[240 * 1024];
+
+  touch (stk_obj, sizeof stk_obj);
+}
+
+void
+test_main (void)
+{
+  int handle;
+  uintptr_t stack_page = ROUND_DOWN ((uintptr_t) &handle, 4096);
+
+  CHECK ((handle = open ("sample.txt")) > 1, "open \"sample.txt\"");
+  CHECK (mmap ((void *) (stack_page - 256 * 1024), 4096, 0, handle, 0)
+         != MAP_FAILED, "mmap \"sample.txt\" 256 kB below the stack");
+  small ();
+  msg ("64 kB stack object fits");
+  large ();
+  fail ("240 kB stack object should have hit the guard gap");
+}
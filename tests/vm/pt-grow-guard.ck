@@ -0,0 +1,12 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_USER_FAULTS => 1, [<<'EOF']);
+(pt-grow-guard) begin
+(pt-grow-guard) open "sample.txt"
+(pt-grow-guard) mmap "sample.txt" 256 kB below the stack
+(pt-grow-guard) 64 kB stack object fits
+pt-grow-guard: exit(-1)
+EOF
+pass;
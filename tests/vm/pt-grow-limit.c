@@ -0,0 +1,42 @@
+/* Runs with the stack limited to 64 kB by "-stack=64".  A 32 kB
+   stack object must fit, but touching a 128 kB one must kill the
+   process with exit code -1. */
+
+#include <stddef.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+/* Writes every byte of the SIZE bytes at BUF, lowest first. */
+static void
+touch (volatile char *buf, size_t size)
+{
+  size_t i;
+
+  for (i = 0; i < size; i++)
+    buf[i] = i;
+}
+
+static void
+small (void)
+{
+  char stk_obj[32 * 1024];
+
+  touch (stk_obj, sizeof stk_obj);
+}
+
+static void
+large (void)
+{
+  char stk_obj[128 * 1024];
+
+  touch (stk_obj, sizeof stk_obj);
+}
+
+void
+test_main (void)
+{
+  small ();
+  msg ("32 kB stack object fits");
+  large ();
+  fail ("128 kB stack object should have exceeded the limit");
+}
@@ -0,0 +1,48 @@
+/* Recursion benchmark: recurses through 512 frames of about
+   1 kB each, growing the stack by about 512 kB, then checks that
+   every frame kept its contents.  Reports the time taken and the
+   page faults taken. */
+
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define DEPTH 512
+#define FRAME_SIZE 1000
+
+/* Recurses DEPTH levels deep and returns the number of frames
+   whose contents survived. */
+static int
+recurse (int depth)
+{
+  volatile char frame[FRAME_SIZE];
+  int good;
+  int i;
+
+  for (i = 0; i < FRAME_SIZE; i++)
+    frame[i] = depth + i;
+  good = depth > 0 ? recurse (depth - 1) : 0;
+  for (i = 0; i < FRAME_SIZE; i++)
+    if (frame[i] != (char) (depth + i))
+      return good;
+  return good + 1;
+}
+
+void
+test_main (void)
+{
+  struct memstat before, after;
+  int64_t start, us;
+  int good;
+
+  memstat (&before);
+  start = vdso_time_us ();
+  good = recurse (DEPTH - 1);
+  us = vdso_time_us () - start;
+  memstat (&after);
+
+  CHECK (good == DEPTH, "all %d frames intact", DEPTH);
+  msg ("recursion: %lld us, %lld faults", (long long) us,
+       (after.minor_faults + after.major_faults)
+       - (before.minor_faults + before.major_faults));
+}
@@ -0,0 +1,18 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+
+our ($test);
+my (@output) = read_text_file ("$test.output");
+common_checks ("run", @output);
+
+fail "missing timing line\n"
+  unless grep (/^\(pt-grow-recurse\) recursion: \d+ us, \d+ faults$/, @output);
+@output = grep (!/^\(pt-grow-recurse\) recursion: /, @output);
+compare_output ("run", IGNORE_EXIT_CODES => 1, \@output, [<<'EOF']);
+(pt-grow-recurse) begin
+(pt-grow-recurse) all 512 frames intact
+(pt-grow-recurse) end
+EOF
+pass;
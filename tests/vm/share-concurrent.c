@@ -0,0 +1,72 @@
+/* Runs several instances of one program at the same time.  While
+   they all run, each one's read-only data must be mapped to the
+   same frames as every other's. */
+
+#include <stdio.h>
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+#include "tests/vm/share.h"
+
+#define CHILD_CNT 4
+
+/* Reads SIZE bytes from FD into BUF, failing on a short read. */
+static void
+read_all (int fd, void *buf_, size_t size)
+{
+  char *buf = buf_;
+
+  while (size > 0)
+    {
+      int n = read (fd, buf, size);
+      if (n <= 0)
+        fail ("read from child failed");
+      buf += n;
+      size -= n;
+    }
+}
+
+void
+test_main (void)
+{
+  void *addrs[CHILD_CNT][SHARE_PAGE_CNT];
+  int results[CHILD_CNT][2];
+  int release[2];
+  pid_t pids[CHILD_CNT];
+  int i, j;
+
+  CHECK (pipe (release) == 0, "pipe");
+  for (i = 0; i < CHILD_CNT; i++)
+    {
+      char cmd[64];
+
+      if (pipe (results[i]) != 0)
+        fail ("pipe for child %d failed", i);
+      pids[i] = fork ("child-share");
+      if (pids[i] == 0)
+        {
+          close (release[1]);
+          snprintf (cmd, sizeof cmd, "child-share %d %d",
+                    results[i][1], release[0]);
+          exec (cmd);
+          exit (-1);
+        }
+    }
+  msg ("start %d children", CHILD_CNT);
+
+  for (i = 0; i < CHILD_CNT; i++)
+    read_all (results[i][0], addrs[i], sizeof addrs[i]);
+  for (i = 1; i < CHILD_CNT; i++)
+    for (j = 0; j < SHARE_PAGE_CNT; j++)
+      if (addrs[i][j] != addrs[0][j])
+        fail ("page %d of child %d is at %p, of child 0 at %p",
+              j, i, addrs[i][j], addrs[0][j]);
+  msg ("all children map the same frames");
+
+  close (release[1]);
+  for (i = 0; i < CHILD_CNT; i++)
+    if (wait (pids[i]) != 0)
+      fail ("child %d failed", i);
+  msg ("children exited");
+}
@@ -0,0 +1,18 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(share-concurrent) begin
+(share-concurrent) pipe
+(share-concurrent) start 4 children
+(share-concurrent) all children map the same frames
+child-share: exit(0)
+child-share: exit(0)
+child-share: exit(0)
+child-share: exit(0)
+(share-concurrent) children exited
+(share-concurrent) end
+share-concurrent: exit(0)
+EOF
+pass;
@@ -0,0 +1,7 @@
+#ifndef TESTS_VM_SHARE_H
+#define TESTS_VM_SHARE_H 1
+
+/* Pages in the read-only table of child-share. */
+#define SHARE_PAGE_CNT 16
+
+#endif /* tests/vm/share.h */
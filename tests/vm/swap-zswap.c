@@ -0,0 +1,45 @@
+/* Writes compressible data to more anonymous memory than fits in
+   the user pool, then reads it all back.  Evicted pages must go
+   to the compressed pool first, and swapping them back in must
+   find them there: the .ck checks the swap statistics printed at
+   power off. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_SIZE 4096
+#define PAGE_CNT 1536
+
+static char pages[PAGE_CNT][PAGE_SIZE];
+
+/* Returns the byte that fills page I.  Never zero, so that the
+   page is stored compressed rather than as a zero page. */
+static char
+fill_byte (size_t i)
+{
+  return i % 251 + 1;
+}
+
+void
+test_main (void)
+{
+  struct memstat stat;
+  size_t i, j;
+
+  for (i = 0; i < PAGE_CNT; i++)
+    memset (pages[i], fill_byte (i), PAGE_SIZE);
+  msg ("write %d pages", PAGE_CNT);
+
+  memstat (&stat);
+  if (stat.swapped == 0)
+    fail ("no page was swapped out");
+  msg ("some pages were swapped out");
+
+  for (i = 0; i < PAGE_CNT; i++)
+    for (j = 0; j < PAGE_SIZE; j++)
+      if (pages[i][j] != fill_byte (i))
+        fail ("byte %zu of page %zu is 0x%02x", j, i, pages[i][j] & 0xff);
+  msg ("read back %d pages", PAGE_CNT);
+}
@@ -0,0 +1,23 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+
+our ($test);
+my (@output) = read_text_file ("$test.output");
+common_checks ("run", @output);
+
+my ($compressed) = map (/^Swap: \d+ zero, (\d+) compressed/, @output);
+fail "missing swap statistics\n" if !defined $compressed;
+fail "no page was compressed into the pool\n" if $compressed == 0;
+my ($hits) = map (/^Swap: (\d+) zswap swap-ins/, @output);
+fail "no page was swapped in from the pool\n" if !defined $hits;
+compare_output ("run", \@output, [<<'EOF']);
+(swap-zswap) begin
+(swap-zswap) write 1536 pages
+(swap-zswap) some pages were swapped out
+(swap-zswap) read back 1536 pages
+(swap-zswap) end
+swap-zswap: exit(0)
+EOF
+pass;
@@ -21,16 +21,21 @@
 #include "threads/palloc.h"
 #include "threads/pte.h"
 #include "threads/thread.h"
+#include "intrinsic.h"
 #ifdef USERPROG
 #include "userprog/process.h"
+#include "userprog/aio.h"
 #include "userprog/exception.h"
 #include "userprog/gdt.h"
 #include "userprog/syscall.h"
 #include "userprog/tss.h"
+#include "userprog/uaccess.h"
 #endif
 #include "tests/threads/tests.h"
 #ifdef VM
 #include "vm/vm.h"
+#include "vm/zswap.h"
+#include "vm/ksm.h"
 #endif
 #ifdef FILESYS
 #include "devices/disk.h"
@@ -38,6 +43,9 @@
 #include "filesys/fsutil.h"
 #endif
 
+/* Write-Protect enable in kernel mode (CR0). */
+#define CR0_WP 0x00010000
+
 /* Page-map-level-4 with kernel mappings only. */
 uint64_t *base_pml4;
 
@@ -165,6 +173,13 @@ paging_init (uint64_t mem_end) {
 
 	// reload cr3
 	pml4_activate(0);
+
+#ifdef VM
+	/* Let the kernel fault on read-only user pages as well, so that a
+	 * system call writing into a page that shares the zero frame takes
+	 * its own copy instead of scribbling over the shared one. */
+	lcr0 (rcr0 () | CR0_WP);
+#endif
 }
 
 /* Breaks the kernel command line into words and returns them as
@@ -226,6 +241,18 @@ parse_options (char **argv) {
 			user_page_limit = atoi (value);
 		else if (!strcmp (name, "-threads-tests"))
 			thread_tests = true;
+#endif
+#ifdef VM
+		else if (!strcmp (name, "-zswap"))
+			zswap_pool_limit = atoi (value);
+		else if (!strcmp (name, "-ksm"))
+			ksm_scan_rate = atoi (value);
+		else if (!strcmp (name, "-wss"))
+			vm_ws_sample_ticks = atoi (value);
+		else if (!strcmp (name, "-stack"))
+			vm_stack_limit = (size_t) atoi (value) * 1024;
+		else if (!strcmp (name, "-memstat"))
+			vm_usage_dump = true;
 #endif
 		else
 			PANIC ("unknown option `%s' (use -h for help)", name);
@@ -328,6 +355,13 @@ usage (void) {
 			"  -mlfqs             Use multi-level feedback queue scheduler.\n"
 #ifdef USERPROG
 			"  -ul=COUNT          Limit user memory to COUNT pages.\n"
+#endif
+#ifdef VM
+			"  -zswap=PAGES       Compress swapped pages into PAGES pages, 0 disables.\n"
+			"  -ksm=PAGES         Merge identical pages, scanning PAGES pages/s.\n"
+			"  -wss=TICKS         Sample working sets every TICKS timer ticks.\n"
+			"  -stack=KB          Limit user stacks to KB kB (default 1024).\n"
+			"  -memstat           Print each process's memory usage on exit.\n"
 #endif
 			);
 	power_off ();
@@ -361,5 +395,12 @@ print_stats (void) {
 	kbd_print_stats ();
 #ifdef USERPROG
 	exception_print_stats ();
+	uaccess_print_stats ();
+	aio_print_stats ();
+	process_print_stats ();
+	syscall_print_stats ();
+#endif
+#ifdef VM
+	vm_print_stats ();
 #endif
 }
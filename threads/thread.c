@@ -7,6 +7,7 @@
 #include "threads/flags.h"
 #include "threads/interrupt.h"
 #include "threads/intr-stubs.h"
+#include "threads/malloc.h"
 #include "threads/palloc.h"
 #include "threads/synch.h"
 #include "threads/vaddr.h"
@@ -86,6 +87,7 @@ static void init_thread (struct thread *, const char *name, int priority);
 static void do_schedule(int status);
 static void schedule (void);
 static tid_t allocate_tid (void);
+static void child_records_exit (void);
 
 /* Returns true if T appears to point to a valid thread. */
 #define is_thread(t) ((t) != NULL && (t)->magic == THREAD_MAGIC)
@@ -151,6 +153,9 @@ thread_start (void) {
 	/* Create the idle thread. */
 	struct semaphore idle_started;
 	sema_init (&idle_started, 0);
+	/* 자식 기록 테이블은 malloc 을 쓰므로 여기서 초기화 */
+	if (!child_table_init (initial_thread))
+		PANIC ("child table");
 	thread_create ("idle", PRI_MIN, idle, &idle_started);
 	
 	/* Start preemptive thread scheduling. */
@@ -223,18 +228,37 @@ thread_create (const char *name, int priority,
 	tid = t->tid = allocate_tid ();
 
 	/* Project 2 : system call 관련 추가 */
-	/* add new thread 't' into current thread's child_list */
+	/* 자식 기록을 만들어서 current thread's children 에 추가 */
 	struct thread *curr = thread_current();
-	list_push_back(&curr->child_list, &t->child_elem);
-	// File Descriptor Table 메모리 할당 // palloc이나 malloc?
-	t->fd_table = palloc_get_multiple(PAL_ZERO, FDT_PAGES);
-	if(t->fd_table == NULL)
+	struct child *rec = malloc(sizeof *rec);
+	if (rec == NULL){
+		palloc_free_page(t);
 		return TID_ERROR;
-	t->fd_idx = 2; // 0 : stdin, 1: stdout
+	}
+	rec->tid = tid;
+	rec->exit_status = 0;
+	rec->ref_cnt = 2; // 부모와 자식이 하나씩
+	sema_init(&rec->fork_sema, 0);
+	sema_init(&rec->exit_sema, 0);
+	rec->parent = curr;
+	// File Descriptor Table 메모리 할당: 작게 시작해서 필요할 때 늘림
+	if(!child_table_init(t)){
+		free(rec);
+		palloc_free_page(t);
+		return TID_ERROR;
+	}
+	if(!fd_table_init(t, FD_TABLE_MIN)){
+		hash_destroy(&t->children, NULL);
+		free(rec);
+		palloc_free_page(t);
+		return TID_ERROR;
+	}
+	hash_insert(&curr->children, &rec->elem);
+	t->child_rec = rec;
 
 	// /* project 2 : Extra */
-	t->fd_table[0] = 1; // dummy value : 0이 아니라 1을 주는 이유: 0을 주면, fd_table[fd]==NULL 을 확인할 때 걸릴 수 있음
-	t->fd_table[1] = 2; // dummy value : 같은 맥락에서 여긴 2로 줌 
+	fd_table_set(t, 0, (struct file *) 1); // dummy value : 0이 아니라 1을 주는 이유: 0을 주면, fd_table[fd]==NULL 을 확인할 때 걸릴 수 있음
+	fd_table_set(t, 1, (struct file *) 2); // dummy value : 같은 맥락에서 여긴 2로 줌 
 	t->stdin_count = 1;
 	t->stdout_count = 1;
 
@@ -334,6 +358,7 @@ thread_exit (void) {
 #ifdef USERPROG
 	process_exit ();
 #endif
+	child_records_exit ();
 
 	/* Just set our status to dying and schedule another process.
 	   We will be destroyed during the call to schedule_tail(). */
@@ -690,10 +715,9 @@ init_thread (struct thread *t, const char *name, int priority) {
 	t->nice = NICE_DEFAULT;
 	t->recent_cpu = RECENT_CPU_DEFAULT;
 
-	list_init(&t->child_list);
-	sema_init(&t->wait_sema,0);
-	sema_init(&t->fork_sema,0);
-	sema_init(&t->free_sema,0);
+	list_init(&t->exited_children);
+	sema_init(&t->child_exit_sema, 0);
+	t->child_rec = NULL;
 
 	if(t!= idle_thread){
 		list_push_back (&all_list, &t->all_elem);
@@ -880,4 +904,198 @@ allocate_tid (void) {
 	lock_release (&tid_lock);
 
 	return tid;
-}
\ No newline at end of file
+}
+
+/* File descriptor table.  fd_table has fd_cap slots and is followed, in
+ * the same block, by the fd_used bitmap with one bit per slot, so that
+ * the lowest free fd and the live fds are found a word at a time. */
+
+#define FD_WORD_BITS 64
+
+/* Gives T an empty table of CAP slots, a multiple of FD_WORD_BITS. */
+bool
+fd_table_init (struct thread *t, int cap) {
+	size_t words = cap / FD_WORD_BITS;
+
+	ASSERT (cap % FD_WORD_BITS == 0 && cap <= FDCOUNT_LIMIT);
+
+	t->fd_table = calloc (1, cap * sizeof *t->fd_table
+			+ words * sizeof *t->fd_used);
+	if (t->fd_table == NULL)
+		return false;
+	t->fd_used = (uint64_t *) (t->fd_table + cap);
+	t->fd_cap = cap;
+	t->fd_cnt = 0;
+	return true;
+}
+
+/* Grows T's table so that it has a slot for FD.  Returns false if FD is
+ * beyond FDCOUNT_LIMIT or memory is short. */
+bool
+fd_table_reserve (struct thread *t, int fd) {
+	struct file **old_table = t->fd_table;
+	uint64_t *old_used = t->fd_used;
+	int old_cap = t->fd_cap;
+	int old_cnt = t->fd_cnt;
+	int cap = old_cap;
+
+	if (fd < 0 || fd >= FDCOUNT_LIMIT)
+		return false;
+	if (fd < old_cap)
+		return true;
+	while (cap <= fd)
+		cap *= 2;
+	if (cap > FDCOUNT_LIMIT)
+		cap = FDCOUNT_LIMIT;
+
+	if (!fd_table_init (t, cap)) {
+		t->fd_table = old_table;
+		t->fd_used = old_used;
+		t->fd_cap = old_cap;
+		return false;
+	}
+	memcpy (t->fd_table, old_table, old_cap * sizeof *old_table);
+	memcpy (t->fd_used, old_used, old_cap / FD_WORD_BITS * sizeof *old_used);
+	t->fd_cnt = old_cnt;
+	free (old_table);
+	return true;
+}
+
+/* Frees T's table. */
+void
+fd_table_destroy (struct thread *t) {
+	free (t->fd_table);
+	t->fd_table = NULL;
+	t->fd_used = NULL;
+	t->fd_cap = t->fd_cnt = 0;
+}
+
+/* Puts F in slot FD of T's table, which must exist, or empties the slot
+ * if F is a null pointer. */
+void
+fd_table_set (struct thread *t, int fd, struct file *f) {
+	uint64_t bit = 1ULL << (fd % FD_WORD_BITS);
+	uint64_t *word = &t->fd_used[fd / FD_WORD_BITS];
+
+	ASSERT (fd >= 0 && fd < t->fd_cap);
+
+	t->fd_table[fd] = f;
+	if (f != NULL && !(*word & bit)) {
+		*word |= bit;
+		t->fd_cnt++;
+	} else if (f == NULL && (*word & bit)) {
+		*word &= ~bit;
+		t->fd_cnt--;
+	}
+}
+
+/* Returns the lowest fd that T does not use, growing the table if it is
+ * full, or -1 if there is none. */
+int
+fd_table_first_free (struct thread *t) {
+	int fd = t->fd_cap;
+
+	for (int i = 0; i < t->fd_cap / FD_WORD_BITS; i++)
+		if (~t->fd_used[i] != 0) {
+			fd = i * FD_WORD_BITS + __builtin_ctzll (~t->fd_used[i]);
+			break;
+		}
+	return fd_table_reserve (t, fd) ? fd : -1;
+}
+
+/* Returns the lowest live fd of T that is at least FD, or -1. */
+int
+fd_table_next (struct thread *t, int fd) {
+	for (int i = fd / FD_WORD_BITS; i < t->fd_cap / FD_WORD_BITS; i++) {
+		uint64_t word = t->fd_used[i];
+
+		if (i == fd / FD_WORD_BITS)
+			word &= ~0ULL << (fd % FD_WORD_BITS);
+		if (word != 0)
+			return i * FD_WORD_BITS + __builtin_ctzll (word);
+	}
+	return -1;
+}
+
+/* 자식 기록 관련 */
+static uint64_t
+child_hash (const struct hash_elem *e, void *aux UNUSED) {
+	const struct child *rec = hash_entry (e, struct child, elem);
+
+	return hash_int (rec->tid);
+}
+
+static bool
+child_less (const struct hash_elem *a, const struct hash_elem *b,
+		void *aux UNUSED) {
+	return hash_entry (a, struct child, elem)->tid
+		< hash_entry (b, struct child, elem)->tid;
+}
+
+/* T 의 자식 기록 테이블을 초기화 */
+bool
+child_table_init (struct thread *t) {
+	return hash_init (&t->children, child_hash, child_less, NULL);
+}
+
+/* REC 를 놓음.  부모와 자식이 모두 놓으면 해제 */
+void
+child_release (struct child *rec) {
+	enum intr_level old_level = intr_disable ();
+	bool last = --rec->ref_cnt == 0;
+
+	intr_set_level (old_level);
+	if (last)
+		free (rec);
+}
+
+/* 부모가 자식 기록 REC 를 놓음: 아직 살아있는 자식은 더 이상 부모에게
+ * 종료를 알리지 않음 */
+static void
+child_orphan (struct hash_elem *e, void *aux UNUSED) {
+	struct child *rec = hash_entry (e, struct child, elem);
+	enum intr_level old_level = intr_disable ();
+
+	rec->parent = NULL;
+	intr_set_level (old_level);
+	child_release (rec);
+}
+
+/* 아무도 기다리지 않을 자식 TID (커널 데몬 등) 의 기록을 지금 놓음 */
+void
+child_disown (tid_t tid) {
+	struct thread *curr = thread_current ();
+	struct child key;
+	struct hash_elem *e;
+
+	key.tid = tid;
+	e = hash_delete (&curr->children, &key.elem);
+	if (e != NULL)
+		child_orphan (e, NULL);
+}
+
+/* 종료하는 스레드의 기록 정리: 자식 기록은 모두 놓고 (자식이 아직 살아있으면
+ * 자식이 끝날 때 해제됨), 부모가 가진 나의 기록에 종료 상태를 남기고 부모의
+ * exited_children 에 넣음.  부모를 기다리지 않으므로 스레드 페이지는 바로
+ * destruction_req 로 해제됨 */
+static void
+child_records_exit (void) {
+	struct thread *curr = thread_current ();
+	struct child *rec = curr->child_rec;
+	enum intr_level old_level;
+
+	hash_destroy (&curr->children, child_orphan);
+	if (rec != NULL) {
+		curr->child_rec = NULL;
+		rec->exit_status = curr->exit_status;
+		/* 부모가 그 사이에 끝나지 않도록 인터럽트를 끄고 알림 */
+		old_level = intr_disable ();
+		if (rec->parent != NULL) {
+			list_push_back (&rec->parent->exited_children, &rec->exit_elem);
+			sema_up (&rec->parent->child_exit_sema);
+		}
+		intr_set_level (old_level);
+		sema_up (&rec->exit_sema);
+		child_release (rec);
+	}
+}
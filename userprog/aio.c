@@ -0,0 +1,435 @@
+/* aio.c: Batched asynchronous file I/O.
+ *
+ * A process registers a ring in its own memory (see lib/aio.h) and queues
+ * operations in it.  aio_enter() takes the queued operations out of the
+ * ring in the process's own context, where the user memory and the file
+ * descriptors can be reached: it copies the data of writes and the names
+ * of files to open into kernel memory, and gives every read or write a
+ * private handle on the file, so that the worker never touches the
+ * process's address space or descriptor table and the process may close
+ * the descriptor meanwhile.  The requests then go to a single kernel
+ * worker thread, which carries out whatever is queued at once, taking the
+ * file system lock once per batch instead of once per operation.
+ *
+ * Finished requests wait on their process's context until its next
+ * aio_enter(), which copies the data of reads out to user memory,
+ * installs the files that were opened and fills in the completion queue.
+ * The number of requests a process has outstanding is bounded by the size
+ * of the completion queue, so every completion has a slot to go to. */
+
+#include "userprog/aio.h"
+#include <debug.h>
+#include <list.h>
+#include <stdio.h>
+#include <string.h>
+#include "filesys/file.h"
+#include "filesys/filesys.h"
+#include "threads/malloc.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+#include "userprog/syscall.h"
+#include "userprog/uaccess.h"
+
+/* Longest file name AIO_OPEN takes, including the null terminator. */
+#define AIO_NAME_MAX 64
+
+/* Per-process state. */
+struct aio_ctx {
+	struct aio_ring *ring;      /* User address of the ring. */
+	unsigned sq_head;           /* Kernel copy of ring->sq_head. */
+	unsigned cq_tail;           /* Kernel copy of ring->cq_tail. */
+	int pending;                /* Taken from the ring, not yet posted. */
+
+	struct lock lock;           /* Protects the members below. */
+	struct condition done_cond; /* Signaled when a request finishes. */
+	struct list done;           /* Finished requests, not yet posted. */
+	int inflight;               /* Requests the worker still has. */
+};
+
+/* One operation. */
+struct aio_req {
+	struct list_elem elem;      /* In work_queue, then in ctx->done. */
+	struct aio_ctx *ctx;        /* Submitting process. */
+	struct aio_sqe sqe;         /* Copy of the submission. */
+	struct file *file;          /* File to use, or the file opened. */
+	bool console;               /* Write to the console? */
+	void *buf;                  /* Kernel buffer, or name to open. */
+	int res;                    /* Result. */
+};
+
+static struct list work_queue;      /* Requests for the worker. */
+static struct lock work_lock;       /* Protects work_queue. */
+static struct condition work_cond;  /* Signaled when work is queued. */
+static bool worker_started;         /* Worker thread created? */
+
+/* Statistics. */
+static long long op_cnt;            /* Operations carried out. */
+static long long batch_cnt;         /* Batches the worker took. */
+
+/* Console entries of the file descriptor table, see syscall.c. */
+static bool
+is_console (struct file *f) {
+	return (uintptr_t) f <= 2;
+}
+
+/* Carries out REQ.  Called by the worker with the file system lock
+ * held. */
+static void
+aio_do (struct aio_req *req) {
+	struct aio_sqe *sqe = &req->sqe;
+
+	switch (sqe->opcode) {
+		case AIO_READ:
+			req->res = file_read_at (req->file, req->buf, sqe->len, sqe->offset);
+			break;
+		case AIO_WRITE:
+			if (req->console) {
+				putbuf (req->buf, sqe->len);
+				req->res = sqe->len;
+			} else
+				req->res = file_write_at (req->file, req->buf, sqe->len,
+						sqe->offset);
+			break;
+		case AIO_OPEN:
+			req->file = filesys_open (req->buf);
+			req->res = req->file != NULL ? 0 : -1;
+			return;
+		case AIO_CLOSE:
+			req->res = 0;
+			break;
+		default:
+			NOT_REACHED ();
+	}
+
+	/* The private handle of a read or write, or the file closed. */
+	if (req->file != NULL) {
+		file_close (req->file);
+		req->file = NULL;
+	}
+}
+
+/* Moves REQ to its process's finished requests.  INFLIGHT says whether
+ * it comes from the worker.  The context may be gone as soon as the lock
+ * is released. */
+static void
+aio_complete (struct aio_req *req, bool inflight) {
+	struct aio_ctx *ctx = req->ctx;
+
+	lock_acquire (&ctx->lock);
+	list_push_back (&ctx->done, &req->elem);
+	if (inflight)
+		ctx->inflight--;
+	cond_signal (&ctx->done_cond, &ctx->lock);
+	lock_release (&ctx->lock);
+}
+
+/* The worker thread. */
+static void
+aio_worker (void *aux UNUSED) {
+	for (;;) {
+		struct list batch;
+
+		list_init (&batch);
+		lock_acquire (&work_lock);
+		while (list_empty (&work_queue))
+			cond_wait (&work_cond, &work_lock);
+		while (!list_empty (&work_queue))
+			list_push_back (&batch, list_pop_front (&work_queue));
+		lock_release (&work_lock);
+
+		batch_cnt++;
+		lock_acquire (&filesys_lock);
+		for (struct list_elem *e = list_begin (&batch); e != list_end (&batch);
+				e = list_next (e)) {
+			aio_do (list_entry (e, struct aio_req, elem));
+			op_cnt++;
+		}
+		lock_release (&filesys_lock);
+
+		while (!list_empty (&batch))
+			aio_complete (list_entry (list_pop_front (&batch),
+						struct aio_req, elem), true);
+	}
+}
+
+/* Frees REQ and everything it holds. */
+static void
+aio_free_req (struct aio_req *req) {
+	if (req->file != NULL) {
+		lock_acquire (&filesys_lock);
+		file_close (req->file);
+		lock_release (&filesys_lock);
+	}
+	free (req->buf);
+	free (req);
+}
+
+/* Sets up REQ from its submission, in the context of the submitting
+ * process.  Returns true if it needs the worker, false if it is finished
+ * already. */
+static bool
+aio_prepare (struct aio_req *req) {
+	struct aio_sqe *sqe = &req->sqe;
+	struct file *f;
+	int len;
+
+	req->res = -1;
+	switch (sqe->opcode) {
+		case AIO_NOP:
+			req->res = 0;
+			return false;
+
+		case AIO_READ:
+		case AIO_WRITE:
+			f = process_get_file (sqe->fd);
+			if (f == NULL || (uintptr_t) f == 1
+					|| (sqe->opcode == AIO_READ && is_console (f)))
+				return false;
+			if (is_console (f) && thread_current ()->stdout_count == 0)
+				return false;
+			/* The worker holds the file system lock, so it must not
+			 * wait on a pipe. */
+			if (!is_console (f) && f->pipe != NULL)
+				return false;
+			if (!is_console (f) && sqe->offset < 0)
+				return false;
+			if (sqe->len > AIO_MAX_LEN)
+				sqe->len = AIO_MAX_LEN;
+			if (sqe->len == 0) {
+				req->res = 0;
+				return false;
+			}
+			req->buf = malloc (sqe->len);
+			if (req->buf == NULL)
+				return false;
+			if (sqe->opcode == AIO_WRITE
+					&& !copy_from_user (req->buf, sqe->buf, sqe->len))
+				return false;
+			if (is_console (f)) {
+				req->console = true;
+				return true;
+			}
+			lock_acquire (&filesys_lock);
+			req->file = file_reopen (f);
+			lock_release (&filesys_lock);
+			return req->file != NULL;
+
+		case AIO_OPEN:
+			req->buf = malloc (AIO_NAME_MAX);
+			if (req->buf == NULL)
+				return false;
+			len = strncpy_from_user (req->buf, sqe->buf, AIO_NAME_MAX);
+			return len >= 0 && len < AIO_NAME_MAX;
+
+		case AIO_CLOSE:
+			if (process_get_file (sqe->fd) == NULL)
+				return false;
+			/* Gone from the table now, the file is closed by the worker. */
+			req->file = process_detach_file (sqe->fd);
+			return true;
+
+		default:
+			return false;
+	}
+}
+
+/* Posts REQ to the completion queue of the current process, whose
+ * context it belongs to. */
+static void
+aio_post (struct aio_ctx *ctx, struct aio_req *req) {
+	struct aio_cqe cqe;
+
+	if (req->res > 0 && req->sqe.opcode == AIO_READ
+			&& !copy_to_user (req->sqe.buf, req->buf, req->res))
+		req->res = -1;
+	if (req->res == 0 && req->sqe.opcode == AIO_OPEN) {
+		lock_acquire (&filesys_lock);
+		req->res = process_add_file (req->file);
+		if (req->res == -1)
+			file_close (req->file);
+		lock_release (&filesys_lock);
+		req->file = NULL;
+	}
+
+	cqe.user_data = req->sqe.user_data;
+	cqe.res = req->res;
+	aio_free_req (req);
+	ctx->pending--;
+	if (!copy_to_user (&ctx->ring->cq[ctx->cq_tail % AIO_CQ_ENTRIES], &cqe,
+				sizeof cqe))
+		exit (-1);
+	ctx->cq_tail++;
+}
+
+/* Takes up to CNT operations out of the submission queue of CTX and
+ * passes them on.  Returns the number taken. */
+static unsigned
+aio_submit (struct aio_ctx *ctx, unsigned cnt) {
+	struct aio_ring *ring = ctx->ring;
+	struct list batch;
+	unsigned sq_tail, taken = 0;
+
+	if (!copy_from_user (&sq_tail, &ring->sq_tail, sizeof sq_tail))
+		exit (-1);
+	list_init (&batch);
+	while (taken < cnt && ctx->sq_head != sq_tail
+			&& ctx->pending < AIO_CQ_ENTRIES) {
+		struct aio_req *req = calloc (1, sizeof *req);
+
+		if (req == NULL)
+			break;
+		if (!copy_from_user (&req->sqe,
+					&ring->sq[ctx->sq_head % AIO_SQ_ENTRIES], sizeof req->sqe)) {
+			free (req);
+			exit (-1);
+		}
+		req->ctx = ctx;
+		ctx->sq_head++;
+		ctx->pending++;
+		taken++;
+
+		if (aio_prepare (req)) {
+			lock_acquire (&ctx->lock);
+			ctx->inflight++;
+			lock_release (&ctx->lock);
+			list_push_back (&batch, &req->elem);
+		} else
+			aio_complete (req, false);
+	}
+	if (!copy_to_user (&ring->sq_head, &ctx->sq_head, sizeof ctx->sq_head))
+		exit (-1);
+
+	if (!list_empty (&batch)) {
+		lock_acquire (&work_lock);
+		while (!list_empty (&batch))
+			list_push_back (&work_queue, list_pop_front (&batch));
+		cond_signal (&work_cond, &work_lock);
+		lock_release (&work_lock);
+	}
+	return taken;
+}
+
+/* Initializes asynchronous I/O.  The worker is started by the first
+ * aio_setup(). */
+void
+aio_init (void) {
+	list_init (&work_queue);
+	lock_init (&work_lock);
+	cond_init (&work_cond);
+}
+
+/* Registers RING for the current process.  Returns 0 if successful, -1
+ * if the process has a ring already or is out of memory. */
+int
+aio_setup (struct aio_ring *ring) {
+	struct thread *curr = thread_current ();
+	struct aio_ctx *ctx;
+	unsigned zero[4] = {0, 0, 0, 0};
+	bool start;
+
+	if (curr->aio != NULL)
+		return -1;
+	if (!copy_to_user (ring, zero, sizeof zero))
+		exit (-1);
+	ctx = malloc (sizeof *ctx);
+	if (ctx == NULL)
+		return -1;
+	ctx->ring = ring;
+	ctx->sq_head = 0;
+	ctx->cq_tail = 0;
+	ctx->pending = 0;
+	lock_init (&ctx->lock);
+	cond_init (&ctx->done_cond);
+	list_init (&ctx->done);
+	ctx->inflight = 0;
+
+	lock_acquire (&work_lock);
+	start = !worker_started;
+	worker_started = true;
+	lock_release (&work_lock);
+	if (start) {
+		tid_t tid = thread_create ("aio", PRI_DEFAULT, aio_worker, NULL);
+
+		if (tid == TID_ERROR) {
+			worker_started = false;
+			free (ctx);
+			return -1;
+		}
+		/* The worker outlives this process: no one waits for it. */
+		child_disown (tid);
+	}
+	curr->aio = ctx;
+	return 0;
+}
+
+/* Submits up to TO_SUBMIT operations from the current process's ring and
+ * waits until at least MIN_COMPLETE completions are in its completion
+ * queue, or until no more can come.  Returns the number of operations
+ * submitted, or -1 if the process has no ring. */
+int
+aio_enter (unsigned to_submit, unsigned min_complete) {
+	struct aio_ctx *ctx = thread_current ()->aio;
+	unsigned submitted;
+
+	if (ctx == NULL)
+		return -1;
+	if (min_complete > AIO_CQ_ENTRIES)
+		min_complete = AIO_CQ_ENTRIES;
+	submitted = aio_submit (ctx, to_submit);
+
+	for (;;) {
+		unsigned cq_head;
+		struct aio_req *req = NULL;
+
+		if (!copy_from_user (&cq_head, &ctx->ring->cq_head, sizeof cq_head))
+			exit (-1);
+
+		lock_acquire (&ctx->lock);
+		if (ctx->cq_tail - cq_head < AIO_CQ_ENTRIES) {
+			/* Room for one more: wait for one if there are too few. */
+			while (list_empty (&ctx->done) && ctx->inflight > 0
+					&& ctx->cq_tail - cq_head < min_complete)
+				cond_wait (&ctx->done_cond, &ctx->lock);
+			if (!list_empty (&ctx->done))
+				req = list_entry (list_pop_front (&ctx->done),
+						struct aio_req, elem);
+		}
+		lock_release (&ctx->lock);
+
+		if (req == NULL)
+			break;
+		aio_post (ctx, req);
+	}
+
+	if (!copy_to_user (&ctx->ring->cq_tail, &ctx->cq_tail, sizeof ctx->cq_tail))
+		exit (-1);
+	return submitted;
+}
+
+/* Waits for the current process's outstanding requests and frees its
+ * ring.  Completions that were never posted are dropped. */
+void
+aio_destroy (void) {
+	struct thread *curr = thread_current ();
+	struct aio_ctx *ctx = curr->aio;
+
+	if (ctx == NULL)
+		return;
+	lock_acquire (&ctx->lock);
+	while (ctx->inflight > 0)
+		cond_wait (&ctx->done_cond, &ctx->lock);
+	lock_release (&ctx->lock);
+
+	while (!list_empty (&ctx->done))
+		aio_free_req (list_entry (list_pop_front (&ctx->done),
+					struct aio_req, elem));
+	curr->aio = NULL;
+	free (ctx);
+}
+
+/* Prints asynchronous I/O statistics. */
+void
+aio_print_stats (void) {
+	if (batch_cnt > 0)
+		printf ("AIO: %lld operations in %lld batches\n", op_cnt, batch_cnt);
+}
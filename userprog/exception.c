@@ -12,6 +12,10 @@ static long long page_fault_cnt;
 static void kill (struct intr_frame *);
 static void page_fault (struct intr_frame *);
 
+/* The exception fixup table, collected by the linker. */
+extern const struct exception_fixup __start___ex_table[];
+extern const struct exception_fixup __stop___ex_table[];
+
 /* Registers handlers for interrupts that can be caused by user
    programs.
 
@@ -105,6 +109,18 @@ kill (struct intr_frame *f) {
 	}
 }
 
+/* Returns the fixup address for a fault at kernel instruction RIP, or 0
+   if a fault there is not expected. */
+static uintptr_t
+search_exception_table (uintptr_t rip) {
+	const struct exception_fixup *e;
+
+	for (e = __start___ex_table; e < __stop___ex_table; e++)
+		if (e->insn == rip)
+			return e->fixup;
+	return 0;
+}
+
 /* Page fault handler.  This is a skeleton that must be filled in
    to implement virtual memory.  Some solutions to project 2 may
    also require modifying this code.
@@ -146,6 +162,16 @@ page_fault (struct intr_frame *f) {
 		return;
 #endif
 
+	/* A kernel access to user memory that is allowed to fail. */
+	if (!user) {
+		uintptr_t fixup = search_exception_table (f->rip);
+
+		if (fixup != 0) {
+			f->rip = fixup;
+			return;
+		}
+	}
+
 	/* Count page faults. */
 	page_fault_cnt++;
 
@@ -2,6 +2,7 @@
 #include <debug.h>
 #include <inttypes.h>
 #include <round.h>
+#include <spawn.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -10,6 +11,7 @@
 #include "filesys/directory.h"
 #include "filesys/file.h"
 #include "filesys/filesys.h"
+#include "filesys/inode.h"
 #include "threads/flags.h"
 #include "threads/init.h"
 #include "threads/interrupt.h"
@@ -19,14 +21,23 @@
 #include "threads/vaddr.h"
 #include "intrinsic.h"
 #include "userprog/process.h"
+#include "userprog/syscall.h"
+#include "userprog/aio.h"
+#include "userprog/uaccess.h"
+#include "userprog/vdso.h"
+#include "threads/malloc.h"
 #ifdef VM
 #include "vm/vm.h"
 #endif
 
 static void process_cleanup (void);
 static bool load (const char *file_name, struct intr_frame *if_);
+static bool load_vec (const char *args, size_t size, int argc,
+		struct intr_frame *if_);
 static void initd (void *f_name);
 static void __do_fork (void *);
+static void vfork_release (void);
+static int reap_child (struct child *);
 
 /* 후보 1 : argument passing 함수를 여기로 빼주기 */
 
@@ -48,10 +59,10 @@ process_create_initd (const char *file_name) {
 
 	/* Make a copy of FILE_NAME.
 	 * Otherwise there's a race between the caller and load(). */
-	fn_copy = palloc_get_page (0);
+	fn_copy = malloc (strlen (file_name) + 1);
 	if (fn_copy == NULL)
 		return TID_ERROR;
-	strlcpy (fn_copy, file_name, PGSIZE);
+	strlcpy (fn_copy, file_name, strlen (file_name) + 1);
 
 	/* Create a new thread to execute FILE_NAME. */
 	// 변경사항
@@ -60,7 +71,7 @@ process_create_initd (const char *file_name) {
 	// 변경사항
 	tid = thread_create (file_name, PRI_DEFAULT, initd, fn_copy);
 	if (tid == TID_ERROR)
-		palloc_free_page (fn_copy);
+		free (fn_copy);
 	return tid;
 }
 
@@ -90,7 +101,7 @@ process_fork (const char *name, struct intr_frame *if_ UNUSED) {
 	if (pid == TID_ERROR)
 		return TID_ERROR;
 	
-	struct thread *child = get_child(pid);
+	struct child *child = get_child(pid);
 	sema_down(&child->fork_sema); 
 
 	if(child->exit_status == -1)
@@ -112,6 +123,9 @@ duplicate_pte (uint64_t *pte, void *va, void *aux) {
 	/* 1. TODO: If the parent_page is kernel page, then return immediately. */
 	if (is_kernel_vaddr(va))
 		return true;
+	/* The vDSO page is shared, and the child has it mapped already. */
+	if (va == (void *) VDSO_ADDR)
+		return true;
 
 	/* 2. Resolve VA from the parent's page map level 4. */
 	parent_page = pml4_get_page (parent->pml4, va);
@@ -140,11 +154,43 @@ duplicate_pte (uint64_t *pte, void *va, void *aux) {
 }
 #endif
 
-struct dict_elem{
-	uintptr_t key;
-	uintptr_t value;
-};
-// dup_count 말고 map_idx가 더 lgtm
+/* 부모의 FD 테이블을 현재(자식) 프로세스로 복사 */
+static bool
+duplicate_fds (struct thread *parent) {
+	struct thread *current = thread_current ();
+	bool succ = true;
+
+	// 부모 테이블 크기만큼 미리 늘려둠
+	if (!fd_table_reserve(current, parent->fd_cap - 1))
+		return false;
+
+	/* 살아있는 fd 만 돌면서 복사. 자식은 파일마다 위치가 따로인 사본을 하나씩 갖고,
+	 * dup2 로 여러 fd 가 공유하던 파일은 사본도 공유함 (fork_copy 로 바로 찾음) */
+	for(int i = fd_table_next(parent, 0); i != -1; i = fd_table_next(parent, i + 1)){
+		struct file *f = parent->fd_table[i];
+		struct file *new_f;
+
+		if ((uintptr_t) f <= 2)
+			new_f = f;
+		else if (f->fork_copy != NULL)
+			new_f = file_dup(f->fork_copy);
+		else {
+			new_f = file_duplicate(f);
+			if (new_f == NULL)
+				succ = false;
+			else if (f->ref_cnt > 1)
+				f->fork_copy = new_f;
+		}
+		if (new_f != NULL)
+			fd_table_set(current, i, new_f);
+	}
+	current->stdin_count = parent->stdin_count;
+	current->stdout_count = parent->stdout_count;
+	for(int i = fd_table_next(parent, 0); i != -1; i = fd_table_next(parent, i + 1))
+		if ((uintptr_t) parent->fd_table[i] > 2)
+			parent->fd_table[i]->fork_copy = NULL;
+	return succ;
+}
 
 /* A thread function that copies parent's execution context.
  * Hint) parent->tf does not hold the userland context of the process.
@@ -166,10 +212,15 @@ __do_fork (void *aux) {
 
 	/* 2. Duplicate PT */
 	current->pml4 = pml4_create();
-	if (current->pml4 == NULL)
+	if (current->pml4 == NULL || !vdso_map(current->pml4))
 		goto error;
 
 	process_activate (current);
+
+	/* The child runs the same executable, so it also keeps it open and
+	 * write-protected.  Lazily loaded segments read from this copy. */
+	if (parent->running != NULL)
+		current->running = file_duplicate (parent->running);
 #ifdef VM
 	supplemental_page_table_init (&current->spt);
 	if (!supplemental_page_table_copy (&current->spt, &parent->spt))
@@ -185,48 +236,12 @@ __do_fork (void *aux) {
 	 * TODO:       from the fork() until this function successfully duplicates
 	 * TODO:       the resources of parent.*/
 
-	if (parent->fd_idx == FDCOUNT_LIMIT)
+	if (parent->fd_cnt == FDCOUNT_LIMIT)
+		goto error;
+	if (!duplicate_fds(parent))
 		goto error;
 
-	const int DICTLEN = 100;
-	struct dict_elem dup_file_dict[100];
-	int dup_idx = 0;
-	
-	// current->fd_table[0] = parent->fd_table[0];
-	// current->fd_table[1] = parent->fd_table[1];
-
-	for(int i = 0; i < FDCOUNT_LIMIT; i++){
-		struct file *f = parent->fd_table[i];
-		if (f==NULL) continue;
-		
-		bool is_exist = false;
-		for (int j = 0; j <= dup_idx; j++){
-			if (dup_file_dict[j].key == f){
-				current->fd_table[i] = dup_file_dict[j].value;
-				is_exist = true;
-				break;
-			}
-		}
-		if (is_exist)
-			continue;
-		
-		struct file *new_f;
-		if (f>2)
-			new_f = file_duplicate(f);
-		else
-			new_f = f;
-
-		current->fd_table[i] = new_f;
-
-		if(dup_idx<DICTLEN){
-			dup_file_dict[dup_idx].key = f;
-			dup_file_dict[dup_idx].value = new_f;
-			dup_idx ++;
-		}
-	}
-
-	current->fd_idx = parent->fd_idx;
-	sema_up(&current->fork_sema);
+	sema_up(&current->child_rec->fork_sema);
 
 	if_.R.rax = 0; // 반환값 (자식프로세스가 0을 반환해야 함.)
 	// process_init ();
@@ -235,13 +250,179 @@ __do_fork (void *aux) {
 	if (succ)
 		do_iret (&if_);
 error:
-	current->exit_status = TID_ERROR; // 없어도될듯? 실험
-	sema_up(&current->fork_sema);
+	current->child_rec->exit_status = TID_ERROR; // 부모는 자식 기록에서 확인
+	sema_up(&current->child_rec->fork_sema);
 	exit(TID_ERROR);
 	// thread_exit ();
 }
 
-/* Switch the current execution context to the f_name.
+/* What a spawn() or vfork() child needs from its parent, which waits on
+ * the child's fork_sema and so keeps this alive until the child lets it
+ * go. */
+struct spawn_info {
+	struct thread *parent;
+	char *args;                           /* ARGC strings, freed by the child. */
+	size_t args_size;                     /* Bytes in ARGS. */
+	int argc;
+	const struct spawn_action *actions;   /* File actions, ACTION_CNT of them. */
+	int action_cnt;
+	bool success;                         /* Did the child get going? */
+};
+
+/* spawn() 의 파일 동작을 자식 FD 테이블에 적용 */
+static bool
+apply_spawn_actions (const struct spawn_action *actions, int cnt) {
+	for (int i = 0; i < cnt; i++){
+		const struct spawn_action *a = &actions[i];
+
+		if (a->op == SPAWN_DUP2){
+			if (dup2(a->fd, a->newfd) == -1)
+				return false;
+		}
+		else if (a->op == SPAWN_CLOSE)
+			close(a->fd);
+		else
+			return false;
+	}
+	return true;
+}
+
+/* A thread function that starts a spawn()ed process: it takes a copy of
+ * the parent's file descriptors, applies the file actions and loads the
+ * program straight into its own, new address space.  Nothing of the
+ * parent's memory is copied. */
+static void
+__do_spawn (void *aux) {
+	struct spawn_info *info = aux;
+	struct thread *current = thread_current ();
+	struct intr_frame if_;
+	bool success;
+
+	memset (&if_, 0, sizeof if_);
+	if_.ds = if_.es = if_.ss = SEL_UDSEG;
+	if_.cs = SEL_UCSEG;
+	if_.eflags = FLAG_IF | FLAG_MBS;
+#ifdef VM
+	supplemental_page_table_init (&current->spt);
+#endif
+
+	success = duplicate_fds (info->parent)
+		&& apply_spawn_actions (info->actions, info->action_cnt)
+		&& load_vec (info->args, info->args_size, info->argc, &if_);
+	free (info->args);
+	info->success = success;
+	sema_up (&current->child_rec->fork_sema);
+	if (!success)
+		exit (TID_ERROR);
+	do_iret (&if_);
+	NOT_REACHED ();
+}
+
+/* Starts a new process with the ARGC arguments in ARGS, null-terminated
+ * strings that follow each other in SIZE bytes from malloc() that this
+ * function takes over.  The first one names the program.  The process
+ * gets the current process's file descriptors as changed by the
+ * ACTION_CNT ACTIONS.  Returns the new process's thread id, or TID_ERROR
+ * if it cannot be started. */
+tid_t
+process_spawn (char *args, size_t size, int argc,
+		const struct spawn_action *actions, int action_cnt) {
+	struct spawn_info info = {
+		.parent = thread_current (),
+		.args = args,
+		.args_size = size,
+		.argc = argc,
+		.actions = actions,
+		.action_cnt = action_cnt,
+		.success = false,
+	};
+	char name[16];
+	tid_t tid;
+
+	strlcpy (name, args, sizeof name);
+	tid = thread_create (name, PRI_DEFAULT, __do_spawn, &info);
+	if (tid == TID_ERROR) {
+		free (args);
+		return TID_ERROR;
+	}
+	sema_down (&get_child (tid)->fork_sema);
+	return info.success ? tid : TID_ERROR;
+}
+
+/* A thread function that starts a vfork()ed child.  The child takes a
+ * copy of the parent's file descriptors but borrows the parent's address
+ * space, page tables and all, until it calls exec() or exits: see
+ * vfork_release(). */
+static void
+__do_vfork (void *aux) {
+	struct spawn_info *info = aux;
+	struct thread *parent = info->parent;
+	struct thread *current = thread_current ();
+	struct intr_frame if_;
+
+	memcpy (&if_, &parent->parent_if, sizeof if_);
+	if (parent->running != NULL)
+		current->running = file_duplicate (parent->running);
+	if (!duplicate_fds (parent)) {
+		sema_up (&current->child_rec->fork_sema);
+		exit (TID_ERROR);
+	}
+
+	current->vfork_parent = parent;
+	current->pml4 = parent->pml4;
+#ifdef VM
+	supplemental_page_table_init (&current->spt);
+	supplemental_page_table_move (current, parent);
+#endif
+	process_activate (current);
+	info->success = true;
+
+	if_.R.rax = 0;
+	do_iret (&if_);
+	NOT_REACHED ();
+}
+
+/* Starts a child that runs in the current process's address space until
+ * it calls exec() or exits, and waits until it does.  The child resumes
+ * from IF_ with a return value of 0.  Returns the child's thread id, or
+ * TID_ERROR if it cannot be started. */
+tid_t
+process_vfork (struct intr_frame *if_ UNUSED) {
+	struct spawn_info info = {
+		.parent = thread_current (),
+		.success = false,
+	};
+	tid_t tid;
+
+	tid = thread_create (thread_name (), PRI_DEFAULT, __do_vfork, &info);
+	if (tid == TID_ERROR)
+		return TID_ERROR;
+	sema_down (&get_child (tid)->fork_sema);
+	return info.success ? tid : TID_ERROR;
+}
+
+/* Gives a vfork()ed child's borrowed address space back to its parent and
+ * lets the parent go on. */
+static void
+vfork_release (void) {
+	struct thread *curr = thread_current ();
+	struct thread *parent = curr->vfork_parent;
+
+	if (parent == NULL)
+		return;
+#ifdef VM
+	supplemental_page_table_move (parent, curr);
+#endif
+	/* The parent may exit and destroy its page tables as soon as it
+	 * runs. */
+	curr->pml4 = NULL;
+	pml4_activate (NULL);
+	curr->vfork_parent = NULL;
+	sema_up (&curr->child_rec->fork_sema);
+}
+
+/* Switch the current execution context to the f_name, a command line
+ * from malloc() that this function frees.
  * Returns -1 on fail. */
 int
 process_exec (void *f_name) { // 실험 
@@ -258,18 +439,19 @@ process_exec (void *f_name) { // 실험
 
 	/* We first kill the current context */
 	process_cleanup ();
+#ifdef VM
+	supplemental_page_table_init (&thread_current ()->spt);
+#endif
 
 	// memset(&_if, 0, sizeof _if); // Project 2 (argument passing 관련 변경) // 이거 삭제
 
 	/* And then load the binary */
 	success = load (file_name, &_if); // Project 2 (argument passing 관련 변경)
+	free (file_name);
 
 	/* If load failed, quit. */
-	
-	if (!success){
-		palloc_free_page (file_name); 
+	if (!success)
 		return -1;
-	}
 
 	/* argument stack 함수 위치가 여기여야 할까? */
 
@@ -280,44 +462,6 @@ process_exec (void *f_name) { // 실험
 	NOT_REACHED ();
 }
 
-// Project 2 (argument passing 관련 변경)
-void argument_stack(char **argv, int argc, struct intr_frame *if_){
-	char *arg_address[128];
-
-	// part A: word-align 전까지
-	for(int i = argc - 1 ; i >= 0; i--){
-		int arg_i_len = strlen(argv[i]) + 1; // include sentinel(\0)
-		if_->rsp = if_->rsp - (arg_i_len); // 인자 크기만큼 스택을 늘려줌
-		memcpy(if_->rsp, argv[i], arg_i_len); // 늘려준 공간에 해당 인자를 복사
-		arg_address[i] = if_->rsp; // arg_address 에 위 인자를 복사해준 주소값을 저장
-	}
-
-	// part B : word-align (8의 배수)
-	while(if_ -> rsp % 8 != 0){
-		if_->rsp--;
-		*(uint8_t *) if_->rsp = 0;
-	}
-
-	// part C: word-align 이후 (깃북 argv[4]~argv[0]의 주소를 data로 넣기)
-	for(int i = argc; i>=0; i--){
-		if_->rsp = if_->rsp - 8;
-		if(i==argc)
-			memset(if_->rsp, 0, sizeof(char **));
-		else
-			memcpy(if_->rsp, &arg_address[i], sizeof(char **));
-	}
-
-	// part D: rdi, rsi 세팅
-
-	if_->R.rdi = argc;
-	if_->R.rsi = if_->rsp; // 굳이 -8 하고나서 +8 안하고, 그냥 여기서 세팅하기
-
-	// part E: 마지막줄 (fake address)
-	if_->rsp = if_->rsp - 8;
-	memset(if_->rsp, 0, sizeof(void *));
-}
-
-
 /* Waits for thread TID to die and returns its exit status.  If
  * it was terminated by the kernel (i.e. killed due to an
  * exception), returns -1.  If TID is invalid or if it was not a
@@ -333,47 +477,88 @@ process_wait (tid_t child_tid UNUSED) {
 	 * XXX:       to add infinite loop here before
 	 * XXX:       implementing the process_wait. */
 	// struct thread *curr = thread_current();
-	struct thread *child = get_child(child_tid);
+	struct child *child = get_child(child_tid);
 
 	if (child == NULL)
 		return -1;
+	return reap_child(child);
+}
 
-	sema_down(&child->wait_sema);
-	int exit_status = child->exit_status;
-	list_remove(&child->child_elem);
-	sema_up(&child->free_sema);
-	
+/* 자식 CHILD 가 종료하기를 기다려 기록을 거두고 종료 상태를 돌려줌.
+ * 자식 스레드는 이미 해제됐을 수 있음: 기록만 보고 정리 */
+static int
+reap_child (struct child *child) {
+	struct thread *curr = thread_current ();
+	enum intr_level old_level;
+	int exit_status;
+
+	sema_down(&child->exit_sema);
+	exit_status = child->exit_status;
+	old_level = intr_disable();
+	list_remove(&child->exit_elem);
+	intr_set_level(old_level);
+	hash_delete(&curr->children, &child->elem);
+	child_release(child);
 	return exit_status;
 }
 
+/* Waits for child PID, or for whichever child exits first if PID is -1,
+ * and stores its exit status in *STATUS.  Returns the child's pid, or -1
+ * if there is no such child. */
+tid_t
+process_waitpid (tid_t pid, int *status) {
+	struct thread *curr = thread_current ();
+	struct child *child = NULL;
+	enum intr_level old_level;
+
+	if (pid != -1) {
+		child = get_child (pid);
+		if (child == NULL)
+			return -1;
+		*status = reap_child (child);
+		return pid;
+	}
+
+	/* Each exit ups child_exit_sema once, but process_wait() may reap the
+	 * child before we see it here, so the count can run ahead of the
+	 * list: check the list, not the count. */
+	for (;;) {
+		old_level = intr_disable ();
+		if (!list_empty (&curr->exited_children))
+			child = list_entry (list_front (&curr->exited_children),
+					struct child, exit_elem);
+		intr_set_level (old_level);
+		if (child != NULL)
+			break;
+		if (hash_empty (&curr->children))
+			return -1;
+		sema_down (&curr->child_exit_sema);
+	}
+	pid = child->tid;
+	*status = reap_child (child);
+	return pid;
+}
+
 /* Exit the process. This function is called by thread_exit (). */
 void
 process_exit (void) {
-	struct thread *curr = thread_current ();
+	struct thread *curr UNUSED = thread_current ();
 	/* TODO: Your code goes here.
 	 * TODO: Implement process termination message (see
 	 * TODO: project2/process_termination.html).
 	 * TODO: We recommend you to implement process resource cleanup here. */
 	
-	// struct file **curr_fd_table = curr->fd_table;
-	// for (int i = curr->fd_idx; i >= 2; i--){
-	// 	process_close_file(i);
-	// }
-	for (int i = 0; i < FDCOUNT_LIMIT; i++){ //curr->fd_idx 까지만 해도 가능할듯
-		close(i);
-	}
-
-	// curr->fd_idx = 2;
-
-	palloc_free_multiple(curr->fd_table, FDT_PAGES);
-
-	file_close(curr->running); // denying writes to executable
+	process_close_all_files(); // 살아있는 fd 만 닫음
+	stdout_release(); // 모아둔 콘솔 출력을 내보냄
 
+#ifdef VM
+	if (vm_usage_dump && curr->pml4 != NULL)
+		vm_print_usage (curr);
+#endif
 	process_cleanup ();
 
-	sema_up(&curr->wait_sema);
-
-	sema_down(&curr->free_sema);
+	/* 부모를 기다리지 않음: 종료 상태는 thread_exit() 가 부모의 자식 기록에
+	 * 남기고, 스레드 페이지는 바로 해제됨 */
 }
 
 /* Free the current process's resources. */
@@ -381,10 +566,19 @@ static void
 process_cleanup (void) {
 	struct thread *curr = thread_current ();
 
+	/* Outstanding requests may still be writing into this image. */
+	aio_destroy ();
+	vfork_release ();
+
 #ifdef VM
 	supplemental_page_table_kill (&curr->spt);
 #endif
 
+	/* Let the executable be written again.  exec() comes through here
+	 * too, before it opens the new one. */
+	file_close (curr->running);
+	curr->running = NULL;
+
 	uint64_t *pml4;
 	/* Destroy the current process's page directory and switch back
 	 * to the kernel-only page directory. */
@@ -399,6 +593,7 @@ process_cleanup (void) {
 		 * that's been freed (and cleared). */
 		curr->pml4 = NULL;
 		pml4_activate (NULL);
+		vdso_unmap (pml4);
 		pml4_destroy (pml4);
 	}
 }
@@ -409,6 +604,7 @@ void
 process_activate (struct thread *next) {
 	/* Activate thread's page tables. */
 	pml4_activate (next->pml4);
+	vdso_activate (next);
 
 	/* Set thread's kernel stack for use in processing interrupts. */
 	tss_update (next);
@@ -467,42 +663,346 @@ struct ELF64_PHDR {
 #define ELF ELF64_hdr
 #define Phdr ELF64_PHDR
 
-static bool setup_stack (struct intr_frame *if_);
+static bool setup_stack (struct intr_frame *if_, size_t size);
 static bool validate_segment (const struct Phdr *, struct file *);
 static bool load_segment (struct file *file, off_t ofs, uint8_t *upage,
 		uint32_t read_bytes, uint32_t zero_bytes,
 		bool writable);
 
+/* Executables parsed recently, so that exec() of a program that ran a
+ * moment ago neither reads nor checks its headers again.  An image holds
+ * the executable's inode open and is keyed by it; it goes stale when the
+ * file is written.  With VM, the frames of a cached executable's
+ * read-only segments also stay in the page index after its last process
+ * exits, so the next one maps them without reading the disk. */
+#define IMAGE_CACHE_SIZE 8
+
+/* A parsed executable. */
+struct image {
+	struct list_elem elem;          /* Element of image_cache. */
+	struct inode *inode;            /* Executable, held open. */
+	unsigned write_cnt;             /* inode_write_count() when parsed. */
+	uint64_t entry;                 /* Entry point. */
+	int ref_cnt;                    /* Loads using it, plus 1 if cached. */
+	int seg_cnt;                    /* Number of SEGS. */
+	struct Phdr segs[];             /* Its valid PT_LOAD headers. */
+};
+
+static struct list image_cache;     /* Most recently used first. */
+static struct lock image_lock;      /* Protects image_cache. */
+static long long image_hit_cnt;     /* Loads that found the image. */
+static long long image_miss_cnt;    /* Loads that parsed it. */
+static long long image_stale_cnt;   /* Images dropped as out of date. */
+
+/* Initializes the executable image cache. */
+void
+process_image_init (void) {
+	list_init (&image_cache);
+	lock_init (&image_lock);
+}
+
+/* Prints exec() statistics. */
+void
+process_print_stats (void) {
+	printf ("Exec images: %lld hits, %lld misses, %lld stale\n",
+			image_hit_cnt, image_miss_cnt, image_stale_cnt);
+}
+
+/* Reads and checks the ELF headers of FILE, named NAME.  Returns the
+ * parsed image with a reference count of 1, or a null pointer if FILE
+ * is not a valid executable or memory is short. */
+static struct image *
+image_parse (struct file *file, const char *name) {
+	struct ELF ehdr;
+	struct Phdr *phdrs = NULL;
+	struct image *image = NULL;
+	size_t phdrs_size;
+	int load_cnt = 0;
+	int i;
+
+	/* Read and verify executable header. */
+	if (file_read_at (file, &ehdr, sizeof ehdr, 0) != sizeof ehdr
+			|| memcmp (ehdr.e_ident, "\177ELF\2\1\1", 7)
+			|| ehdr.e_type != 2
+			|| ehdr.e_machine != 0x3E // amd64
+			|| ehdr.e_version != 1
+			|| ehdr.e_phentsize != sizeof (struct Phdr)
+			|| ehdr.e_phnum > 1024)
+		goto bad;
+
+	/* Read all the program headers at once. */
+	phdrs_size = ehdr.e_phnum * sizeof *phdrs;
+	if (ehdr.e_phoff > (uint64_t) file_length (file))
+		goto bad;
+	phdrs = malloc (phdrs_size + 1);
+	if (phdrs == NULL)
+		return NULL;
+	if (file_read_at (file, phdrs, phdrs_size, ehdr.e_phoff)
+			!= (off_t) phdrs_size)
+		goto bad;
+
+	for (i = 0; i < ehdr.e_phnum; i++)
+		switch (phdrs[i].p_type) {
+			case PT_NULL:
+			case PT_NOTE:
+			case PT_PHDR:
+			case PT_STACK:
+			default:
+				/* Ignore this segment. */
+				break;
+			case PT_DYNAMIC:
+			case PT_INTERP:
+			case PT_SHLIB:
+				goto bad;
+			case PT_LOAD:
+				if (!validate_segment (&phdrs[i], file))
+					goto bad;
+				load_cnt++;
+				break;
+		}
+
+	image = malloc (sizeof *image + load_cnt * sizeof *image->segs);
+	if (image == NULL)
+		goto done;
+	image->inode = inode_reopen (file_get_inode (file));
+	image->write_cnt = inode_write_count (image->inode);
+	image->entry = ehdr.e_entry;
+	image->ref_cnt = 1;
+	image->seg_cnt = 0;
+	for (i = 0; i < ehdr.e_phnum; i++)
+		if (phdrs[i].p_type == PT_LOAD)
+			image->segs[image->seg_cnt++] = phdrs[i];
+	goto done;
+
+bad:
+	/* Every way FILE can fail to be an executable looks the same. */
+	printf ("load: %s: error loading executable\n", name);
+done:
+	free (phdrs);
+	return image;
+}
+
+/* Drops a reference to IMAGE, freeing it with the last one.  Must be
+ * called with image_lock held. */
+static void
+image_unref (struct image *image) {
+	if (--image->ref_cnt > 0)
+		return;
+	inode_close (image->inode);
+	free (image);
+}
+
+/* Removes IMAGE from the cache.  Must be called with image_lock held. */
+static void
+image_evict (struct image *image) {
+	list_remove (&image->elem);
+#ifdef VM
+	vm_share_release (inode_get_inumber (image->inode));
+#endif
+	image_unref (image);
+}
+
+/* Returns the parsed image of executable FILE, named NAME, from the cache
+ * or by parsing it, or a null pointer if it is not a valid executable.
+ * The caller must keep FILE denied writes while it uses the image, and
+ * drop it with image_put(). */
+static struct image *
+image_get (struct file *file, const char *name) {
+	struct inode *inode = file_get_inode (file);
+	struct image *image = NULL;
+	struct list_elem *e;
+
+	lock_acquire (&image_lock);
+	for (e = list_begin (&image_cache); e != list_end (&image_cache);
+			e = list_next (e)) {
+		struct image *cached = list_entry (e, struct image, elem);
+
+		if (cached->inode != inode)
+			continue;
+		if (cached->write_cnt == inode_write_count (inode)) {
+			image = cached;
+			list_remove (&image->elem);
+			list_push_front (&image_cache, &image->elem);
+			image->ref_cnt++;
+			image_hit_cnt++;
+		} else {
+			image_evict (cached);
+			image_stale_cnt++;
+		}
+		break;
+	}
+
+	if (image == NULL) {
+		image_miss_cnt++;
+		image = image_parse (file, name);
+		if (image != NULL) {
+			image->ref_cnt++;
+			list_push_front (&image_cache, &image->elem);
+#ifdef VM
+			vm_share_retain (inode_get_inumber (inode));
+#endif
+			if (list_size (&image_cache) > IMAGE_CACHE_SIZE)
+				image_evict (list_entry (list_back (&image_cache),
+							struct image, elem));
+		}
+	}
+	lock_release (&image_lock);
+	return image;
+}
+
+/* Drops the caller's reference to IMAGE. */
+static void
+image_put (struct image *image) {
+	lock_acquire (&image_lock);
+	image_unref (image);
+	lock_release (&image_lock);
+}
+
+/* The initial user stack of a new process, built whole in one kernel
+ * buffer and copied in at once.  From its lowest address: a fake return
+ * address, argv[] with its null terminator, an empty envp[], padding and
+ * the argument strings, which end at USER_STACK. */
+struct arg_image {
+	uint8_t *buf;                   /* Kernel copy, SIZE bytes. */
+	size_t size;                    /* Multiple of 8, at most ARG_MAX. */
+	int argc;                       /* Number of arguments. */
+	const char *name;               /* argv[0] in BUF. */
+	uint64_t argv;                  /* User address of argv[]. */
+	uint64_t envp;                  /* User address of envp[]. */
+};
+
+/* Allocates IMG for ARGC arguments whose strings, terminators included,
+ * take STR_SIZE bytes, and returns where in IMG->buf the strings go.  The
+ * caller copies them there and points argv[] at them with
+ * arg_image_set().  Returns a null pointer if there are no arguments,
+ * they take more than ARG_MAX bytes or memory is short. */
+static char *
+arg_image_alloc (struct arg_image *img, int argc, size_t str_size) {
+	const size_t word = sizeof (uint64_t);
+	char *str;
+
+	if (argc == 0 || str_size > ARG_MAX)
+		return NULL;
+	img->argc = argc;
+	img->size = (argc + 3) * word + ROUND_UP (str_size, word);
+	if (img->size > ARG_MAX)
+		return NULL;
+	img->buf = malloc (img->size);
+	if (img->buf == NULL)
+		return NULL;
+
+	/* Everything below the strings is zero but argv[0...argc-1]. */
+	str = (char *) img->buf + img->size - str_size;
+	memset (img->buf, 0, img->size - str_size);
+	img->name = str;
+	img->argv = USER_STACK - img->size + word;
+	img->envp = img->argv + (argc + 1) * word;
+	return str;
+}
+
+/* Points argv[I] of IMG at STR, a string in IMG->buf. */
+static void
+arg_image_set (struct arg_image *img, int i, const char *str) {
+	uint64_t *words = (uint64_t *) img->buf;
+
+	words[1 + i] = USER_STACK - img->size + (str - (char *) img->buf);
+}
+
+/* Splits CMD_LINE into space-separated arguments and lays them out in
+ * IMG.  Returns false if there are none, they take more than ARG_MAX
+ * bytes or memory is short. */
+static bool
+arg_image_build (struct arg_image *img, const char *cmd_line) {
+	size_t str_size = 0;
+	int argc = 0;
+	const char *p;
+	char *str;
+	size_t len;
+	int i;
+
+	/* Count the arguments and the bytes they take. */
+	for (p = cmd_line; *(p += strspn (p, " ")) != '\0'; p += len) {
+		len = strcspn (p, " ");
+		str_size += len + 1;
+		argc++;
+	}
+	str = arg_image_alloc (img, argc, str_size);
+	if (str == NULL)
+		return false;
+
+	i = 0;
+	for (p = cmd_line; *(p += strspn (p, " ")) != '\0'; p += len) {
+		len = strcspn (p, " ");
+		arg_image_set (img, i++, str);
+		memcpy (str, p, len);
+		str[len] = '\0';
+		str += len + 1;
+	}
+	return true;
+}
+
+/* Lays out in IMG the ARGC null-terminated strings that follow each
+ * other in the SIZE bytes at ARGS, taking each as one argument as it
+ * is, spaces and all.  Returns false if there are none, they take more
+ * than ARG_MAX bytes or memory is short. */
+static bool
+arg_image_build_vec (struct arg_image *img, const char *args, size_t size,
+		int argc) {
+	char *str = arg_image_alloc (img, argc, size);
+	int i;
+
+	if (str == NULL)
+		return false;
+	memcpy (str, args, size);
+	for (i = 0; i < argc; i++) {
+		arg_image_set (img, i, str);
+		str += strlen (str) + 1;
+	}
+	return true;
+}
+
+static bool load_args (struct arg_image *args, struct intr_frame *if_);
+
 /* Loads an ELF executable from FILE_NAME into the current thread.
  * Stores the executable's entry point into *RIP
  * and its initial stack pointer into *RSP.
  * Returns true if successful, false otherwise. */
 static bool
 load (const char *file_name, struct intr_frame *if_) {
+	struct arg_image args = { .buf = NULL };
+
+	// Project 2 (argument passing 관련 변경)
+	/* 인자를 나눠서 초기 스택 내용을 미리 한 버퍼에 만들어 둠 */
+	if (!arg_image_build (&args, file_name))
+		return false;
+	return load_args (&args, if_);
+}
+
+/* Like load(), but takes the ARGC arguments one by one, as
+ * arg_image_build_vec() does. */
+static bool
+load_vec (const char *args, size_t size, int argc, struct intr_frame *if_) {
+	struct arg_image img = { .buf = NULL };
+
+	if (!arg_image_build_vec (&img, args, size, argc))
+		return false;
+	return load_args (&img, if_);
+}
+
+/* Like load(), but takes the arguments laid out in ARGS already, and
+ * frees ARGS->buf.  argv[0] names the executable. */
+static bool
+load_args (struct arg_image *args, struct intr_frame *if_) {
 	struct thread *t = thread_current ();
-	struct ELF ehdr;
+	const char *file_name = args->name;
+	struct image *image = NULL;
 	struct file *file = NULL;
-	off_t file_ofs;
 	bool success = false;
 	int i;
 
-	// Project 2 (argument passing 관련 변경)
-	char *arg_list[128];
-	char *token, *save_ptr;
-	int token_count = 0;
-	
-	token = strtok_r(file_name, " ", &save_ptr);
-	arg_list[token_count] = token;
-
-	while(token!=NULL){
-		token = strtok_r(NULL, " ", &save_ptr);
-		token_count++;
-		arg_list[token_count] = token;
-	}
-
 	/* Allocate and activate page directory. */
 	t->pml4 = pml4_create ();
-	if (t->pml4 == NULL)
+	if (t->pml4 == NULL || !vdso_map (t->pml4))
 		goto done;
 	process_activate (thread_current ());
 
@@ -518,88 +1018,58 @@ load (const char *file_name, struct intr_frame *if_) {
 	t->running = file;
 	file_deny_write(file);
 
-	/* Read and verify executable header. */
-	if (file_read (file, &ehdr, sizeof ehdr) != sizeof ehdr 
-			|| memcmp (ehdr.e_ident, "\177ELF\2\1\1", 7) // 7바이트 비교한거가 다르거나 
-			|| ehdr.e_type != 2 // 실행파일(type 2)이 아니거나
-			|| ehdr.e_machine != 0x3E // amd64가 아니거나
-			|| ehdr.e_version != 1 // object 파일 버전이 현재버전(1)이 아니거나
-			|| ehdr.e_phentsize != sizeof (struct Phdr) // 프로그램 해더 테이블의 한 엔트리 크기가, Phdr 구조체 사이즈와 다르거나
-			|| ehdr.e_phnum > 1024) { //  프로그램 헤더 테이블의 엔트리수가 1024보다 많거나
-		printf ("load: %s: error loading executable\n", file_name); // 위 중 하나라도 해당하면, error
+	/* Parse the headers, or find them parsed already. */
+	image = image_get (file, file_name);
+	if (image == NULL)
 		goto done;
-	}
 
-	/* Read program headers. */
-	file_ofs = ehdr.e_phoff;
-	for (i = 0; i < ehdr.e_phnum; i++) {
-		struct Phdr phdr;
-
-		if (file_ofs < 0 || file_ofs > file_length (file))
-			goto done;
-		file_seek (file, file_ofs);
-
-		if (file_read (file, &phdr, sizeof phdr) != sizeof phdr)
-			goto done;
-		file_ofs += sizeof phdr;
-		switch (phdr.p_type) {
-			case PT_NULL:
-			case PT_NOTE:
-			case PT_PHDR:
-			case PT_STACK:
-			default:
-				/* Ignore this segment. */
-				break;
-			case PT_DYNAMIC:
-			case PT_INTERP:
-			case PT_SHLIB:
-				goto done;
-			case PT_LOAD:
-				if (validate_segment (&phdr, file)) {
-					bool writable = (phdr.p_flags & PF_W) != 0;
-					uint64_t file_page = phdr.p_offset & ~PGMASK;
-					uint64_t mem_page = phdr.p_vaddr & ~PGMASK;
-					uint64_t page_offset = phdr.p_vaddr & PGMASK;
-					uint32_t read_bytes, zero_bytes;
-					if (phdr.p_filesz > 0) {
-						/* Normal segment.
-						 * Read initial part from disk and zero the rest. */
-						read_bytes = page_offset + phdr.p_filesz;
-						zero_bytes = (ROUND_UP (page_offset + phdr.p_memsz, PGSIZE)
-								- read_bytes);
-					} else {
-						/* Entirely zero.
-						 * Don't read anything from disk. */
-						read_bytes = 0;
-						zero_bytes = ROUND_UP (page_offset + phdr.p_memsz, PGSIZE);
-					}
-					if (!load_segment (file, file_page, (void *) mem_page,
-								read_bytes, zero_bytes, writable))
-						goto done;
-				}
-				else
-					goto done;
-				break;
+	for (i = 0; i < image->seg_cnt; i++) {
+		const struct Phdr *phdr = &image->segs[i];
+		bool writable = (phdr->p_flags & PF_W) != 0;
+		uint64_t file_page = phdr->p_offset & ~PGMASK;
+		uint64_t mem_page = phdr->p_vaddr & ~PGMASK;
+		uint64_t page_offset = phdr->p_vaddr & PGMASK;
+		uint32_t read_bytes, zero_bytes;
+		if (phdr->p_filesz > 0) {
+			/* Normal segment.
+			 * Read initial part from disk and zero the rest. */
+			read_bytes = page_offset + phdr->p_filesz;
+			zero_bytes = (ROUND_UP (page_offset + phdr->p_memsz, PGSIZE)
+					- read_bytes);
+		} else {
+			/* Entirely zero.
+			 * Don't read anything from disk. */
+			read_bytes = 0;
+			zero_bytes = ROUND_UP (page_offset + phdr->p_memsz, PGSIZE);
 		}
+		if (!load_segment (file, file_page, (void *) mem_page,
+					read_bytes, zero_bytes, writable))
+			goto done;
 	}
 
 	/* Set up stack. */
-	if (!setup_stack (if_))
+	if (!setup_stack (if_, args->size))
 		goto done;
 
 	/* Start address. */
-	if_->rip = ehdr.e_entry;
+	if_->rip = image->entry;
 
-	/* TODO: Your code goes here.
-	 * TODO: Implement argument passing (see project2/argument_passing.html). */
-
-	 // Project 2 (argument passing 관련 변경)
-	argument_stack(arg_list, token_count, if_);
+	// Project 2 (argument passing 관련 변경)
+	/* 만들어 둔 스택 내용을 한 번에 복사 */
+	if_->rsp -= args->size;
+	if (!copy_to_user ((void *) if_->rsp, args->buf, args->size))
+		goto done;
+	if_->R.rdi = args->argc;
+	if_->R.rsi = args->argv;
+	if_->R.rdx = args->envp;
 	success = true;
 
 done:
 	/* We arrive here whether the load is successful or not. */
 	// file_close (file);
+	if (image != NULL)
+		image_put (image);
+	free (args->buf);
 	return success;
 }
 
@@ -714,21 +1184,25 @@ load_segment (struct file *file, off_t ofs, uint8_t *upage,
 	return true;
 }
 
-/* Create a minimal stack by mapping a zeroed page at the USER_STACK */
+/* Create a minimal stack, with room for SIZE bytes of arguments, by
+ * mapping zeroed pages below the USER_STACK */
 static bool
-setup_stack (struct intr_frame *if_) {
-	uint8_t *kpage;
-	bool success = false;
+setup_stack (struct intr_frame *if_, size_t size) {
+	uint8_t *upage = (uint8_t *) USER_STACK;
 
-	kpage = palloc_get_page (PAL_USER | PAL_ZERO);
-	if (kpage != NULL) {
-		success = install_page (((uint8_t *) USER_STACK) - PGSIZE, kpage, true);
-		if (success)
-			if_->rsp = USER_STACK;
-		else
+	do {
+		uint8_t *kpage = palloc_get_page (PAL_USER | PAL_ZERO);
+
+		upage -= PGSIZE;
+		if (kpage == NULL)
+			return false;
+		if (!install_page (upage, kpage, true)) {
 			palloc_free_page (kpage);
-	}
-	return success;
+			return false;
+		}
+	} while (upage > (uint8_t *) USER_STACK - size);
+	if_->rsp = USER_STACK;
+	return true;
 }
 
 /* Adds a mapping from user virtual address UPAGE to kernel
@@ -756,9 +1230,24 @@ install_page (void *upage, void *kpage, bool writable) {
 
 static bool
 lazy_load_segment (struct page *page, void *aux) {
-	/* TODO: Load the segment from the file */
-	/* TODO: This called when the first page fault occurs on address VA. */
-	/* TODO: VA is available when calling this function. */
+	/* Load the segment from the file */
+	/* This called when the first page fault occurs on address VA. */
+	struct lazy_load_info *info = aux;
+	uint8_t *kva = page->frame->kva;
+	bool lock_held = lock_held_by_current_thread (&filesys_lock);
+	off_t read_bytes;
+
+	/* The fault may come from a system call that already holds the lock. */
+	if (!lock_held)
+		lock_acquire (&filesys_lock);
+	read_bytes = file_read_at (info->file, kva, info->read_bytes, info->ofs);
+	if (!lock_held)
+		lock_release (&filesys_lock);
+
+	if (read_bytes != (off_t) info->read_bytes)
+		return false;
+	memset (kva + info->read_bytes, 0, info->zero_bytes);
+	return true;
 }
 
 /* Loads a segment starting at offset OFS in FILE at address
@@ -782,6 +1271,11 @@ load_segment (struct file *file, off_t ofs, uint8_t *upage,
 	ASSERT (pg_ofs (upage) == 0);
 	ASSERT (ofs % PGSIZE == 0);
 
+	/* Lets the fault handler read the segment ahead. */
+	if (vm_area_create (upage, upage + read_bytes + zero_bytes, file,
+				false) == NULL)
+		return false;
+
 	while (read_bytes > 0 || zero_bytes > 0) {
 		/* Do calculate how to fill this page.
 		 * We will read PAGE_READ_BYTES bytes from FILE
@@ -789,43 +1283,59 @@ load_segment (struct file *file, off_t ofs, uint8_t *upage,
 		size_t page_read_bytes = read_bytes < PGSIZE ? read_bytes : PGSIZE;
 		size_t page_zero_bytes = PGSIZE - page_read_bytes;
 
-		/* TODO: Set up aux to pass information to the lazy_load_segment. */
-		void *aux = NULL;
-		if (!vm_alloc_page_with_initializer (VM_ANON, upage,
-					writable, lazy_load_segment, aux))
+		/* Set up aux to pass information to the lazy_load_segment. */
+		struct lazy_load_info *aux = malloc (sizeof *aux);
+		if (aux == NULL)
 			return false;
+		aux->file = file;
+		aux->ofs = ofs;
+		aux->read_bytes = page_read_bytes;
+		aux->zero_bytes = page_zero_bytes;
+		/* Read-only pages never differ from the file, so they are file
+		 * pages that all instances of the program can share. */
+		if (!vm_alloc_page_with_initializer (writable ? VM_ANON : VM_FILE,
+					upage, writable,
+					writable ? lazy_load_segment : file_lazy_load, aux)) {
+			free (aux);
+			return false;
+		}
 
 		/* Advance. */
 		read_bytes -= page_read_bytes;
 		zero_bytes -= page_zero_bytes;
+		ofs += page_read_bytes;
 		upage += PGSIZE;
 	}
 	return true;
 }
 
-/* Create a PAGE of stack at the USER_STACK. Return true on success. */
+/* Create the stack at the USER_STACK, a PAGE or as many as SIZE bytes of
+ * arguments take. Return true on success. */
 static bool
-setup_stack (struct intr_frame *if_) {
-	bool success = false;
-	void *stack_bottom = (void *) (((uint8_t *) USER_STACK) - PGSIZE);
-
-	/* TODO: Map the stack on stack_bottom and claim the page immediately.
-	 * TODO: If success, set the rsp accordingly.
-	 * TODO: You should mark the page is stack. */
-	/* TODO: Your code goes here */
-
-	return success;
+setup_stack (struct intr_frame *if_, size_t size) {
+	uint8_t *stack_bottom = (uint8_t *) USER_STACK - ROUND_UP (size, PGSIZE);
+
+	if (stack_bottom == (uint8_t *) USER_STACK)
+		stack_bottom -= PGSIZE;
+
+	/* Map the stack on stack_bottom and claim the pages immediately.
+	 * If success, set the rsp accordingly.
+	 * You should mark the page is stack. */
+	for (uint8_t *va = stack_bottom; va < (uint8_t *) USER_STACK; va += PGSIZE)
+		if (!vm_alloc_page (VM_ANON | VM_STACK, va, true)
+				|| !vm_claim_page (va))
+			return false;
+	thread_current ()->spt.stack_bottom = stack_bottom;
+	if_->rsp = USER_STACK;
+	return true;
 }
 #endif /* VM */
-struct thread * get_child(int pid){
+struct child * get_child(int pid){
 	struct thread *curr = thread_current(); // 부모 쓰레드
-	struct list *curr_child_list = &curr->child_list; // 부모의 자식 리스트
-	struct list_elem *e;
-	for (e = list_begin(curr_child_list); e != list_end(curr_child_list); e = list_next(e)){
-		struct thread *now = list_entry(e, struct thread, child_elem);
-		if (now->tid == pid)
-			return now;
-	}
-	return NULL;
-}
+	struct child key; // 부모의 자식 기록에서 tid 로 찾음
+	struct hash_elem *e;
 
+	key.tid = pid;
+	e = hash_find(&curr->children, &key.elem);
+	return e != NULL ? hash_entry(e, struct child, elem) : NULL;
+}
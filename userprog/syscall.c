@@ -11,10 +11,20 @@
 /* 추가해준 헤더 파일들 */
 #include "filesys/filesys.h"
 #include "filesys/file.h"
+#include "filesys/pipe.h"
+#include <limits.h>
 #include <list.h>
+#include <spawn.h>
+#include <string.h>
+#include <sysstat.h>
+#include <uio.h>
 #include "threads/palloc.h"
+#include "threads/malloc.h"
 #include "threads/vaddr.h"
+#include "userprog/aio.h"
 #include "userprog/process.h"
+#include "userprog/uaccess.h"
+#include "userprog/vdso.h"
 #include "threads/synch.h"
 
 
@@ -35,14 +45,41 @@ void seek(int fd, unsigned position);
 unsigned tell(int fd);
 void close(int fd);
 tid_t fork (const char *thread_name);
+int wait(tid_t pid);
+tid_t waitpid(tid_t pid, int *status);
+int sysstat (struct sysstat *stats, unsigned cnt);
+tid_t spawn (const char *file, char *const argv[], const struct spawn_action *actions);
 int exec (const char *file_name);
 int dup2(int oldfd, int newfd);
+int pipe(int *fds);
+int readv(int fd, const struct iovec *iov, int iovcnt);
+int writev(int fd, const struct iovec *iov, int iovcnt);
+int pread(int fd, void *buffer, unsigned size, off_t offset);
+int pwrite(int fd, const void *buffer, unsigned size, off_t offset);
+int sendfile(int out_fd, int in_fd, off_t *offset, unsigned count);
+#ifdef VM
+void *mmap (void *addr, size_t length, int writable, int fd, off_t offset);
+void munmap (void *addr);
+bool memstat (struct memstat *stat);
+int madvise (void *addr, size_t length, int advice);
+int mlock (void *addr, size_t length);
+int munlock (void *addr, size_t length);
+#endif
 
 /* syscall helper functions */
 void check_address(const uint64_t*);
-static struct file *process_get_file(int fd);
+struct file *process_get_file(int fd);
 int process_add_file(struct file *file);
 void process_close_file(int fd);
+void process_close_all_files(void);
+struct file *process_detach_file(int fd);
+static char *copy_in_string(const char *ustr);
+static int read_stdin(uint8_t *buf, unsigned size);
+static int write_stdout(const uint8_t *buf, unsigned size);
+static bool is_console(struct file *f);
+static bool is_pipe(struct file *f);
+static int read_pipe(struct file *f, uint8_t *buf, unsigned size);
+static int write_pipe(struct file *f, const uint8_t *buf, unsigned size);
 
 /* Project2-extra */
 const int STDIN = 1;
@@ -74,6 +111,9 @@ syscall_init (void) {
 			FLAG_IF | FLAG_TF | FLAG_DF | FLAG_IOPL | FLAG_AC | FLAG_NT);
 	/* LOCK INIT 추가*/
 	lock_init(&filesys_lock);
+	aio_init();
+	process_image_init();
+	vdso_init();
 }
 
 /* helper functions letsgo ! */
@@ -83,28 +123,54 @@ void check_address(const uint64_t* addr){
 	/* what if the user provides an invalid pointer, a pointer to kernel memory, 
 	 * or a block partially in one of those regions */
 	/* 잘못된 접근인 경우, 프로세스 종료 */
+#ifdef VM
+	/* Pages are loaded lazily, so the page table alone is not enough. */
+	if (!is_user_vaddr(addr) || addr == NULL
+			|| (spt_find_page(&t->spt, (void *) addr) == NULL
+				&& !vm_stack_grow_for((void *) addr)))
+		exit(-1);
+#else
 	if (!is_user_vaddr(addr) || addr == NULL || pml4_get_page(t->pml4, addr) == NULL)
 		exit(-1);
+#endif
 } 
 
+/* 유저 문자열을 커널 페이지로 복사해서 반환 (호출자가 palloc_free_page 해야 함)
+ * 잘못된 포인터면 프로세스 종료, 한 페이지보다 길면 NULL */
+static char *copy_in_string(const char *ustr){
+	char *kstr = palloc_get_page(0);
+	int len;
+
+	if (kstr == NULL)
+		return NULL;
+	len = strncpy_from_user(kstr, ustr, PGSIZE);
+	if (len < 0){
+		palloc_free_page(kstr);
+		exit(-1);
+	}
+	if (len == PGSIZE){
+		palloc_free_page(kstr);
+		return NULL;
+	}
+	return kstr;
+}
+
+/* 비어있는 가장 작은 fd 에 파일을 넣음 (비트맵으로 찾고, 꽉 차면 테이블을 늘림) */
 int process_add_file(struct file *f){
 	struct thread *curr = thread_current();
-	struct file **curr_fd_table = curr->fd_table;
-	for (int idx = curr->fd_idx; idx < FDCOUNT_LIMIT; idx++){
-		if(curr_fd_table[idx] == NULL){
-			curr_fd_table[idx] = f;
-			curr->fd_idx = idx; 
-			return curr->fd_idx;
-		}
-	}
-	curr->fd_idx = FDCOUNT_LIMIT; // 이게 1 FAIL 의 원인
-	return -1;
+	int fd = fd_table_first_free(curr);
+
+	if (fd == -1)
+		return -1;
+	fd_table_set(curr, fd, f);
+	return fd;
 }
 
 struct file *process_get_file (int fd){
-	if (fd < 0 || fd >= FDCOUNT_LIMIT)
+	struct thread *curr = thread_current();
+	if (fd < 0 || fd >= curr->fd_cap)
 		return NULL;
-	struct file *f = thread_current()->fd_table[fd];
+	struct file *f = curr->fd_table[fd];
 	return f;
 }
 
@@ -112,73 +178,189 @@ struct file *process_get_file (int fd){
 
 
 void process_close_file(int fd){
-	if (fd < 0 || fd > FDCOUNT_LIMIT)
-		return NULL;
-	thread_current()->fd_table[fd] = NULL;
+	struct thread *curr = thread_current();
+	if (fd < 0 || fd >= curr->fd_cap)
+		return;
+	fd_table_set(curr, fd, NULL);
+}
+
+/* 프로세스가 끝날 때 살아있는 fd 만 골라서 닫고 테이블을 해제 */
+void process_close_all_files(void){
+	struct thread *curr = thread_current();
+
+	for (int fd = fd_table_next(curr, 0); fd != -1; fd = fd_table_next(curr, fd + 1))
+		close(fd);
+	fd_table_destroy(curr);
 }
 
 /* helper functions gooooooooooood job */
 
+/* System call handlers: each takes the arguments from F and leaves the
+ * return value in F->R.rax. */
+typedef void syscall_func (struct intr_frame *f);
+
+static void sys_halt (struct intr_frame *f UNUSED) { halt(); }
+static void sys_exit (struct intr_frame *f) { exit(f->R.rdi); }
+static void sys_fork (struct intr_frame *f) {
+	memcpy(&thread_current()->parent_if, f, sizeof(struct intr_frame));
+	f->R.rax = fork((const char *) f->R.rdi);
+}
+static void sys_vfork (struct intr_frame *f) {
+	memcpy(&thread_current()->parent_if, f, sizeof(struct intr_frame));
+	f->R.rax = process_vfork(f);
+}
+static void sys_spawn (struct intr_frame *f) { f->R.rax = spawn((const char *) f->R.rdi, (char *const *) f->R.rsi,
+			(const struct spawn_action *) f->R.rdx); }
+static void sys_exec (struct intr_frame *f) {
+	if (exec((const char *) f->R.rdi) == -1)
+		exit(-1);
+}
+static void sys_wait (struct intr_frame *f) { f->R.rax = wait(f->R.rdi); }
+static void sys_waitpid (struct intr_frame *f) { f->R.rax = waitpid(f->R.rdi, (int *) f->R.rsi); }
+static void sys_create (struct intr_frame *f) { f->R.rax = create((const char *) f->R.rdi, f->R.rsi); }
+static void sys_remove (struct intr_frame *f) { f->R.rax = remove((const char *) f->R.rdi); }
+static void sys_open (struct intr_frame *f) { f->R.rax = open((const char *) f->R.rdi); }
+static void sys_filesize (struct intr_frame *f) { f->R.rax = filesize(f->R.rdi); }
+static void sys_read (struct intr_frame *f) { f->R.rax = read(f->R.rdi, (void *) f->R.rsi, f->R.rdx); }
+static void sys_write (struct intr_frame *f) { f->R.rax = write(f->R.rdi, (const void *) f->R.rsi, f->R.rdx); }
+static void sys_seek (struct intr_frame *f) { seek(f->R.rdi, f->R.rsi); }
+static void sys_tell (struct intr_frame *f) { f->R.rax = tell(f->R.rdi); }
+static void sys_close (struct intr_frame *f) { close(f->R.rdi); }
+static void sys_dup2 (struct intr_frame *f) { f->R.rax = dup2(f->R.rdi, f->R.rsi); }
+static void sys_pipe (struct intr_frame *f) { f->R.rax = pipe((int *) f->R.rdi); }
+static void sys_readv (struct intr_frame *f) { f->R.rax = readv(f->R.rdi, (const struct iovec *) f->R.rsi, f->R.rdx); }
+static void sys_writev (struct intr_frame *f) { f->R.rax = writev(f->R.rdi, (const struct iovec *) f->R.rsi, f->R.rdx); }
+static void sys_pread (struct intr_frame *f) { f->R.rax = pread(f->R.rdi, (void *) f->R.rsi, f->R.rdx, f->R.r10); }
+static void sys_pwrite (struct intr_frame *f) { f->R.rax = pwrite(f->R.rdi, (const void *) f->R.rsi, f->R.rdx, f->R.r10); }
+static void sys_sendfile (struct intr_frame *f) { f->R.rax = sendfile(f->R.rdi, f->R.rsi, (off_t *) f->R.rdx, f->R.r10); }
+static void sys_aio_setup (struct intr_frame *f) { f->R.rax = aio_setup((struct aio_ring *) f->R.rdi); }
+static void sys_aio_enter (struct intr_frame *f) { f->R.rax = aio_enter(f->R.rdi, f->R.rsi); }
+static void sys_sysstat (struct intr_frame *f) { f->R.rax = sysstat((struct sysstat *) f->R.rdi, f->R.rsi); }
+#ifdef VM
+static void sys_mmap (struct intr_frame *f) { f->R.rax = (uint64_t) mmap((void *) f->R.rdi, f->R.rsi, f->R.rdx, f->R.r10, f->R.r8); }
+static void sys_munmap (struct intr_frame *f) { munmap((void *) f->R.rdi); }
+static void sys_memstat (struct intr_frame *f) { f->R.rax = memstat((struct memstat *) f->R.rdi); }
+static void sys_madvise (struct intr_frame *f) { f->R.rax = madvise((void *) f->R.rdi, f->R.rsi, f->R.rdx); }
+static void sys_mlock (struct intr_frame *f) { f->R.rax = mlock((void *) f->R.rdi, f->R.rsi); }
+static void sys_munlock (struct intr_frame *f) { f->R.rax = munlock((void *) f->R.rdi, f->R.rsi); }
+#endif
+
+/* A system call: its handler and its name for the statistics. */
+struct syscall_desc {
+	syscall_func *func;
+	const char *name;
+};
+
+/* 시스템 콜 번호로 바로 찾는 테이블.  비어 있는 번호는 프로세스를 종료시킴 */
+static const struct syscall_desc syscall_table[SYS_CNT] = {
+	[SYS_HALT]      = { sys_halt, "halt" },
+	[SYS_EXIT]      = { sys_exit, "exit" },
+	[SYS_FORK]      = { sys_fork, "fork" },
+	[SYS_EXEC]      = { sys_exec, "exec" },
+	[SYS_WAIT]      = { sys_wait, "wait" },
+	[SYS_CREATE]    = { sys_create, "create" },
+	[SYS_REMOVE]    = { sys_remove, "remove" },
+	[SYS_OPEN]      = { sys_open, "open" },
+	[SYS_FILESIZE]  = { sys_filesize, "filesize" },
+	[SYS_READ]      = { sys_read, "read" },
+	[SYS_WRITE]     = { sys_write, "write" },
+	[SYS_SEEK]      = { sys_seek, "seek" },
+	[SYS_TELL]      = { sys_tell, "tell" },
+	[SYS_CLOSE]     = { sys_close, "close" },
+#ifdef VM
+	[SYS_MMAP]      = { sys_mmap, "mmap" },
+	[SYS_MUNMAP]    = { sys_munmap, "munmap" },
+	[SYS_MEMSTAT]   = { sys_memstat, "memstat" },
+	[SYS_MADVISE]   = { sys_madvise, "madvise" },
+	[SYS_MLOCK]     = { sys_mlock, "mlock" },
+	[SYS_MUNLOCK]   = { sys_munlock, "munlock" },
+#endif
+	[SYS_DUP2]      = { sys_dup2, "dup2" },
+	[SYS_READV]     = { sys_readv, "readv" },
+	[SYS_WRITEV]    = { sys_writev, "writev" },
+	[SYS_PREAD]     = { sys_pread, "pread" },
+	[SYS_PWRITE]    = { sys_pwrite, "pwrite" },
+	[SYS_SENDFILE]  = { sys_sendfile, "sendfile" },
+	[SYS_AIO_SETUP] = { sys_aio_setup, "aio_setup" },
+	[SYS_AIO_ENTER] = { sys_aio_enter, "aio_enter" },
+	[SYS_SPAWN]     = { sys_spawn, "spawn" },
+	[SYS_VFORK]     = { sys_vfork, "vfork" },
+	[SYS_WAITPID]   = { sys_waitpid, "waitpid" },
+	[SYS_SYSSTAT]   = { sys_sysstat, "sysstat" },
+	[SYS_PIPE]      = { sys_pipe, "pipe" },
+};
+
+/* 시스템 콜별 호출 수와 걸린 시간(TSC) 히스토그램, 모든 프로세스 합계 */
+static struct sysstat syscall_stats[SYS_CNT];
+
+/* Returns the latency bucket of a call that took CYCLES cycles. */
+static int
+sysstat_bucket (uint64_t cycles) {
+	int bucket = cycles != 0 ? 63 - __builtin_clzll (cycles) : 0;
+
+	return bucket < SYSSTAT_BUCKETS ? bucket : SYSSTAT_BUCKETS - 1;
+}
+
 /* The main system call interface */
 void
 syscall_handler (struct intr_frame *f UNUSED) {
 	// TODO: Your implementation goes here.
-	int syscall_num = f->R.rax; // rax: system call number
-	switch(syscall_num){
-		case SYS_HALT:                   /* Halt the operating system. */
-			halt();
-			break;
-		case SYS_EXIT:                   /* Terminate this process. */
-			exit(f->R.rdi);
-			break;    
-		case SYS_FORK:  ;                 /* Clone current process. */
-			struct thread *curr = thread_current();
-			memcpy(&curr->parent_if, f, sizeof(struct intr_frame));
-			f->R.rax = fork(f->R.rdi);
-			break;
-		case SYS_EXEC:                   /* Switch current process. */
-			if (exec(f->R.rdi) == -1)
-				exit(-1);
-			break;
-		case SYS_WAIT:                   /* Wait for a child process to die. */
-			f->R.rax = wait(f->R.rdi);
-			break;
-		case SYS_CREATE:                 /* Create a file. */
-			f->R.rax = create(f->R.rdi, f->R.rsi);
-			break;
-		case SYS_REMOVE:                 /* Delete a file. */
-			f->R.rax = remove(f->R.rdi);
-			break;
-		case SYS_OPEN:                   /* Open a file. */
-			f->R.rax = open(f->R.rdi);
-			break;
-		case SYS_FILESIZE:               /* Obtain a file's size. */
-			f->R.rax = filesize(f->R.rdi);
-			break;
-		case SYS_READ:                   /* Read from a file. */
-			f->R.rax = read(f->R.rdi, f->R.rsi, f->R.rdx);
-			break;
-		case SYS_WRITE:                  /* Write to a file. */
-			f->R.rax = write(f->R.rdi, f->R.rsi, f->R.rdx);
-			break;
-		case SYS_SEEK:                   /* Change position in a file. */
-			seek(f->R.rdi, f->R.rsi);
-			break;
-		case SYS_TELL:                   /* Report current position in a file. */
-			f->R.rax = tell(f->R.rdi);
-			break;
-		case SYS_CLOSE:					 /* Close a file. */
-			close(f->R.rdi);
-			break;
-		case SYS_DUP2:
-			f->R.rax = dup2(f->R.rdi, f->R.rsi);
-			break;
-		default:						 /* call thread_exit() ? */
-			exit(-1);
-			break;
+	uint64_t syscall_num = f->R.rax; // rax: system call number
+	struct sysstat *stat;
+	enum intr_level old_level;
+	uint64_t start;
+#ifdef VM
+	/* 커널 안에서 난 스택 fault는 유저 rsp를 알 수 없으므로 저장해둠 */
+	thread_current ()->user_rsp = (void *) f->rsp;
+#endif
+	if (syscall_num >= SYS_CNT || syscall_table[syscall_num].func == NULL)
+		exit(-1);
+	/* write 말고 다른 시스템 콜 전에는 모아둔 출력을 내보내서 순서를 지킴 */
+	if (syscall_num != SYS_WRITE)
+		stdout_flush();
+
+	/* exit 이나 성공한 exec 는 돌아오지 않으므로 호출 수는 먼저 셈 */
+	stat = &syscall_stats[syscall_num];
+	old_level = intr_disable();
+	stat->calls++;
+	intr_set_level(old_level);
+
+	start = rdtsc();
+	syscall_table[syscall_num].func(f);
+	start = rdtsc() - start;
+
+	old_level = intr_disable();
+	stat->timed++;
+	stat->cycles += start;
+	stat->hist[sysstat_bucket(start)]++;
+	intr_set_level(old_level);
+}
+
+/* 시스템 콜 통계 중 앞의 CNT 개(번호 순)를 STATS 에 복사하고 전체 개수를 반환 */
+int sysstat (struct sysstat *stats, unsigned cnt){
+	if (cnt > SYS_CNT)
+		cnt = SYS_CNT;
+	if (!copy_to_user(stats, syscall_stats, cnt * sizeof *stats))
+		exit(-1);
+	return SYS_CNT;
+}
+
+/* Prints the counters of the system calls that were used. */
+void
+syscall_print_stats (void) {
+	for (int i = 0; i < SYS_CNT; i++) {
+		const struct sysstat *stat = &syscall_stats[i];
+
+		if (stat->calls == 0)
+			continue;
+		printf ("Syscall %s: %llu calls, %llu cycles avg, log2 cycles:",
+				syscall_table[i].name, stat->calls,
+				stat->timed != 0 ? stat->cycles / stat->timed : 0);
+		for (int b = 0; b < SYSSTAT_BUCKETS; b++)
+			if (stat->hist[b] != 0)
+				printf (" %d:%llu", b, stat->hist[b]);
+		printf ("\n");
 	}
-	// printf ("system call!\n");
-	// thread_exit ();
 }
 
 //변경사항 
@@ -192,6 +374,11 @@ void halt(void){
 void exit(int status){
 	struct thread *curr = thread_current(); // 실행 중인 스레드 구조체 가져오기
 	curr->exit_status = status;
+	/* A process killed in the middle of a file system call (e.g. a fault on
+	 * its buffer) must not take the lock with it. */
+	if (lock_held_by_current_thread(&filesys_lock))
+		lock_release(&filesys_lock);
+	stdout_flush(); // 종료 메시지보다 먼저 남은 출력을 내보냄
 	printf("%s: exit(%d)\n", thread_name(), status); // if status != 0, error
 	thread_exit(); // 스레드 종료
 }
@@ -204,17 +391,94 @@ tid_t fork (const char *thread_name){
 	/* must return pid of the child process */
 }
 
+/* Start a new process running a program.
+ * 부모 메모리를 복사하지 않고 FILE 을 바로 load 한 자식을 만듦. FILE 과 ARGV[1..]
+ * 를 '\0' 으로 구분해서 그대로 넘기므로 (argv[0] 은 FILE) 인자 안의 공백도 유지됨.
+ * ACTIONS 는 SPAWN_END 로 끝나는 fd 동작 목록 (NULL 이면 없음) */
+tid_t spawn (const char *file, char *const argv[], const struct spawn_action *actions){
+	struct spawn_action acts[SPAWN_ACTIONS_MAX];
+	size_t size = 256, len = 0;
+	char *args = malloc(size);
+	int argc = 0, act_cnt = 0;
+
+	if (args == NULL)
+		return TID_ERROR;
+
+	// 인자들을 하나씩 복사, 버퍼가 모자라면 ARG_MAX 까지 두 배씩 늘림
+	for (int i = 0; ; i++){
+		const char *arg = file;
+		int n;
+
+		if (i > 0){
+			if (argv == NULL)
+				break;
+			if (!copy_from_user(&arg, &argv[i], sizeof arg))
+				goto bad;
+			if (arg == NULL)
+				break;
+		}
+		while ((n = strncpy_from_user(args + len, arg, size - len)) >= 0
+				&& (size_t) n == size - len){
+			char *bigger;
+
+			if (size >= ARG_MAX)
+				goto fail;
+			bigger = realloc(args, size * 2);
+			if (bigger == NULL)
+				goto fail;
+			args = bigger;
+			size *= 2;
+		}
+		if (n < 0)
+			goto bad;
+		len += n + 1;
+		argc++;
+	}
+
+	// fd 동작 목록 복사
+	for (; actions != NULL; act_cnt++){
+		if (act_cnt == SPAWN_ACTIONS_MAX)
+			goto fail;
+		if (!copy_from_user(&acts[act_cnt], &actions[act_cnt], sizeof acts[act_cnt]))
+			goto bad;
+		if (acts[act_cnt].op == SPAWN_END)
+			break;
+	}
+
+	return process_spawn(args, len, argc, acts, act_cnt);
+
+fail:
+	free(args);
+	return TID_ERROR;
+bad:
+	free(args);
+	exit(-1);
+}
+
 /* Switch current process. */
 int exec (const char *file){
-	check_address(file);
-	int size = strlen(file) + 1;
-	char *fn_copy = palloc_get_page(PAL_ZERO);
-	
-	if(fn_copy==NULL)
-		exit(-1);
-	//palloc 쓰는 이유 좀 더 고민해보기(아마 paging과 연관)
-	strlcpy(fn_copy, file, size);
-	if (process_exec(fn_copy) == -1)
+	char *cmd_line = NULL;
+	size_t size = 256;
+	int len;
+
+	/* 명령줄 길이를 모르니 버퍼를 두 배씩 늘려가며 ARG_MAX 까지 복사 */
+	do {
+		free(cmd_line);
+		cmd_line = malloc(size);
+		if (cmd_line == NULL)
+			return -1;
+		len = strncpy_from_user(cmd_line, file, size);
+		if (len < 0){
+			free(cmd_line);
+			exit(-1);
+		}
+		size *= 2;
+	} while ((size_t) len == size / 2 && size <= ARG_MAX);
+	if ((size_t) len == size / 2){
+		free(cmd_line);
+		return -1;
+	}
+	if (process_exec(cmd_line) == -1)
 		return -1;
 
 	NOT_REACHED();
@@ -223,27 +487,55 @@ int exec (const char *file){
 
 /* Wait for a child process to die. */
 int wait(tid_t pid){
-	process_wait(pid);
+	return process_wait(pid);
+}
+
+/* 자식 PID 가 (PID 가 -1 이면 아무 자식이나 먼저) 종료하기를 기다림.
+ * 종료 상태는 STATUS 가 NULL 이 아니면 거기에 저장하고, 자식의 pid 를 반환 */
+tid_t waitpid(tid_t pid, int *status){
+	int exit_status;
+
+	pid = process_waitpid(pid, &exit_status);
+	if (pid != -1 && status != NULL && !copy_to_user(status, &exit_status, sizeof exit_status))
+		exit(-1);
+	return pid;
 }
 
  /* Create a file. */
 bool create(const char *file, unsigned initial_size){
-	check_address(file); // 포인터가 가리키는 주소가 유저영역의 주소인지 확인
-	return filesys_create(file, initial_size); // 파일 이름 & 크기에 해당하는 파일 생성
+	char *name = copy_in_string(file); // 유저 문자열을 커널로 복사 (잘못된 주소면 종료)
+	bool success;
+
+	if (name == NULL)
+		return false;
+	success = filesys_create(name, initial_size); // 파일 이름 & 크기에 해당하는 파일 생성
+	palloc_free_page(name);
+	return success;
 }
 
  /* Delete a file. */
 bool remove(const char *file){
-	check_address(file); // 포인터가 가리키는 주소가 유저영역의 주소인지 확인
-	return filesys_remove(file); // 파일 이름에 해당하는 파일을 제거
+	char *name = copy_in_string(file); // 유저 문자열을 커널로 복사 (잘못된 주소면 종료)
+	bool success;
+
+	if (name == NULL)
+		return false;
+	success = filesys_remove(name); // 파일 이름에 해당하는 파일을 제거
+	palloc_free_page(name);
+	return success;
 }
 
 int open (const char *file){
-	check_address(file);
+	char *name = copy_in_string(file);
+	if (name == NULL)
+		return -1;
 	lock_acquire(&filesys_lock);
-	struct file *f = filesys_open(file); // 파일을 오픈
-	if (f == NULL)
+	struct file *f = filesys_open(name); // 파일을 오픈
+	palloc_free_page(name);
+	if (f == NULL){
+		lock_release(&filesys_lock);
 		return -1;
+	}
 	int fd = process_add_file(f);
 	if (fd == -1)
 		file_close(f);
@@ -254,15 +546,22 @@ int open (const char *file){
 
 int filesize (int fd){
 	struct file *f = process_get_file(fd); // fd를 이용해서 파일 객체 검색
-	if (f == NULL) return -1;
+	if (f == NULL || is_pipe(f)) return -1;
 	return file_length(f);
 }
 
+/* 유저 버퍼의 한 페이지에 남은 바이트 수 (최대 LEFT) */
+static unsigned user_chunk(const void *uaddr, unsigned left){
+	unsigned page_left = PGSIZE - pg_ofs(uaddr);
+	return left < page_left ? left : page_left;
+}
+
 /* 수정완료 */
+/* 파일은 유저 프레임을 고정(pin)해서 그 안으로 바로 읽고 (복사 없음),
+ * 키보드 입력은 한 페이지짜리 커널 버퍼를 거쳐 copy_to_user 로 복사 */
 int read (int fd, void *buffer, unsigned size){
-	check_address(buffer);
-	unsigned char *buf = buffer;
-	int readsize;
+	uint8_t *buf = buffer;
+	int readsize = 0;
 	struct thread *curr = thread_current();
 
 	struct file *f = process_get_file(fd);
@@ -274,32 +573,68 @@ int read (int fd, void *buffer, unsigned size){
 		if(curr->stdin_count == 0){
 			NOT_REACHED();
 			process_close_file(fd);
-			readsize = -1;
-		}
-		else{
-			for (readsize = 0; readsize < size; readsize++){
-				char c = input_getc();
-				*buf++ = c;
-				if (c == '\0')
-					break;
-			}
+			return -1;
 		}
+		return read_stdin(buf, size);
 	}
-	else{
+	if (is_pipe(f))
+		return read_pipe(f, buf, size);
+
+	while ((unsigned) readsize < size){
+		unsigned chunk = user_chunk(buf + readsize, size - readsize);
+		void *kva = user_pin_page(buf + readsize, true);
+		int n;
+
+		if (kva == NULL)
+			exit(-1);
 		lock_acquire(&filesys_lock); // 파일에 동시접근 일어날 수 있으므로 lock 사용
-		readsize = file_read(f, buffer, size);
+		n = file_read(f, kva, chunk);
 		lock_release(&filesys_lock);
+		user_unpin_page(buf + readsize, n, true);
+		readsize += n;
+		if ((unsigned) n < chunk) // EOF
+			break;
 	}
 	return readsize;
 }
 
+/* 키보드에서 '\0' 까지 읽음. '\0' 도 복사하지만 읽은 크기에는 포함하지 않음 */
+static int read_stdin(uint8_t *buf, unsigned size){
+	uint8_t *kbuf = palloc_get_page(0);
+	int readsize = 0;
+
+	if (kbuf == NULL)
+		return -1;
+	while ((unsigned) readsize < size){
+		int chunk = size - readsize < PGSIZE ? size - readsize : PGSIZE;
+		int n;
+
+		for (n = 0; n < chunk; n++){
+			kbuf[n] = input_getc();
+			if (kbuf[n] == '\0')
+				break;
+		}
+		if (!copy_to_user(buf + readsize, kbuf, n < chunk ? n + 1 : n)){
+			palloc_free_page(kbuf);
+			exit(-1);
+		}
+		readsize += n;
+		if (n < chunk)
+			break;
+	}
+	palloc_free_page(kbuf);
+	return readsize;
+}
+
 
 
 /* 수정완료 */
+/* read 와 마찬가지로 파일은 고정한 유저 프레임에서 바로 쓰고,
+ * 콘솔은 copy_from_user 로 커널 버퍼에 옮긴 뒤 출력 */
 int write (int fd, const void *buffer, unsigned size){ 
-	check_address(buffer);
+	const uint8_t *buf = buffer;
 	struct file *f = process_get_file(fd);
-	int writesize;
+	int writesize = 0;
 
 	if (f == NULL) return -1;
 	struct thread *curr = thread_current();
@@ -310,59 +645,194 @@ int write (int fd, const void *buffer, unsigned size){
 		if(curr->stdout_count == 0){
 			NOT_REACHED();
 			process_close_file(fd);
-			writesize = -1;
-		}
-		else{
-			putbuf(buffer, size);// buffer에 들은 size만큼을, 한 번의 호출로 작성해준다.
-			writesize = size;
+			return -1;
 		}
+		return write_stdout(buf, size);
 	}
-	else{
+	if (is_pipe(f))
+		return write_pipe(f, buf, size);
+
+	while ((unsigned) writesize < size){
+		unsigned chunk = user_chunk(buf + writesize, size - writesize);
+		void *kva = user_pin_page((void *) (buf + writesize), false);
+		int n;
+
+		if (kva == NULL)
+			exit(-1);
 		lock_acquire(&filesys_lock); // 파일에 동시접근 일어날 수 있으므로 lock 사용
-		writesize = file_write(f, buffer, size);
+		n = file_write(f, kva, chunk);
 		lock_release(&filesys_lock);
+		user_unpin_page((void *) (buf + writesize), n, false);
+		writesize += n;
+		if ((unsigned) n < chunk)
+			break;
+	}
+	return writesize;
+}
+
+/* 콘솔 출력은 프로세스마다 줄 단위로 모아서 내보냄: 버퍼에는 줄바꿈 없는
+ * 마지막 줄 조각만 남고, 다른 시스템 콜을 하거나 종료하기 전에 비워짐 */
+#define STDOUT_BUFSIZE 1024
+
+/* 유저 버퍼에서 stdout 버퍼로 바로 복사하고, 마지막 줄바꿈까지 (줄바꿈 없이
+ * 버퍼가 가득 차면 전부) 한 번에 출력 */
+static int write_stdout(const uint8_t *buf, unsigned size){
+	struct thread *curr = thread_current();
+	unsigned writesize = 0;
+
+	if (curr->stdout_buf == NULL){
+		curr->stdout_buf = malloc(STDOUT_BUFSIZE);
+		if (curr->stdout_buf == NULL)
+			return -1;
+	}
+	while (writesize < size){
+		char *b = curr->stdout_buf;
+		size_t old_len = curr->stdout_len;
+		size_t chunk = STDOUT_BUFSIZE - old_len;
+		size_t len, line;
+
+		if (chunk > size - writesize)
+			chunk = size - writesize;
+		if (!copy_from_user(b + old_len, buf + writesize, chunk))
+			exit(-1);
+		writesize += chunk;
+		len = old_len + chunk;
+
+		/* 이전 조각에는 줄바꿈이 없으므로 새로 들어온 부분만 찾음 */
+		for (line = len; line > old_len && b[line - 1] != '\n'; line--)
+			continue;
+		if (line == old_len && len == STDOUT_BUFSIZE)
+			line = len;
+		if (line > old_len){
+			putbuf(b, line);
+			memmove(b, b + line, len - line);
+			len -= line;
+		}
+		curr->stdout_len = len;
+	}
+	return writesize;
+}
+
+/* 모아둔 줄 조각을 출력 */
+void stdout_flush(void){
+	struct thread *curr = thread_current();
+
+	if (curr->stdout_len > 0){
+		putbuf(curr->stdout_buf, curr->stdout_len);
+		curr->stdout_len = 0;
+	}
+}
+
+/* 프로세스가 끝날 때 남은 출력을 내보내고 버퍼를 해제 */
+void stdout_release(void){
+	struct thread *curr = thread_current();
+
+	stdout_flush();
+	free(curr->stdout_buf);
+	curr->stdout_buf = NULL;
+}
+
+/* fd 테이블의 콘솔 표시값 (STDIN, STDOUT) 이면 true */
+static bool is_console(struct file *f){
+	uintptr_t v = (uintptr_t) f;
+	return v == (uintptr_t) STDIN || v == (uintptr_t) STDOUT;
+}
+
+/* 콘솔 표시값이 아니고 파이프의 한쪽 끝이면 true */
+static bool is_pipe(struct file *f){
+	return (uintptr_t) f > 2 && f->pipe != NULL;
+}
+
+/* 파일처럼 유저 프레임을 고정하고 파이프에서 바로 읽음.
+ * 비어 있으면 첫 조각에서만 기다리고, 그 뒤로는 있는 만큼만 읽음 */
+static int read_pipe(struct file *f, uint8_t *buf, unsigned size){
+	int readsize = 0;
+
+	if (f->pipe_write_end)
+		return -1;
+	while ((unsigned) readsize < size){
+		unsigned chunk = user_chunk(buf + readsize, size - readsize);
+		void *kva = user_pin_page(buf + readsize, true);
+		int n;
+
+		if (kva == NULL)
+			exit(-1);
+		n = pipe_read(f->pipe, kva, chunk, readsize == 0);
+		user_unpin_page(buf + readsize, n, true);
+		readsize += n;
+		if ((unsigned) n < chunk)
+			break;
+	}
+	return readsize;
+}
+
+/* 유저 프레임을 고정하고 파이프에 바로 씀. 읽는 쪽이 모두 닫혀서 하나도
+ * 못 쓰면 -1, 쓰다가 닫히면 쓴 만큼 반환 */
+static int write_pipe(struct file *f, const uint8_t *buf, unsigned size){
+	int writesize = 0;
+
+	if (!f->pipe_write_end)
+		return -1;
+	while ((unsigned) writesize < size){
+		unsigned chunk = user_chunk(buf + writesize, size - writesize);
+		void *kva = user_pin_page((void *) (buf + writesize), false);
+		int n;
+
+		if (kva == NULL)
+			exit(-1);
+		n = pipe_write(f->pipe, kva, chunk);
+		user_unpin_page((void *) (buf + writesize), n > 0 ? n : 0, false);
+		if (n < 0)
+			return writesize > 0 ? writesize : -1;
+		writesize += n;
+		if ((unsigned) n < chunk)
+			break;
 	}
 	return writesize;
 }
 
 void seek (int fd, unsigned position){
 	struct file *f = process_get_file(fd);
-	if (f > 2)
+	if (f > 2 && !is_pipe(f))
 		file_seek(f, position);
 }
 
 unsigned tell (int fd){
 	struct file *f = process_get_file(fd);
 	if (fd < 2)
-		return;
+		return 0;
 	return file_tell(f);
 }
 
 void close (int fd){
+	struct file *f = process_detach_file(fd);
+
+	if (f != NULL)
+		file_close(f);
+}
+
+/* fd 를 FD 테이블에서 떼어내고, 그 fd 가 갖고 있던 파일 참조를 반환 (호출자가
+ * file_close 로 놓아야 함). 콘솔이면 NULL */
+struct file *process_detach_file(int fd){
 	
 	struct file *f = process_get_file(fd);
 
 	if(f == NULL)
-		return;
+		return NULL;
 	struct thread *curr = thread_current();
 
-	if(fd==0 || f==STDIN)
-		curr->stdin_count--;
-	else if(fd==1 || f==STDOUT)
-		curr->stdout_count--;
-	
 	process_close_file(fd);
 
-	if(fd <= 1 || f <= 2){
-		return;
-	}
-
-	if(f->dup_count == 0){
-		file_close(f);
+	// fd 번호가 아니라 들어있는 게 콘솔인지로 판단 (dup2 로 0, 1 에 파일이 올 수 있음)
+	if(f==STDIN){
+		curr->stdin_count--;
+		return NULL;
 	}
-	else{
-		f->dup_count--;
+	else if(f==STDOUT){
+		curr->stdout_count--;
+		return NULL;
 	}
+	return f;
 }
 
 /* Project 2 : Extra 관련 변경 */
@@ -374,7 +844,8 @@ int dup2(int oldfd, int newfd){
 	if(oldfd == newfd) return newfd;
 
 	struct thread *curr = thread_current();
-	struct file **curr_fd_table = curr->fd_table;
+	// newfd 가 테이블 밖이면 테이블을 늘림
+	if(!fd_table_reserve(curr, newfd)) return -1;
 
 	if(f==STDIN){
 		curr->stdin_count ++;
@@ -383,10 +854,364 @@ int dup2(int oldfd, int newfd){
 		curr->stdout_count ++;
 	}
 	else{
-		f->dup_count++;
+		file_dup(f); // newfd 도 같은 파일(위치 공유)을 가리킴
 	}
 
 	close(newfd);
-	curr_fd_table[newfd] = f;
+	fd_table_set(curr, newfd, f);
 	return newfd;
-}
\ No newline at end of file
+}
+
+/* 파이프를 만들어서 읽는 쪽 fd 를 FDS[0], 쓰는 쪽 fd 를 FDS[1] 에 넣음 */
+int pipe(int *fds){
+	struct file *read_end, *write_end;
+	int kfds[2];
+
+	if (!pipe_create(&read_end, &write_end))
+		return -1;
+	kfds[0] = process_add_file(read_end);
+	kfds[1] = kfds[0] != -1 ? process_add_file(write_end) : -1;
+	if (kfds[1] == -1){
+		if (kfds[0] != -1)
+			process_close_file(kfds[0]);
+		file_close(read_end);
+		file_close(write_end);
+		return -1;
+	}
+	if (!copy_to_user(fds, kfds, sizeof kfds))
+		exit(-1); // 두 fd 는 프로세스가 끝날 때 닫힘
+	return 0;
+}
+
+/* 유저의 iovec 배열을 커널로 복사 (호출자가 free 해야 함)
+ * 잘못된 포인터면 프로세스 종료, 개수나 전체 크기가 잘못되면 NULL */
+static struct iovec *copy_in_iov(const struct iovec *uiov, int iovcnt){
+	struct iovec *iov;
+	size_t total = 0;
+
+	if (iovcnt <= 0 || iovcnt > IOV_MAX)
+		return NULL;
+	iov = malloc(iovcnt * sizeof *iov);
+	if (iov == NULL)
+		return NULL;
+	if (!copy_from_user(iov, uiov, iovcnt * sizeof *iov)){
+		free(iov);
+		exit(-1);
+	}
+	/* 반환값이 int 이므로 전체 크기가 넘치면 안 됨 */
+	for (int i = 0; i < iovcnt; i++){
+		if (iov[i].iov_len > INT_MAX - total){
+			free(iov);
+			return NULL;
+		}
+		total += iov[i].iov_len;
+	}
+	return iov;
+}
+
+/* 벡터 I/O 의 진행 위치: iov[i] 의 done 바이트까지 처리함 */
+struct iov_cursor {
+	const struct iovec *iov;
+	int iovcnt;
+	int i;
+	size_t done;
+};
+
+/* 다 처리한 (혹은 길이가 0 인) 세그먼트를 건너뛰고, 남은 게 있으면 true */
+static bool iov_next(struct iov_cursor *c){
+	while (c->i < c->iovcnt && c->done == c->iov[c->i].iov_len){
+		c->i++;
+		c->done = 0;
+	}
+	return c->i < c->iovcnt;
+}
+
+/* 지금 세그먼트에서 페이지 정렬된 한 페이지를 통째로 처리할 수 있으면 그 주소 */
+static uint8_t *iov_whole_page(struct iov_cursor *c){
+	uint8_t *base = (uint8_t *) c->iov[c->i].iov_base + c->done;
+
+	if (pg_ofs(base) == 0 && c->iov[c->i].iov_len - c->done >= PGSIZE)
+		return base;
+	return NULL;
+}
+
+/* 파일 F 의 OFS 부터 세그먼트들로 읽음. filesys_lock 은 한 번만 잡고,
+ * 작은 세그먼트들은 한 페이지 버퍼에 한 번에 읽어서 (섹터 단위 디스크 읽기) 나눠주고,
+ * 페이지 정렬된 큰 세그먼트는 유저 프레임을 고정해서 그 안으로 바로 읽음 */
+static int file_readv_at(struct file *f, const struct iovec *iov, int iovcnt, off_t ofs){
+	struct iov_cursor c = { iov, iovcnt, 0, 0 };
+	uint8_t *kbuf = palloc_get_page(0);
+	int total = 0;
+
+	if (kbuf == NULL)
+		return -1;
+	lock_acquire(&filesys_lock);
+	while (iov_next(&c)){
+		uint8_t *upage = iov_whole_page(&c);
+		int want = 0, n;
+
+		if (upage != NULL){
+			void *kva = user_pin_page(upage, true);
+			if (kva == NULL){
+				palloc_free_page(kbuf);
+				exit(-1);
+			}
+			n = file_read_at(f, kva, PGSIZE, ofs + total);
+			user_unpin_page(upage, n, true);
+			c.done += n;
+			total += n;
+			if (n < PGSIZE)
+				break;
+			continue;
+		}
+
+		/* 이어지는 세그먼트들에서 최대 한 페이지만큼 */
+		for (int j = c.i; j < iovcnt && want < PGSIZE; j++)
+			want += iov[j].iov_len - (j == c.i ? c.done : 0);
+		if (want > PGSIZE)
+			want = PGSIZE;
+		n = file_read_at(f, kbuf, want, ofs + total);
+
+		for (int k = 0; k < n && iov_next(&c); ){
+			size_t len = iov[c.i].iov_len - c.done;
+			if (len > (size_t) (n - k))
+				len = n - k;
+			if (!copy_to_user((uint8_t *) iov[c.i].iov_base + c.done, kbuf + k, len)){
+				palloc_free_page(kbuf);
+				exit(-1);
+			}
+			k += len;
+			c.done += len;
+		}
+		total += n;
+		if (n < want) // EOF
+			break;
+	}
+	lock_release(&filesys_lock);
+	palloc_free_page(kbuf);
+	return total;
+}
+
+/* 세그먼트들을 파일 F 의 OFS 부터 씀 (F 가 STDOUT 이면 콘솔에 출력).
+ * 읽기와 마찬가지로 작은 세그먼트들은 한 페이지로 모아서 한 번에 씀 */
+static int file_writev_at(struct file *f, const struct iovec *iov, int iovcnt, off_t ofs){
+	struct iov_cursor c = { iov, iovcnt, 0, 0 };
+	uint8_t *kbuf = palloc_get_page(0);
+	bool console = f == STDOUT;
+	int total = 0;
+
+	if (kbuf == NULL)
+		return -1;
+	if (!console)
+		lock_acquire(&filesys_lock);
+	while (iov_next(&c)){
+		uint8_t *upage = console ? NULL : iov_whole_page(&c);
+		int staged = 0, n;
+
+		if (upage != NULL){
+			void *kva = user_pin_page(upage, false);
+			if (kva == NULL){
+				palloc_free_page(kbuf);
+				exit(-1);
+			}
+			n = file_write_at(f, kva, PGSIZE, ofs + total);
+			user_unpin_page(upage, n, false);
+			c.done += n;
+			total += n;
+			if (n < PGSIZE)
+				break;
+			continue;
+		}
+
+		while (staged < PGSIZE && iov_next(&c)){
+			size_t len = iov[c.i].iov_len - c.done;
+			if (len > (size_t) (PGSIZE - staged))
+				len = PGSIZE - staged;
+			if (!copy_from_user(kbuf + staged, (uint8_t *) iov[c.i].iov_base + c.done, len)){
+				palloc_free_page(kbuf);
+				exit(-1);
+			}
+			staged += len;
+			c.done += len;
+		}
+		if (console){
+			putbuf((const char *) kbuf, staged);
+			n = staged;
+		}
+		else
+			n = file_write_at(f, kbuf, staged, ofs + total);
+		total += n;
+		if (n < staged)
+			break;
+	}
+	if (!console)
+		lock_release(&filesys_lock);
+	palloc_free_page(kbuf);
+	return total;
+}
+
+/* Read from a file into several buffers. */
+int readv(int fd, const struct iovec *uiov, int iovcnt){
+	struct file *f = process_get_file(fd);
+	struct iovec *iov;
+	int readsize;
+
+	if (f == NULL || is_console(f) || is_pipe(f)) // 콘솔과 파이프는 read() 를 쓸 것
+		return -1;
+	iov = copy_in_iov(uiov, iovcnt);
+	if (iov == NULL)
+		return -1;
+	readsize = file_readv_at(f, iov, iovcnt, file_tell(f));
+	if (readsize > 0)
+		file_seek(f, file_tell(f) + readsize);
+	free(iov);
+	return readsize;
+}
+
+/* Write several buffers to a file. */
+int writev(int fd, const struct iovec *uiov, int iovcnt){
+	struct file *f = process_get_file(fd);
+	struct iovec *iov;
+	int writesize;
+
+	if (f == NULL || f == STDIN || is_pipe(f))
+		return -1;
+	if (f == STDOUT && thread_current()->stdout_count == 0)
+		return -1;
+	iov = copy_in_iov(uiov, iovcnt);
+	if (iov == NULL)
+		return -1;
+	writesize = file_writev_at(f, iov, iovcnt, f == STDOUT ? 0 : file_tell(f));
+	if (f != STDOUT && writesize > 0)
+		file_seek(f, file_tell(f) + writesize);
+	free(iov);
+	return writesize;
+}
+
+/* Copy from a file to a file or the console.
+ * 유저 메모리를 거치지 않고 커널 페이지 하나로 옮김. OFFSET 이 NULL 이면 IN_FD 의
+ * 현재 위치부터 읽고 위치를 옮기며, 아니면 *OFFSET 부터 읽고 *OFFSET 을 갱신함.
+ * 한 페이지씩 file_read_at 으로 읽어서 file_write_at 이나 putbuf 로 씀 */
+int sendfile(int out_fd, int in_fd, off_t *offset, unsigned count){
+	struct file *in = process_get_file(in_fd);
+	struct file *out = process_get_file(out_fd);
+	bool console = out == STDOUT;
+	uint8_t *kbuf;
+	off_t pos, out_pos = 0;
+	int total = 0;
+
+	if (in == NULL || is_console(in) || out == NULL || out == STDIN)
+		return -1;
+	if (is_pipe(in) || is_pipe(out)) // 파이프는 filesys_lock 을 잡은 채 기다릴 수 없음
+		return -1;
+	if (console && thread_current()->stdout_count == 0)
+		return -1;
+	if (count > INT_MAX)
+		count = INT_MAX;
+	if (offset != NULL){
+		if (!copy_from_user(&pos, offset, sizeof pos))
+			exit(-1);
+		if (pos < 0)
+			return -1;
+	}
+	else
+		pos = file_tell(in);
+
+	kbuf = palloc_get_page(0);
+	if (kbuf == NULL)
+		return -1;
+	lock_acquire(&filesys_lock);
+	if (!console)
+		out_pos = file_tell(out);
+	while ((unsigned) total < count){
+		int chunk = count - total < PGSIZE ? count - total : PGSIZE;
+		int n = file_read_at(in, kbuf, chunk, pos + total);
+		int m;
+
+		if (n <= 0)
+			break;
+		if (console){
+			putbuf((const char *) kbuf, n);
+			m = n;
+		}
+		else
+			m = file_write_at(out, kbuf, n, out_pos + total);
+		total += m;
+		if (m < n || n < chunk)
+			break;
+	}
+	if (!console)
+		file_seek(out, out_pos + total);
+	if (offset == NULL)
+		file_seek(in, pos + total);
+	lock_release(&filesys_lock);
+	palloc_free_page(kbuf);
+
+	if (offset != NULL){
+		pos += total;
+		if (!copy_to_user(offset, &pos, sizeof pos))
+			exit(-1);
+	}
+	return total;
+}
+
+/* Read from a file at a given offset, leaving its position alone. */
+int pread(int fd, void *buffer, unsigned size, off_t offset){
+	struct file *f = process_get_file(fd);
+	struct iovec iov = { buffer, size };
+
+	if (f == NULL || is_console(f) || offset < 0 || size > INT_MAX)
+		return -1;
+	if (is_pipe(f)) // 파이프에는 위치가 없음
+		return -1;
+	return file_readv_at(f, &iov, 1, offset);
+}
+
+/* Write to a file at a given offset, leaving its position alone. */
+int pwrite(int fd, const void *buffer, unsigned size, off_t offset){
+	struct file *f = process_get_file(fd);
+	struct iovec iov = { (void *) buffer, size };
+
+	if (f == NULL || is_console(f) || offset < 0 || size > INT_MAX)
+		return -1;
+	if (is_pipe(f)) // 파이프에는 위치가 없음
+		return -1;
+	return file_writev_at(f, &iov, 1, offset);
+}
+
+#ifdef VM
+/* Map a file into memory. */
+void *mmap (void *addr, size_t length, int writable, int fd, off_t offset){
+	struct file *f = process_get_file(fd);
+
+	/* 콘솔과 파이프는 매핑할 수 없음 */
+	if (f == NULL || is_console(f) || is_pipe(f))
+		return NULL;
+	return do_mmap(addr, length, writable, f, offset);
+}
+
+/* Remove a memory mapping. */
+void munmap (void *addr){
+	do_munmap(addr);
+}
+
+/* Report the memory usage of the current process. */
+bool memstat (struct memstat *stat){
+	if (!copy_to_user(stat, &thread_current()->mem, sizeof *stat))
+		exit(-1);
+	return true;
+}
+
+/* 범위 검사는 vm 쪽에서 함: 매핑 안 된 주소는 -1 반환 (프로세스 종료 X) */
+int madvise (void *addr, size_t length, int advice){
+	return vm_madvise(addr, length, advice) ? 0 : -1;
+}
+
+int mlock (void *addr, size_t length){
+	return vm_mlock(addr, length, true) ? 0 : -1;
+}
+
+int munlock (void *addr, size_t length){
+	return vm_mlock(addr, length, false) ? 0 : -1;
+}
+#endif
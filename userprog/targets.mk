@@ -4,3 +4,6 @@ userprog_SRC += userprog/syscall-entry.S # System call entry.
 userprog_SRC += userprog/syscall.c	# System call handler.
 userprog_SRC += userprog/gdt.c		# GDT initialization.
 userprog_SRC += userprog/tss.c		# TSS management.
+userprog_SRC += userprog/uaccess.c	# Copying to and from user memory.
+userprog_SRC += userprog/aio.c		# Asynchronous file I/O.
+userprog_SRC += userprog/vdso.c		# Kernel data readable without a system call.
@@ -0,0 +1,258 @@
+/* uaccess.c: Copying to and from user memory.
+ *
+ * Each page of a user range is checked once, before it is copied: it must
+ * be a user page the process may access, and writable for copies to user
+ * memory.  Without VM the page table says so and the copy goes through
+ * the kernel's mapping of the frame.  With VM the supplemental page table
+ * says so and the copy goes through the user address, so that pages that
+ * are not loaded yet are faulted in as usual; the read-only vDSO page is
+ * in no supplemental page table and is checked by its address.  A fault that the VM cannot
+ * resolve, e.g. because the page was unmapped meanwhile, does not kill the
+ * process: the copy instructions have entries in the exception fixup table
+ * (see exception.c), and the copy just reports failure.
+ *
+ * Copies move 8 bytes at a time with REP MOVSQ, then the tail with REP
+ * MOVSB.
+ *
+ * File I/O on user buffers does not need a copy at all: user_pin_page()
+ * makes sure a user page is in a frame that stays put and returns its
+ * kernel address, so that the file system reads or writes the frame
+ * directly. */
+
+#include "userprog/uaccess.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "threads/mmu.h"
+#include "threads/thread.h"
+#include "threads/vaddr.h"
+#ifdef VM
+#include "userprog/vdso.h"
+#include "vm/vm.h"
+#endif
+
+/* Longest run strncpy_from_user() copies before looking for the null
+ * terminator. */
+#define STRING_CHUNK 256
+
+/* Statistics. */
+static long long copied_bytes;      /* Bytes moved by the copy functions. */
+static long long pinned_bytes;      /* Bytes moved through pinned frames. */
+
+/* Copies SIZE bytes from SRC to DST, either of which may fault.  Returns
+ * the number of bytes that were not copied, 0 on success. */
+static size_t
+copy_raw (void *dst, const void *src, size_t size) {
+	size_t cnt = size / 8;
+	size_t tail = size % 8;
+
+	asm volatile (
+			"1:	rep movsq\n"
+			"	movq %[tail], %%rcx\n"
+			"2:	rep movsb\n"
+			"3:\n"
+			".pushsection .text.fixup, \"ax\"\n"
+			/* Faulted in the words: RCX words and the tail are left. */
+			"4:	leaq (%[tail], %%rcx, 8), %%rcx\n"
+			"	jmp 3b\n"
+			".popsection\n"
+			".pushsection __ex_table, \"a\"\n"
+			"	.quad 1b, 4b\n"
+			"	.quad 2b, 3b\n"
+			".popsection\n"
+			: "+c" (cnt), "+D" (dst), "+S" (src)
+			: [tail] "r" (tail)
+			: "memory");
+	return cnt;
+}
+
+#ifdef VM
+/* Returns true if UADDR is in the vDSO page, which every process may read
+ * but which is not in any supplemental page table. */
+static bool
+is_vdso_page (const void *uaddr) {
+	return pg_round_down (uaddr) == (void *) VDSO_ADDR;
+}
+
+/* Returns the current process's page that contains UADDR, or a null
+ * pointer if the process may not read it or, if WRITE, write it. */
+static struct page *
+user_spt_page (const void *uaddr, bool write) {
+	struct thread *t = thread_current ();
+	struct page *page;
+
+	if (!is_user_vaddr (uaddr))
+		return NULL;
+	page = spt_find_page (&t->spt, (void *) uaddr);
+
+	/* A system call may be the first to touch a new stack page. */
+	if (page == NULL && vm_stack_grow_for ((void *) uaddr))
+		page = spt_find_page (&t->spt, (void *) uaddr);
+	if (page == NULL || (write && !page->writable))
+		return NULL;
+	return page;
+}
+#else
+/* Returns the kernel address of user address UADDR in the current process,
+ * or a null pointer if the process may not read it or, if WRITE, write
+ * it. */
+static void *
+user_kva (const void *uaddr, bool write) {
+	uint64_t *pte;
+
+	if (!is_user_vaddr (uaddr))
+		return NULL;
+	pte = pml4e_walk (thread_current ()->pml4, (uint64_t) uaddr, false);
+	if (pte == NULL || (*pte & PTE_P) == 0 || (*pte & PTE_U) == 0
+			|| (write && !is_writable (pte)))
+		return NULL;
+	return (uint8_t *) ptov (PTE_ADDR (*pte)) + pg_ofs (uaddr);
+}
+#endif
+
+/* Returns the address through which the current process's user page that
+ * contains UADDR can be copied to or, if WRITE, from the kernel, or a null
+ * pointer if the process may not access it that way. */
+static void *
+user_page (const void *uaddr, bool write) {
+#ifdef VM
+	if (!write && is_vdso_page (uaddr))
+		return (void *) uaddr;
+	return user_spt_page (uaddr, write) != NULL ? (void *) uaddr : NULL;
+#else
+	return user_kva (uaddr, write);
+#endif
+}
+
+/* Returns the number of bytes from ADDR to the end of its page. */
+static size_t
+page_left (const void *addr) {
+	return PGSIZE - pg_ofs (addr);
+}
+
+/* Copies SIZE bytes from user address USRC to DST.  Returns false if some
+ * of them are not readable by the current process; DST is then partly
+ * written. */
+bool
+copy_from_user (void *dst_, const void *usrc_, size_t size) {
+	uint8_t *dst = dst_;
+	const uint8_t *usrc = usrc_;
+
+	while (size > 0) {
+		size_t chunk = page_left (usrc) < size ? page_left (usrc) : size;
+		void *src = user_page (usrc, false);
+
+		if (src == NULL || copy_raw (dst, src, chunk) != 0)
+			return false;
+		copied_bytes += chunk;
+		dst += chunk;
+		usrc += chunk;
+		size -= chunk;
+	}
+	return true;
+}
+
+/* Copies SIZE bytes from SRC to user address UDST.  Returns false if some
+ * of them are not writable by the current process; UDST is then partly
+ * written. */
+bool
+copy_to_user (void *udst_, const void *src_, size_t size) {
+	uint8_t *udst = udst_;
+	const uint8_t *src = src_;
+
+	while (size > 0) {
+		size_t chunk = page_left (udst) < size ? page_left (udst) : size;
+		void *dst = user_page (udst, true);
+
+		if (dst == NULL || copy_raw (dst, src, chunk) != 0)
+			return false;
+		copied_bytes += chunk;
+		udst += chunk;
+		src += chunk;
+		size -= chunk;
+	}
+	return true;
+}
+
+/* Copies the null-terminated string at user address USRC, terminator
+ * included, into DST, which has room for SIZE bytes.  Returns the length
+ * of the string, SIZE if it does not fit (DST is then not terminated), or
+ * -1 if it is not readable by the current process. */
+int
+strncpy_from_user (char *dst, const char *usrc, size_t size) {
+	size_t copied = 0;
+
+	while (copied < size) {
+		size_t chunk = size - copied;
+		const void *src = user_page (usrc + copied, false);
+		char *nul;
+
+		if (chunk > page_left (usrc + copied))
+			chunk = page_left (usrc + copied);
+		if (chunk > STRING_CHUNK)
+			chunk = STRING_CHUNK;
+		if (src == NULL || copy_raw (dst + copied, src, chunk) != 0)
+			return -1;
+		copied_bytes += chunk;
+
+		nul = memchr (dst + copied, '\0', chunk);
+		if (nul != NULL)
+			return nul - dst;
+		copied += chunk;
+	}
+	return size;
+}
+
+/* Makes sure the current process's user page that contains UADDR is in a
+ * frame that stays there until user_unpin_page(), and returns the kernel
+ * address of UADDR in it.  Returns a null pointer if the process may not
+ * read the page or, if WRITE, write it. */
+void *
+user_pin_page (void *uaddr, bool write) {
+#ifdef VM
+	struct page *page;
+
+	/* The vDSO page is never evicted. */
+	if (is_vdso_page (uaddr))
+		return write ? NULL : pml4_get_page (thread_current ()->pml4, uaddr);
+
+	page = user_spt_page (uaddr, write);
+	if (page == NULL || !vm_pin_page (page))
+		return NULL;
+	return (uint8_t *) page->frame->kva + pg_ofs (uaddr);
+#else
+	/* Without VM, user pages never move. */
+	return user_kva (uaddr, write);
+#endif
+}
+
+/* Releases the user page that contains UADDR, pinned by user_pin_page(),
+ * after SIZE bytes were moved through it, into it if WRITTEN. */
+void
+user_unpin_page (void *uaddr, size_t size, bool written) {
+	pinned_bytes += size;
+#ifdef VM
+	struct thread *t = thread_current ();
+	struct page *page;
+
+	if (is_vdso_page (uaddr))
+		return;
+	page = spt_find_page (&t->spt, uaddr);
+
+	/* The kernel wrote through its own mapping, which the user's dirty
+	 * bit does not see. */
+	if (written && size > 0)
+		pml4_set_dirty (t->pml4, page->va, true);
+	vm_unpin_page (page);
+#else
+	(void) uaddr;
+	(void) written;
+#endif
+}
+
+/* Prints statistics about user memory accesses. */
+void
+uaccess_print_stats (void) {
+	printf ("User access: %lld bytes copied, %lld bytes through pinned "
+			"frames\n", copied_bytes, pinned_bytes);
+}
@@ -0,0 +1,70 @@
+/* vdso.c: The page of kernel data that processes read without a system
+ * call (see lib/vdso.h).
+ *
+ * There is a single page, mapped read-only into every process.  It is
+ * not in any supplemental page table: it is mapped when a page table is
+ * created for a process and unmapped before the page table is destroyed,
+ * which would otherwise free it. */
+
+#include "userprog/vdso.h"
+#include <debug.h>
+#include "devices/timer.h"
+#include "threads/mmu.h"
+#include "threads/palloc.h"
+#include "threads/thread.h"
+#include "intrinsic.h"
+
+/* Keeps the compiler from moving memory accesses across it. */
+#define barrier() asm volatile ("" : : : "memory")
+
+static struct vdso_data *vdso;      /* The page, null until vdso_init(). */
+static int64_t first_tick;          /* Tick at which calibration started. */
+static uint64_t first_tsc;          /* TSC at FIRST_TICK. */
+
+/* Allocates the page. */
+void
+vdso_init (void) {
+	vdso = palloc_get_page (PAL_ASSERT | PAL_ZERO);
+	vdso->timer_freq = TIMER_FREQ;
+}
+
+/* Publishes the time at timer tick TICKS.  Called from the timer
+ * interrupt. */
+void
+vdso_tick (int64_t ticks) {
+	uint64_t tsc = rdtsc ();
+
+	if (vdso == NULL)
+		return;
+
+	vdso->seq++;
+	barrier ();
+	vdso->ticks = ticks;
+	vdso->tick_tsc = tsc;
+	if (first_tick == 0) {
+		first_tick = ticks;
+		first_tsc = tsc;
+	} else
+		vdso->tsc_per_tick = (tsc - first_tsc) / (ticks - first_tick);
+	barrier ();
+	vdso->seq++;
+}
+
+/* Records that NEXT is about to run.  Called on every context switch. */
+void
+vdso_activate (struct thread *next) {
+	if (vdso != NULL)
+		vdso->tid = next->tid;
+}
+
+/* Maps the page read-only at VDSO_ADDR in PML4. */
+bool
+vdso_map (uint64_t *pml4) {
+	return pml4_set_page (pml4, (void *) VDSO_ADDR, vdso, false);
+}
+
+/* Unmaps the page from PML4 so that destroying PML4 does not free it. */
+void
+vdso_unmap (uint64_t *pml4) {
+	pml4_clear_page (pml4, (void *) VDSO_ADDR);
+}
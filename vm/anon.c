@@ -1,7 +1,16 @@
 /* anon.c: Implementation of page for non-disk image (a.k.a. anonymous page). */
 
+#include <bitmap.h>
+#include <string.h>
 #include "vm/vm.h"
+#include "vm/zswap.h"
 #include "devices/disk.h"
+#include "threads/synch.h"
+#include "threads/vaddr.h"
+#include "intrinsic.h"
+
+/* Number of disk sectors in one swap slot. */
+#define SECTORS_PER_PAGE (PGSIZE / DISK_SECTOR_SIZE)
 
 /* DO NOT MODIFY BELOW LINE */
 static struct disk *swap_disk;
@@ -9,6 +18,10 @@ static bool anon_swap_in (struct page *page, void *kva);
 static bool anon_swap_out (struct page *page);
 static void anon_destroy (struct page *page);
 
+/* In-use slots of swap_disk. */
+static struct bitmap *swap_table;
+static struct lock swap_lock;
+
 /* DO NOT MODIFY this struct */
 static const struct page_operations anon_ops = {
 	.swap_in = anon_swap_in,
@@ -20,33 +33,149 @@ static const struct page_operations anon_ops = {
 /* Initialize the data for anonymous pages */
 void
 vm_anon_init (void) {
-	/* TODO: Set up the swap_disk. */
-	swap_disk = NULL;
+	/* Set up the swap_disk. */
+	size_t slot_cnt = 0;
+
+	swap_disk = disk_get (1, 1);
+	if (swap_disk != NULL)
+		slot_cnt = disk_size (swap_disk) / SECTORS_PER_PAGE;
+	swap_table = bitmap_create (slot_cnt);
+	if (swap_table == NULL)
+		PANIC ("swap table creation failed");
+	lock_init (&swap_lock);
+	zswap_init ();
 }
 
 /* Initialize the file mapping */
 bool
-anon_initializer (struct page *page, enum vm_type type, void *kva) {
+anon_initializer (struct page *page, enum vm_type type UNUSED, void *kva) {
 	/* Set up the handler */
 	page->operations = &anon_ops;
 
 	struct anon_page *anon_page = &page->anon;
+	anon_page->state = ANON_RESIDENT;
+	anon_page->ksm_sum = 0;
+	anon_page->ksm_cand = false;
+
+	/* Fresh anonymous memory reads as zeroes. */
+	memset (kva, 0, PGSIZE);
+	return true;
+}
+
+/* Returns true if the PGSIZE bytes at KVA are all zero. */
+static bool
+page_is_zero (const void *kva) {
+	const uint64_t *p = kva;
+	size_t i;
+
+	for (i = 0; i < PGSIZE / sizeof *p; i++)
+		if (p[i] != 0)
+			return false;
+	return true;
+}
+
+/* Releases the swap slot SLOT. */
+static void
+swap_slot_free (size_t slot) {
+	lock_acquire (&swap_lock);
+	bitmap_reset (swap_table, slot);
+	lock_release (&swap_lock);
 }
 
 /* Swap in the page by read contents from the swap disk. */
 static bool
 anon_swap_in (struct page *page, void *kva) {
 	struct anon_page *anon_page = &page->anon;
+	uint64_t start = rdtsc ();
+	enum zswap_tier tier;
+	size_t i;
+
+	switch (anon_page->state) {
+		case ANON_KSM:
+			/* Written to after being merged: not timed as a swap-in. */
+			if (!ksm_unmerge (page, kva))
+				return false;
+			anon_page->state = ANON_RESIDENT;
+			return true;
+		case ANON_SWAP_ZERO:
+			memset (kva, 0, PGSIZE);
+			tier = ZSWAP_TIER_ZERO;
+			break;
+		case ANON_SWAP_POOL:
+			if (!zswap_load (anon_page->handle, kva))
+				return false;
+			zswap_free (anon_page->handle);
+			tier = ZSWAP_TIER_POOL;
+			break;
+		case ANON_SWAP_DISK:
+			for (i = 0; i < SECTORS_PER_PAGE; i++)
+				disk_read (swap_disk, anon_page->swap_slot * SECTORS_PER_PAGE + i,
+						kva + i * DISK_SECTOR_SIZE);
+			swap_slot_free (anon_page->swap_slot);
+			tier = ZSWAP_TIER_DISK;
+			break;
+		default:
+			return false;
+	}
+
+	anon_page->state = ANON_RESIDENT;
+	zswap_count_in (tier, rdtsc () - start);
+	return true;
 }
 
-/* Swap out the page by writing contents to the swap disk. */
+/* Swap out the page by writing contents to the swap disk.
+ * All-zero pages are only remembered as such, other pages are compressed
+ * into the zswap pool if they fit and written to a swap slot otherwise. */
 static bool
 anon_swap_out (struct page *page) {
 	struct anon_page *anon_page = &page->anon;
+	void *kva = page->frame->kva;
+	size_t slot, i;
+
+	if (page_is_zero (kva)) {
+		anon_page->state = ANON_SWAP_ZERO;
+		zswap_count_out (ZSWAP_TIER_ZERO);
+		return true;
+	}
+
+	if (zswap_store (kva, &anon_page->handle)) {
+		anon_page->state = ANON_SWAP_POOL;
+		zswap_count_out (ZSWAP_TIER_POOL);
+		return true;
+	}
+
+	lock_acquire (&swap_lock);
+	slot = bitmap_scan_and_flip (swap_table, 0, 1, false);
+	lock_release (&swap_lock);
+	if (slot == BITMAP_ERROR)
+		return false;
+
+	for (i = 0; i < SECTORS_PER_PAGE; i++)
+		disk_write (swap_disk, slot * SECTORS_PER_PAGE + i,
+				kva + i * DISK_SECTOR_SIZE);
+	anon_page->swap_slot = slot;
+	anon_page->state = ANON_SWAP_DISK;
+	zswap_count_out (ZSWAP_TIER_DISK);
+	return true;
 }
 
 /* Destroy the anonymous page. PAGE will be freed by the caller. */
 static void
 anon_destroy (struct page *page) {
 	struct anon_page *anon_page = &page->anon;
+
+	/* Waits out an eviction in progress, so the state below is final. */
+	vm_free_frame (page);
+	vm_zero_unmap (page);
+	ksm_forget (page);
+
+	if (anon_page->state == ANON_SWAP_ZERO
+			|| anon_page->state == ANON_SWAP_POOL
+			|| anon_page->state == ANON_SWAP_DISK)
+		vm_account_swap_free (page);
+	if (anon_page->state == ANON_SWAP_POOL)
+		zswap_free (anon_page->handle);
+	else if (anon_page->state == ANON_SWAP_DISK)
+		swap_slot_free (anon_page->swap_slot);
+	anon_page->state = ANON_RESIDENT;
 }
@@ -1,6 +1,13 @@
 /* file.c: Implementation of memory backed file object (mmaped object). */
 
+#include <round.h>
+#include <string.h>
+#include <vdso.h>
 #include "vm/vm.h"
+#include "threads/malloc.h"
+#include "threads/mmu.h"
+#include "threads/vaddr.h"
+#include "userprog/syscall.h"
 
 static bool file_backed_swap_in (struct page *page, void *kva);
 static bool file_backed_swap_out (struct page *page);
@@ -21,38 +28,207 @@ vm_file_init (void) {
 
 /* Initialize the file backed page */
 bool
-file_backed_initializer (struct page *page, enum vm_type type, void *kva) {
+file_backed_initializer (struct page *page, enum vm_type type UNUSED,
+		void *kva UNUSED) {
 	/* Set up the handler */
 	page->operations = &file_ops;
 
+	/* The contents are filled in by file_lazy_load(), which gets the
+	 * lazy_load_info that says where they come from. */
 	struct file_page *file_page = &page->file;
+	file_page->file = NULL;
+	file_page->share = NULL;
+	return true;
+}
+
+/* Initializer of the pages of an mmap()ed region: records where the page
+ * lives in the file and reads it in.  AUX is a struct lazy_load_info. */
+bool
+file_lazy_load (struct page *page, void *aux) {
+	struct lazy_load_info *info = aux;
+	struct file_page *file_page = &page->file;
+
+	file_page->file = info->file;
+	file_page->ofs = info->ofs;
+	file_page->read_bytes = info->read_bytes;
+	file_page->zero_bytes = info->zero_bytes;
+	return file_backed_swap_in (page, page->frame->kva);
+}
+
+/* Turns PAGE, an uninit page of type VM_FILE that was never loaded, into a
+ * file page without loading it, so that it can map a shared frame from the
+ * page index instead. */
+void
+file_backed_adopt (struct page *page) {
+	struct lazy_load_info *info = page->uninit.aux;
+	struct file_page *file_page = &page->file;
+
+	ASSERT (VM_TYPE (page->operations->type) == VM_UNINIT);
+	ASSERT (page->uninit.init == file_lazy_load);
+
+	file_backed_initializer (page, VM_FILE, NULL);
+	file_page->file = info->file;
+	file_page->ofs = info->ofs;
+	file_page->read_bytes = info->read_bytes;
+	file_page->zero_bytes = info->zero_bytes;
+	free (info);
 }
 
 /* Swap in the page by read contents from the file. */
 static bool
 file_backed_swap_in (struct page *page, void *kva) {
-	struct file_page *file_page UNUSED = &page->file;
+	struct file_page *file_page = &page->file;
+	bool lock_held = lock_held_by_current_thread (&filesys_lock);
+	off_t read_bytes;
+
+	/* The fault may come from a system call that already holds the lock. */
+	if (!lock_held)
+		lock_acquire (&filesys_lock);
+	read_bytes = file_read_at (file_page->file, kva, file_page->read_bytes,
+			file_page->ofs);
+	if (!lock_held)
+		lock_release (&filesys_lock);
+
+	if (read_bytes != (off_t) file_page->read_bytes)
+		return false;
+	memset ((uint8_t *) kva + file_page->read_bytes, 0, file_page->zero_bytes);
+	return true;
+}
+
+/* Writes PAGE back to its file if the user modified it, from KVA. */
+static void
+file_backed_writeback (struct page *page, void *kva) {
+	struct file_page *file_page = &page->file;
+	uint64_t *pml4 = page->owner->pml4;
+
+	if (pml4 == NULL || !pml4_is_dirty (pml4, page->va))
+		return;
+	file_write_at (file_page->file, kva, file_page->read_bytes, file_page->ofs);
+	pml4_set_dirty (pml4, page->va, false);
 }
 
 /* Swap out the page by writeback contents to the file. */
 static bool
 file_backed_swap_out (struct page *page) {
-	struct file_page *file_page UNUSED = &page->file;
+	uint64_t *pml4 = page->owner->pml4;
+	bool lock_held = lock_held_by_current_thread (&filesys_lock);
+
+	/* Called with the frame table locked.  Another thread may be waiting
+	 * for a frame while it holds the file system lock, so do not block on
+	 * it here: fail and let the evictor pick a different victim. */
+	if (pml4 != NULL && pml4_is_dirty (pml4, page->va)) {
+		if (!lock_held && !lock_try_acquire (&filesys_lock))
+			return false;
+		file_backed_writeback (page, page->frame->kva);
+		if (!lock_held)
+			lock_release (&filesys_lock);
+	}
+	return true;
 }
 
 /* Destory the file backed page. PAGE will be freed by the caller. */
 static void
 file_backed_destroy (struct page *page) {
-	struct file_page *file_page UNUSED = &page->file;
+	/* Only the owner maps a shared frame, so this cannot become true
+	 * behind our back. */
+	if (page->file.share != NULL)
+		vm_share_unmap (page);
+
+	if (vm_pin_resident (page)) {
+		bool lock_held = lock_held_by_current_thread (&filesys_lock);
+
+		if (!lock_held)
+			lock_acquire (&filesys_lock);
+		file_backed_writeback (page, page->frame->kva);
+		if (!lock_held)
+			lock_release (&filesys_lock);
+	}
+	vm_free_frame (page);
 }
 
 /* Do the mmap */
 void *
 do_mmap (void *addr, size_t length, int writable,
 		struct file *file, off_t offset) {
+	struct vm_area *area;
+	struct file *mfile;
+	off_t file_len;
+	uint8_t *upage = addr;
+	size_t page_cnt;
+
+	if (addr == NULL || pg_ofs (addr) != 0 || length == 0
+			|| offset < 0 || pg_ofs (offset) != 0)
+		return NULL;
+	page_cnt = DIV_ROUND_UP (length, PGSIZE);
+	if (!is_user_vaddr (addr)
+			|| (uintptr_t) addr + page_cnt * PGSIZE < (uintptr_t) addr
+			|| !is_user_vaddr (addr + page_cnt * PGSIZE - 1))
+		return NULL;
+	/* The vDSO page is mapped there, outside the page table. */
+	if ((uintptr_t) addr <= VDSO_ADDR
+			&& VDSO_ADDR < (uintptr_t) addr + page_cnt * PGSIZE)
+		return NULL;
+	for (size_t i = 0; i < page_cnt; i++)
+		if (spt_find_page (&thread_current ()->spt, upage + i * PGSIZE))
+			return NULL;
+
+	/* The mapping outlives the descriptor it was made from. */
+	lock_acquire (&filesys_lock);
+	mfile = file_reopen (file);
+	file_len = mfile != NULL ? file_length (mfile) : 0;
+	lock_release (&filesys_lock);
+	if (file_len == 0)
+		goto fail;
+
+	area = vm_area_create (addr, upage + page_cnt * PGSIZE, mfile, true);
+	if (area == NULL)
+		goto fail;
+
+	for (size_t i = 0; i < page_cnt; i++, upage += PGSIZE, offset += PGSIZE) {
+		size_t left = offset < file_len ? file_len - offset : 0;
+		struct lazy_load_info *aux = malloc (sizeof *aux);
+
+		if (aux == NULL) {
+			do_munmap (addr);
+			return NULL;
+		}
+		aux->file = mfile;
+		aux->ofs = offset;
+		aux->read_bytes = left < PGSIZE ? left : PGSIZE;
+		aux->zero_bytes = PGSIZE - aux->read_bytes;
+		if (!vm_alloc_page_with_initializer (VM_FILE, upage, writable,
+					file_lazy_load, aux)) {
+			free (aux);
+			do_munmap (addr);
+			return NULL;
+		}
+	}
+	return addr;
+
+fail:
+	if (mfile != NULL) {
+		lock_acquire (&filesys_lock);
+		file_close (mfile);
+		lock_release (&filesys_lock);
+	}
+	return NULL;
 }
 
 /* Do the munmap */
 void
 do_munmap (void *addr) {
+	struct supplemental_page_table *spt = &thread_current ()->spt;
+	struct vm_area *area = vm_area_find (addr);
+
+	if (area == NULL || !area->mmapped || area->start != addr)
+		return;
+
+	/* Dirty pages are written back as they are destroyed. */
+	for (uint8_t *upage = area->start; upage < (uint8_t *) area->end;
+			upage += PGSIZE) {
+		struct page *page = spt_find_page (spt, upage);
+		if (page != NULL)
+			spt_remove_page (spt, page);
+	}
+	vm_area_destroy (area);
 }
@@ -0,0 +1,304 @@
+/* ksm.c: Kernel same-page merging for anonymous memory.
+ *
+ * Forked children and several instances of one program hold many pages
+ * with the same contents.  When enabled, a kernel thread walks the frame
+ * table, ksm_scan_rate pages per second, and checksums every resident
+ * anonymous page it passes.  A page whose checksum did not change since the
+ * previous visit is looked up in the stable table of frames that are
+ * already shared, and failing that in the unstable table of other
+ * candidates with the same checksum.  Pages with identical contents give up
+ * their frames and are mapped read-only to one shared ksm_node.  The first
+ * write to such a page faults, and ksm_unmerge() copies the contents back
+ * into a private frame.
+ *
+ * Shared frames are not in the frame table, so they are never evicted. */
+
+#include "vm/ksm.h"
+#include <debug.h>
+#include <hash.h>
+#include <stdio.h>
+#include <string.h>
+#include "devices/timer.h"
+#include "threads/malloc.h"
+#include "threads/mmu.h"
+#include "threads/palloc.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+#include "threads/vaddr.h"
+#include "vm/vm.h"
+
+/* The scanner wakes up this many times per second. */
+#define KSM_WAKEUPS_PER_SEC 10
+
+size_t ksm_scan_rate;
+
+/* A frame shared by all the pages with its contents. */
+struct ksm_node {
+	struct hash_elem elem;      /* Element of stable_table. */
+	uint64_t sum;               /* Checksum of the contents. */
+	void *kva;                  /* The contents, never modified. */
+	int ref_cnt;                /* Pages mapped to it. */
+};
+
+static struct hash stable_table;    /* ksm_nodes, by contents. */
+static struct hash unstable_table;  /* Candidate pages, by checksum. */
+static struct lock ksm_lock;        /* Protects both tables and the nodes. */
+
+/* Statistics. */
+static long long scan_cnt;          /* Pages checksummed. */
+static long long merge_cnt;         /* Pages mapped to a ksm_node. */
+static long long unmerge_cnt;       /* Merged pages written to. */
+static long long sharing_cnt;       /* Pages mapped to a ksm_node now. */
+static long long node_cnt;          /* ksm_nodes now. */
+static int64_t start_ticks;         /* When the scanner started. */
+
+static uint64_t
+node_hash (const struct hash_elem *e, void *aux UNUSED) {
+	return hash_entry (e, struct ksm_node, elem)->sum;
+}
+
+/* Orders nodes by checksum, then by contents, so that a lookup only ever
+ * finds a node with exactly the contents looked for. */
+static bool
+node_less (const struct hash_elem *a_, const struct hash_elem *b_,
+		void *aux UNUSED) {
+	const struct ksm_node *a = hash_entry (a_, struct ksm_node, elem);
+	const struct ksm_node *b = hash_entry (b_, struct ksm_node, elem);
+
+	if (a->sum != b->sum)
+		return a->sum < b->sum;
+	return memcmp (a->kva, b->kva, PGSIZE) < 0;
+}
+
+static uint64_t
+cand_hash (const struct hash_elem *e, void *aux UNUSED) {
+	return hash_entry (e, struct page, anon.ksm_elem)->anon.ksm_sum;
+}
+
+/* Candidates are only ordered by checksum: their contents may change at
+ * any time.  There is at most one candidate per checksum. */
+static bool
+cand_less (const struct hash_elem *a, const struct hash_elem *b,
+		void *aux UNUSED) {
+	return hash_entry (a, struct page, anon.ksm_elem)->anon.ksm_sum
+		< hash_entry (b, struct page, anon.ksm_elem)->anon.ksm_sum;
+}
+
+/* Removes PAGE from the unstable table, if it is there. */
+static void
+cand_remove (struct page *page) {
+	if (page->anon.ksm_cand) {
+		hash_delete (&unstable_table, &page->anon.ksm_elem);
+		page->anon.ksm_cand = false;
+	}
+}
+
+/* Drops one reference to NODE, freeing it with the last one. */
+static void
+node_put (struct ksm_node *node) {
+	ASSERT (lock_held_by_current_thread (&ksm_lock));
+
+	sharing_cnt--;
+	if (--node->ref_cnt == 0) {
+		hash_delete (&stable_table, &node->elem);
+		palloc_free_page (node->kva);
+		free (node);
+		node_cnt--;
+	}
+}
+
+/* Maps PAGE, whose frame was just taken away, read-only to NODE. */
+static void
+node_map (struct ksm_node *node, struct page *page) {
+	pml4_set_page (page->owner->pml4, page->va, node->kva, false);
+	page->anon.state = ANON_KSM;
+	page->anon.ksm = node;
+	node->ref_cnt++;
+	sharing_cnt++;
+	merge_cnt++;
+}
+
+/* Unmaps PAGE so that its owner cannot change it while it is compared. */
+static void
+page_freeze (struct page *page) {
+	pml4_clear_page (page->owner->pml4, page->va);
+}
+
+/* Maps PAGE back into its own frame after a failed comparison.  An owner
+ * that faulted in the meantime finds it mapped and retries. */
+static void
+page_thaw (struct page *page) {
+	pml4_set_page (page->owner->pml4, page->va, page->frame->kva,
+			page->writable);
+}
+
+/* Merges PAGE into NODE if they still have the same contents. */
+static bool
+merge_page (struct page *page, struct ksm_node *node) {
+	page_freeze (page);
+	if (memcmp (page->frame->kva, node->kva, PGSIZE)) {
+		page_thaw (page);
+		return false;
+	}
+	palloc_free_page (vm_frame_steal (page));
+	node_map (node, page);
+	return true;
+}
+
+/* Turns CAND's frame into a new ksm_node with checksum SUM and merges PAGE
+ * into it, if both pages still have the same contents. */
+static bool
+merge_pair (struct page *page, struct page *cand, uint64_t sum) {
+	struct ksm_node *node;
+
+	page_freeze (cand);
+	page_freeze (page);
+	if (memcmp (page->frame->kva, cand->frame->kva, PGSIZE)
+			|| (node = malloc (sizeof *node)) == NULL) {
+		page_thaw (page);
+		page_thaw (cand);
+		return false;
+	}
+
+	node->sum = sum;
+	node->kva = vm_frame_steal (cand);
+	node->ref_cnt = 0;
+	hash_insert (&stable_table, &node->elem);
+	node_cnt++;
+	node_map (node, cand);
+
+	palloc_free_page (vm_frame_steal (page));
+	node_map (node, page);
+	return true;
+}
+
+/* Visits one resident anonymous page for the scanner.  Called with the
+ * frame table locked. */
+static void
+ksm_scan_page (struct page *page) {
+	struct anon_page *anon = &page->anon;
+	void *kva = page->frame->kva;
+	uint64_t sum = hash_bytes (kva, PGSIZE);
+	struct ksm_node key;
+	struct hash_elem *e;
+
+	if (page->owner->pml4 == NULL)
+		return;
+	scan_cnt++;
+
+	lock_acquire (&ksm_lock);
+
+	/* Contents that are shared already? */
+	key.sum = sum;
+	key.kva = kva;
+	e = hash_find (&stable_table, &key.elem);
+	if (e != NULL) {
+		if (merge_page (page, hash_entry (e, struct ksm_node, elem)))
+			cand_remove (page);
+		goto done;
+	}
+
+	/* Pages that keep changing are not worth merging. */
+	if (sum != anon->ksm_sum) {
+		cand_remove (page);
+		anon->ksm_sum = sum;
+		goto done;
+	}
+
+	/* Another page seen with the same checksum? */
+	e = hash_find (&unstable_table, &anon->ksm_elem);
+	if (e != NULL) {
+		struct page *cand = hash_entry (e, struct page, anon.ksm_elem);
+
+		if (cand == page)
+			goto done;
+		cand_remove (cand);
+		if (cand->frame != NULL && !cand->frame->pinned
+				&& cand->owner->pml4 != NULL
+				&& merge_pair (page, cand, sum)) {
+			cand_remove (page);
+			goto done;
+		}
+	}
+	if (!anon->ksm_cand && hash_insert (&unstable_table, &anon->ksm_elem) == NULL)
+		anon->ksm_cand = true;
+
+done:
+	lock_release (&ksm_lock);
+}
+
+/* The scanner thread. */
+static void
+ksm_thread (void *aux UNUSED) {
+	size_t batch = ksm_scan_rate / KSM_WAKEUPS_PER_SEC;
+
+	if (batch == 0)
+		batch = 1;
+	start_ticks = timer_ticks ();
+	for (;;) {
+		timer_sleep (TIMER_FREQ / KSM_WAKEUPS_PER_SEC);
+		vm_scan_anon (batch, ksm_scan_page);
+	}
+}
+
+/* Sets up same-page merging and starts the scanner if it is enabled. */
+void
+ksm_init (void) {
+	hash_init (&stable_table, node_hash, node_less, NULL);
+	hash_init (&unstable_table, cand_hash, cand_less, NULL);
+	lock_init (&ksm_lock);
+	if (ksm_scan_rate > 0)
+		thread_create ("ksm", PRI_DEFAULT, ksm_thread, NULL);
+}
+
+/* Gives merged PAGE a private copy of its contents in KVA. */
+bool
+ksm_unmerge (struct page *page, void *kva) {
+	struct anon_page *anon = &page->anon;
+
+	ASSERT (anon->state == ANON_KSM);
+
+	pml4_clear_page (page->owner->pml4, page->va);
+	lock_acquire (&ksm_lock);
+	memcpy (kva, anon->ksm->kva, PGSIZE);
+	node_put (anon->ksm);
+	unmerge_cnt++;
+	lock_release (&ksm_lock);
+
+	/* It was just written to: not a candidate until it settles again. */
+	anon->ksm_sum = 0;
+	return true;
+}
+
+/* Lets go of everything same-page merging knows about PAGE, which is being
+ * destroyed and no longer has a frame. */
+void
+ksm_forget (struct page *page) {
+	struct anon_page *anon = &page->anon;
+
+	lock_acquire (&ksm_lock);
+	cand_remove (page);
+	if (anon->state == ANON_KSM) {
+		if (page->owner->pml4 != NULL)
+			pml4_clear_page (page->owner->pml4, page->va);
+		node_put (anon->ksm);
+		anon->state = ANON_RESIDENT;
+	}
+	lock_release (&ksm_lock);
+}
+
+/* Prints same-page merging statistics. */
+void
+ksm_print_stats (void) {
+	int64_t secs;
+
+	if (ksm_scan_rate == 0)
+		return;
+	secs = timer_elapsed (start_ticks) / TIMER_FREQ;
+	printf ("KSM: %lld pages scanned (%lld/s), %lld merged, %lld unmerged\n",
+			scan_cnt, secs > 0 ? scan_cnt / secs : scan_cnt,
+			merge_cnt, unmerge_cnt);
+	printf ("KSM: %lld pages sharing %lld frames, %lld kB saved\n",
+			sharing_cnt, node_cnt,
+			(sharing_cnt - node_cnt) * (PGSIZE / 1024));
+}
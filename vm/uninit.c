@@ -8,6 +8,7 @@
  * function.
  * */
 
+#include "threads/malloc.h"
 #include "vm/vm.h"
 #include "vm/uninit.h"
 
@@ -51,9 +52,11 @@ uninit_initialize (struct page *page, void *kva) {
 	vm_initializer *init = uninit->init;
 	void *aux = uninit->aux;
 
-	/* TODO: You may need to fix this function. */
-	return uninit->page_initializer (page, uninit->type, kva) &&
+	/* The page owns AUX; it is not needed once the contents are loaded. */
+	bool success = uninit->page_initializer (page, uninit->type, kva) &&
 		(init ? init (page, aux) : true);
+	free (aux);
+	return success;
 }
 
 /* Free the resources hold by uninit_page. Although most of pages are transmuted
@@ -62,7 +65,9 @@ uninit_initialize (struct page *page, void *kva) {
  * PAGE will be freed by the caller. */
 static void
 uninit_destroy (struct page *page) {
-	struct uninit_page *uninit UNUSED = &page->uninit;
-	/* TODO: Fill this function.
-	 * TODO: If you don't have anything to do, just return. */
+	struct uninit_page *uninit = &page->uninit;
+
+	/* An untouched page may still be reading the shared zero frame. */
+	vm_zero_unmap (page);
+	free (uninit->aux);
 }
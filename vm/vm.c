@@ -1,8 +1,147 @@
 /* vm.c: Generic interface for virtual memory objects. */
 
+#include <round.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "devices/disk.h"
+#include "devices/timer.h"
+#include "filesys/file.h"
+#include "filesys/inode.h"
 #include "threads/malloc.h"
+#include "threads/mmu.h"
+#include "threads/synch.h"
+#include "threads/vaddr.h"
 #include "vm/vm.h"
 #include "vm/inspect.h"
+#include "vm/zswap.h"
+#include "vm/ksm.h"
+#include "userprog/syscall.h"
+
+/* Every frame handed out to user pages, in clock order. */
+static struct list frame_table;
+/* Protects frame_table, clock_hand and the page<->frame links. */
+static struct lock frame_lock;
+/* Next frame the clock algorithm looks at. */
+static struct list_elem *clock_hand;
+/* Next frame the same-page merging scanner looks at. */
+static struct list_elem *scan_hand;
+
+/* Read-only frame of zeroes, mapped by every anonymous page that has only
+ * been read so far.  It never enters the frame table. */
+static void *zero_kva;
+static long long zero_map_cnt;      /* Read faults served by zero_kva. */
+static long long zero_break_cnt;    /* Of those, later written to. */
+
+/* Fault-around and readahead.  A fault inside a vm_area also loads the
+ * neighbouring pages that are not resident yet: an aligned window of
+ * FAULT_AROUND_PAGES around a random fault, or a window that starts at the
+ * fault and doubles up to READAHEAD_MAX_PAGES while the area is being
+ * scanned sequentially.  Extra pages are only loaded into free frames;
+ * nothing is evicted to make room for them. */
+#define FAULT_AROUND_PAGES 8
+#define READAHEAD_MAX_PAGES 64
+static long long area_fault_cnt;    /* Faults inside a vm_area. */
+static long long around_page_cnt;   /* Pages loaded along with them. */
+static long long seq_fault_cnt;     /* Faults that continued a scan. */
+
+/* Page index.  Pages of files that are mapped read-only, which includes
+ * the code of every running program, never differ from the file, so they
+ * do not get a frame per process: the first page to fault reads the
+ * contents into a frame that is entered here under the file's inode and
+ * the offset, and later pages with the same key map that frame read-only.
+ * A shared frame stays in the frame table with no page of its own; the
+ * clock may evict it, which unmaps it from all its pages.  It is freed
+ * with the last page that maps it, unless its inode is retained by
+ * vm_share_retain(), as the executables of the exec() image cache are:
+ * then it stays, idle and first in line for eviction, for the next process
+ * that runs the program.  The key includes the inode's write count, so
+ * once the file is written its old frames are never found again; they
+ * stay only until their pages go away or, when idle, until
+ * vm_share_release().  The inode is open as long as its frames are in
+ * the index, which keeps the count from starting over.  Protected by
+ * frame_lock. */
+struct share_key {
+	disk_sector_t inumber;          /* Inode of the file... */
+	unsigned write_cnt;             /* ...its inode_write_count()... */
+	off_t ofs;                      /* ...offset of the page in it... */
+	uint32_t read_bytes;            /* ...and how much of it is file. */
+};
+
+struct frame_share {
+	struct hash_elem elem;          /* Element of page_index. */
+	struct share_key key;           /* Contents held by the frame. */
+	struct frame *frame;            /* The shared frame. */
+	struct list mappers;            /* Pages mapping it, by file.share_elem. */
+	bool idle;                      /* Kept with no mappers, in idle_shares? */
+	struct list_elem idle_elem;     /* Element of idle_shares. */
+};
+
+/* Most inodes retained at once. */
+#define RETAIN_MAX 16
+
+static struct hash page_index;
+static struct list idle_shares;     /* Entries kept with no mappers. */
+static disk_sector_t retained[RETAIN_MAX];  /* Inodes whose frames stay. */
+static int retained_cnt;
+static long long idle_share_cnt;    /* Entries in idle_shares now. */
+static long long index_hit_cnt;     /* Faults that found the frame there. */
+static long long index_miss_cnt;    /* Faults that read it in. */
+static long long shared_frame_cnt;  /* Entries in page_index now. */
+static long long shared_map_cnt;    /* Pages mapping them now. */
+
+static uint64_t share_hash (const struct hash_elem *e, void *aux);
+static bool share_less (const struct hash_elem *a, const struct hash_elem *b,
+		void *aux);
+
+/* Stack growth.  A fault below the stack, no more than 8 bytes under the
+ * user's rsp (PUSH checks access before moving rsp), grows the stack down
+ * to the faulting page in one go, as long as the stack stays within
+ * vm_stack_limit and at least STACK_GUARD_PAGES unmapped pages above any
+ * other mapping.  The pages in between are loaded right away, but only
+ * into free frames. */
+#define STACK_GUARD_PAGES 4
+size_t vm_stack_limit = 1024 * 1024;
+static long long stack_grow_cnt;    /* Faults that grew the stack. */
+static long long stack_page_cnt;    /* Pages it grew by. */
+
+/* Memory hints.  madvise() advice about the access pattern is kept in the
+ * vm_areas, where readahead looks at it, and in the pages, where the
+ * evictor does: MADV_SEQUENTIAL pages get no second chance, and MADV_FREE
+ * pages that were not written to again are dropped instead of swapped
+ * out.  Pages locked by mlock() are never evicted; a process may lock up
+ * to MLOCK_LIMIT_PAGES of them. */
+#define MLOCK_LIMIT_PAGES 64
+static long long lazy_free_cnt;     /* MADV_FREE pages dropped by the evictor. */
+static long long dontneed_cnt;      /* Pages dropped by MADV_DONTNEED. */
+static long long willneed_cnt;      /* Pages loaded by MADV_WILLNEED. */
+
+/* Stride prefetching.  Each vm_area remembers the distance between its
+ * last two faults.  Once PREFETCH_CONFIRM faults in a row were the same
+ * distance apart, the pages of the next predicted faults are loaded ahead
+ * of them, twice as many for each further fault that fits the pattern, up
+ * to PREFETCH_MAX_PAGES.  Unlike readahead this also covers anonymous
+ * memory, which gets zeroed frames ahead of write faults, and pages out on
+ * swap.  Only free frames are used, and prefetching stops altogether while
+ * the evictor has been busy in the last PREFETCH_PRESSURE_TICKS. */
+#define PREFETCH_CONFIRM 2
+#define PREFETCH_MAX_PAGES 16
+#define PREFETCH_PRESSURE_TICKS (TIMER_FREQ / 10)
+static int64_t last_evict_ticks = -PREFETCH_PRESSURE_TICKS;
+static long long prefetch_cnt;      /* Pages prefetched. */
+static long long prefetch_used_cnt; /* Of those, accessed while resident. */
+static long long prefetch_waste_cnt;/* Of those, dropped without access. */
+static long long prefetch_skip_cnt; /* Predictions ignored under pressure. */
+
+/* Working-set sampling.  Every vm_ws_sample_ticks ticks a kernel thread
+ * moves the accessed bit of every resident page into the page's
+ * ws_history.  A process's working set is its resident pages accessed in
+ * the last 8 samples; the evictor takes pages from processes that hold
+ * more frames than that first. */
+int64_t vm_ws_sample_ticks;
+bool vm_usage_dump;
+
+static void ws_sampler (void *aux);
 
 /* Initializes the virtual memory subsystem by invoking each subsystem's
  * intialize codes. */
@@ -16,6 +155,54 @@ vm_init (void) {
 	register_inspect_intr ();
 	/* DO NOT MODIFY UPPER LINES. */
 	/* TODO: Your code goes here. */
+	list_init (&frame_table);
+	lock_init (&frame_lock);
+	clock_hand = NULL;
+	scan_hand = NULL;
+	zero_kva = palloc_get_page (PAL_ASSERT | PAL_ZERO);
+	hash_init (&page_index, share_hash, share_less, NULL);
+	list_init (&idle_shares);
+	ksm_init ();
+	if (vm_ws_sample_ticks > 0)
+		thread_create ("wss", PRI_DEFAULT, ws_sampler, NULL);
+}
+
+/* Prints statistics about the virtual memory subsystem. */
+void
+vm_print_stats (void) {
+	printf ("Zero page: %lld read faults shared, %lld copied on write\n",
+			zero_map_cnt, zero_break_cnt);
+	printf ("Readahead: %lld file faults (%lld sequential), "
+			"%lld pages loaded around them\n",
+			area_fault_cnt, seq_fault_cnt, around_page_cnt);
+	printf ("Stack: grown %lld times by %lld pages\n",
+			stack_grow_cnt, stack_page_cnt);
+	printf ("madvise: %lld pages loaded, %lld dropped, %lld freed lazily\n",
+			willneed_cnt, dontneed_cnt, lazy_free_cnt);
+	printf ("Prefetch: %lld pages, %lld used, %lld wasted (%lld%% accurate), "
+			"%lld skipped under pressure\n", prefetch_cnt, prefetch_used_cnt,
+			prefetch_waste_cnt, prefetch_used_cnt + prefetch_waste_cnt > 0
+			? prefetch_used_cnt * 100 / (prefetch_used_cnt + prefetch_waste_cnt)
+			: 0, prefetch_skip_cnt);
+	printf ("Page index: %lld hits, %lld misses, "
+			"%lld pages sharing %lld frames, %lld kept idle\n",
+			index_hit_cnt, index_miss_cnt, shared_map_cnt, shared_frame_cnt,
+			idle_share_cnt);
+	zswap_print_stats ();
+	ksm_print_stats ();
+}
+
+/* Prints the memory usage counters of process T. */
+void
+vm_print_usage (struct thread *t) {
+	const struct memstat *mem = &t->mem;
+
+	printf ("%s: rss %lld, wss %lld, swapped %lld, evicted %lld, "
+			"locked %lld, faults %lld minor %lld major, "
+			"prefetched %lld (%lld wasted)\n", t->name, mem->rss,
+			mem->wss, mem->swapped, mem->evicted, mem->locked,
+			mem->minor_faults, mem->major_faults, mem->prefetched,
+			mem->prefetch_wasted);
 }
 
 /* Get the type of the page. This function is useful if you want to know the
@@ -36,6 +223,14 @@ page_get_type (struct page *page) {
 static struct frame *vm_get_victim (void);
 static bool vm_do_claim_page (struct page *page);
 static struct frame *vm_evict_frame (void);
+static struct frame *vm_alloc_frame (bool may_evict);
+static void frame_detach (struct page *page);
+static void frame_free (struct frame *frame);
+static bool vm_claim_frame (struct page *page, struct frame *frame);
+static void vm_fault_around (struct page *page);
+static bool vm_handle_fault (struct page *page, bool write, bool not_present);
+static bool share_accessed (struct frame_share *share);
+static void share_evict (struct frame_share *share);
 
 /* Create the pending page object with initializer. If you want to create a
  * page, do not create it directly and make it through this function or
@@ -50,11 +245,41 @@ vm_alloc_page_with_initializer (enum vm_type type, void *upage, bool writable,
 
 	/* Check wheter the upage is already occupied or not. */
 	if (spt_find_page (spt, upage) == NULL) {
-		/* TODO: Create the page, fetch the initialier according to the VM type,
-		 * TODO: and then create "uninit" page struct by calling uninit_new. You
-		 * TODO: should modify the field after calling the uninit_new. */
+		bool (*initializer) (struct page *, enum vm_type, void *);
+		struct page *page;
+
+		switch (VM_TYPE (type)) {
+			case VM_ANON:
+				initializer = anon_initializer;
+				break;
+			case VM_FILE:
+				initializer = file_backed_initializer;
+				break;
+			default:
+				goto err;
+		}
 
-		/* TODO: Insert the page into the spt. */
+		page = malloc (sizeof *page);
+		if (page == NULL)
+			goto err;
+
+		/* uninit_new() overwrites the whole page, so fill in our own
+		 * members afterwards. */
+		uninit_new (page, pg_round_down (upage), init, type, aux, initializer);
+		page->owner = thread_current ();
+		page->writable = writable;
+		page->zero_mapped = false;
+		page->ws_history = 0;
+		page->ws_ref = false;
+		page->advice = MADV_NORMAL;
+		page->locked = false;
+		page->prefetched = false;
+
+		if (!spt_insert_page (spt, page)) {
+			free (page);
+			goto err;
+		}
+		return true;
 	}
 err:
 	return false;
@@ -62,82 +287,1297 @@ err:
 
 /* Find VA from spt and return page. On error, return NULL. */
 struct page *
-spt_find_page (struct supplemental_page_table *spt UNUSED, void *va UNUSED) {
-	struct page *page = NULL;
-	/* TODO: Fill this function. */
+spt_find_page (struct supplemental_page_table *spt, void *va) {
+	struct page p;
+	struct hash_elem *e;
 
-	return page;
+	p.va = pg_round_down (va);
+	e = hash_find (&spt->pages, &p.spt_elem);
+	return e != NULL ? hash_entry (e, struct page, spt_elem) : NULL;
 }
 
 /* Insert PAGE into spt with validation. */
 bool
-spt_insert_page (struct supplemental_page_table *spt UNUSED,
-		struct page *page UNUSED) {
-	int succ = false;
-	/* TODO: Fill this function. */
-
-	return succ;
+spt_insert_page (struct supplemental_page_table *spt,
+		struct page *page) {
+	return hash_insert (&spt->pages, &page->spt_elem) == NULL;
 }
 
 void
 spt_remove_page (struct supplemental_page_table *spt, struct page *page) {
+	if (page->locked)
+		page->owner->mem.locked--;
+	hash_delete (&spt->pages, &page->spt_elem);
 	vm_dealloc_page (page);
-	return true;
 }
 
-/* Get the struct frame, that will be evicted. */
+/* One sweep of the second-chance clock over the frame table: a frame whose
+ * page was accessed since the last sweep gets its accessed bit cleared and
+ * is skipped once, unless the page was advised MADV_SEQUENTIAL.  Pinned
+ * frames, frames that are still being filled and mlock()ed pages are never
+ * chosen.  If OVER_WS, only pages of processes that hold more
+ * frames than their working set are considered. */
+static struct frame *
+clock_sweep (bool over_ws) {
+	size_t budget = 2 * list_size (&frame_table) + 1;
+
+	while (budget-- > 0 && !list_empty (&frame_table)) {
+		if (clock_hand == NULL || clock_hand == list_end (&frame_table))
+			clock_hand = list_begin (&frame_table);
+
+		struct frame *frame = list_entry (clock_hand, struct frame, frame_elem);
+		clock_hand = list_next (clock_hand);
+
+		if (frame->pinned)
+			continue;
+
+		/* Shared frames belong to no process in particular. */
+		if (frame->share != NULL) {
+			if (share_accessed (frame->share))
+				continue;
+			return frame;
+		}
+		if (frame->page == NULL)
+			continue;
+
+		struct page *page = frame->page;
+		struct thread *owner = page->owner;
+		if (page->locked || (over_ws && owner->mem.rss <= owner->mem.wss))
+			continue;
+
+		uint64_t *pml4 = owner->pml4;
+		bool accessed = page->ws_ref
+			|| (pml4 != NULL && pml4_is_accessed (pml4, page->va));
+		if (accessed && page->prefetched) {
+			prefetch_used_cnt++;
+			page->prefetched = false;
+		}
+		if (accessed && page->advice != MADV_SEQUENTIAL) {
+			if (pml4 != NULL)
+				pml4_set_accessed (pml4, page->va, false);
+			page->ws_ref = false;
+			continue;
+		}
+		return frame;
+	}
+	return NULL;
+}
+
+/* Get the struct frame, that will be evicted.
+ * Processes that are over their working set give up frames first.  Must
+ * be called with frame_lock held. */
 static struct frame *
 vm_get_victim (void) {
-	struct frame *victim = NULL;
-	 /* TODO: The policy for eviction is up to you. */
+	struct frame *victim;
+
+	ASSERT (lock_held_by_current_thread (&frame_lock));
 
+	victim = clock_sweep (true);
+	if (victim == NULL)
+		victim = clock_sweep (false);
 	return victim;
 }
 
+/* Takes FRAME away from its page, writing the contents out as needed, and
+ * returns true with FRAME pinned and free for reuse.  Returns false,
+ * leaving everything as it was, if the contents cannot be written out
+ * right now.  Must be called with frame_lock held. */
+static bool
+frame_evict (struct frame *frame) {
+	/* Shared frames are clean: just take them from everyone. */
+	if (frame->share != NULL) {
+		share_evict (frame->share);
+		frame->pinned = true;
+		return true;
+	}
+
+	struct page *page = frame->page;
+	uint64_t *pml4 = page->owner->pml4;
+	bool dirty = pml4 != NULL && pml4_is_dirty (pml4, page->va);
+	bool anon = VM_TYPE (page->operations->type) == VM_ANON;
+	bool success;
+
+	/* Unmap first so that the owner cannot modify the contents while
+	 * they are being written out. */
+	frame->pinned = true;
+	if (pml4 != NULL)
+		pml4_clear_page (pml4, page->va);
+
+	if (anon && page->advice == MADV_FREE && !dirty) {
+		/* Not written to since madvise(): the contents may go. */
+		page->anon.state = ANON_SWAP_ZERO;
+		page->advice = MADV_NORMAL;
+		lazy_free_cnt++;
+		success = true;
+	} else
+		success = swap_out (page);
+
+	if (success) {
+		page->owner->mem.evicted++;
+		if (anon)
+			page->owner->mem.swapped++;
+		frame_detach (page);
+		return true;
+	}
+
+	if (pml4 != NULL) {
+		pml4_set_page (pml4, page->va, frame->kva, page->writable);
+		pml4_set_dirty (pml4, page->va, dirty);
+	}
+	frame->pinned = false;
+	return false;
+}
+
 /* Evict one page and return the corresponding frame.
  * Return NULL on error.*/
 static struct frame *
 vm_evict_frame (void) {
-	struct frame *victim UNUSED = vm_get_victim ();
-	/* TODO: swap out the victim and return the evicted frame. */
+	struct frame *victim = NULL;
+	size_t tries;
 
-	return NULL;
+	lock_acquire (&frame_lock);
+	/* A victim whose contents cannot be written out right now keeps its
+	 * frame; the clock has moved on, so try the next one. */
+	for (tries = list_size (&frame_table); tries > 0; tries--) {
+		victim = vm_get_victim ();
+		if (victim == NULL)
+			break;
+		if (frame_evict (victim)) {
+			last_evict_ticks = timer_ticks ();
+			break;
+		}
+		victim = NULL;
+	}
+	lock_release (&frame_lock);
+	return victim;
 }
 
 /* palloc() and get frame. If there is no available page, evict the page
  * and return it. This always return valid address. That is, if the user pool
  * memory is full, this function evicts the frame to get the available memory
- * space.*/
+ * space.
+ * The frame is returned pinned; vm_do_claim_page() unpins it once the page
+ * contents are in place.  Returns NULL only if nothing can be evicted. */
 static struct frame *
 vm_get_frame (void) {
+	return vm_alloc_frame (true);
+}
+
+/* Like vm_get_frame(), but if MAY_EVICT is false returns NULL instead of
+ * evicting when the user pool is empty. */
+static struct frame *
+vm_alloc_frame (bool may_evict) {
 	struct frame *frame = NULL;
-	/* TODO: Fill this function. */
+	void *kva = palloc_get_page (PAL_USER);
+
+	if (kva == NULL)
+		return may_evict ? vm_evict_frame () : NULL;
+
+	frame = malloc (sizeof *frame);
+	if (frame == NULL) {
+		palloc_free_page (kva);
+		return NULL;
+	}
+	frame->kva = kva;
+	frame->page = NULL;
+	frame->pinned = true;
+	frame->share = NULL;
+
+	lock_acquire (&frame_lock);
+	list_push_back (&frame_table, &frame->frame_elem);
+	lock_release (&frame_lock);
 
-	ASSERT (frame != NULL);
 	ASSERT (frame->page == NULL);
 	return frame;
 }
 
-/* Growing the stack. */
+/* Links PAGE and FRAME and counts the frame in the owner's memory usage.
+ * Must be called with frame_lock held. */
+static void
+frame_attach (struct page *page, struct frame *frame) {
+	struct memstat *mem = &page->owner->mem;
+
+	ASSERT (lock_held_by_current_thread (&frame_lock));
+
+	frame->page = page;
+	page->frame = frame;
+	page->ws_ref = false;
+	mem->rss++;
+	if (vm_ws_sample_ticks > 0) {
+		/* Just faulted in, so part of the working set. */
+		page->ws_history = 1;
+		mem->wss++;
+	}
+}
+
+/* Undoes frame_attach().  The frame stays in the frame table. */
+static void
+frame_detach (struct page *page) {
+	struct memstat *mem = &page->owner->mem;
+
+	ASSERT (lock_held_by_current_thread (&frame_lock));
+
+	mem->rss--;
+	if (page->ws_history != 0)
+		mem->wss--;
+	if (page->prefetched) {
+		/* The PTE may be cleared already, but keeps the accessed bit. */
+		uint64_t *pml4 = page->owner->pml4;
+
+		if (page->ws_ref || (pml4 != NULL && pml4_is_accessed (pml4, page->va)))
+			prefetch_used_cnt++;
+		else {
+			prefetch_waste_cnt++;
+			mem->prefetch_wasted++;
+		}
+		page->prefetched = false;
+	}
+	page->ws_history = 0;
+	page->frame->page = NULL;
+	page->frame = NULL;
+}
+
+/* Removes FRAME from the frame table.  Must be called with frame_lock
+ * held. */
+static void
+frame_unlink (struct frame *frame) {
+	ASSERT (lock_held_by_current_thread (&frame_lock));
+
+	if (clock_hand == &frame->frame_elem)
+		clock_hand = list_next (clock_hand);
+	if (scan_hand == &frame->frame_elem)
+		scan_hand = list_next (scan_hand);
+	list_remove (&frame->frame_elem);
+}
+
+/* Detaches PAGE from its frame, if it has one: the user mapping is removed
+ * and the frame goes back to the user pool.  Waits for an eviction of PAGE
+ * that is in progress to finish first. */
+void
+vm_free_frame (struct page *page) {
+	struct frame *frame;
+
+	lock_acquire (&frame_lock);
+	frame = page->frame;
+	if (frame != NULL) {
+		if (page->owner->pml4 != NULL)
+			pml4_clear_page (page->owner->pml4, page->va);
+		frame_detach (page);
+		frame_free (frame);
+	}
+	lock_release (&frame_lock);
+}
+
+/* Frees FRAME, which has no page, and its kva.  Must be called with
+ * frame_lock held. */
 static void
-vm_stack_growth (void *addr UNUSED) {
+frame_free (struct frame *frame) {
+	ASSERT (lock_held_by_current_thread (&frame_lock));
+
+	frame_unlink (frame);
+	palloc_free_page (frame->kva);
+	free (frame);
+}
+
+/* Notes that the swapped-out contents of anonymous PAGE were thrown away
+ * with PAGE. */
+void
+vm_account_swap_free (struct page *page) {
+	lock_acquire (&frame_lock);
+	page->owner->mem.swapped--;
+	lock_release (&frame_lock);
+}
+
+/* Brings PAGE into memory if needed and pins its frame, so that its kva
+ * stays valid until vm_unpin_page().  Returns false if PAGE could not be
+ * loaded. */
+bool
+vm_pin_page (struct page *page) {
+	for (;;) {
+		lock_acquire (&frame_lock);
+		if (page->frame != NULL) {
+			page->frame->pinned = true;
+			lock_release (&frame_lock);
+			return true;
+		}
+		lock_release (&frame_lock);
+
+		/* The frame may be stolen again before we re-take the lock. */
+		if (!vm_do_claim_page (page))
+			return false;
+	}
+}
+
+/* Pins PAGE's frame if PAGE is resident, waiting for an eviction of it that
+ * is in progress.  Returns false, without loading it, if PAGE has no
+ * frame. */
+bool
+vm_pin_resident (struct page *page) {
+	bool resident;
+
+	lock_acquire (&frame_lock);
+	resident = page->frame != NULL;
+	if (resident)
+		page->frame->pinned = true;
+	lock_release (&frame_lock);
+	return resident;
+}
+
+/* Calls SCAN on up to CNT resident anonymous pages whose frames are not
+ * pinned, going round the frame table from where the previous call
+ * stopped.  SCAN runs with the frame table locked.  Returns the number of
+ * pages passed to SCAN. */
+size_t
+vm_scan_anon (size_t cnt, void (*scan) (struct page *)) {
+	size_t done = 0;
+	size_t left;
+
+	lock_acquire (&frame_lock);
+	for (left = list_size (&frame_table); done < cnt && left > 0; left--) {
+		if (scan_hand == NULL || scan_hand == list_end (&frame_table))
+			scan_hand = list_begin (&frame_table);
+
+		struct frame *frame = list_entry (scan_hand, struct frame, frame_elem);
+		scan_hand = list_next (scan_hand);
+
+		if (frame->pinned || frame->page == NULL || frame->page->locked
+				|| VM_TYPE (frame->page->operations->type) != VM_ANON)
+			continue;
+		scan (frame->page);
+		done++;
+	}
+	lock_release (&frame_lock);
+	return done;
+}
+
+/* Takes PAGE's frame away from it for same-page merging: the frame leaves
+ * the frame table and its kva, whose contents are left alone, is returned
+ * to the caller, who now owns it.  PAGE's mapping is not changed.  Must be
+ * called with frame_lock held, from vm_scan_anon(). */
+void *
+vm_frame_steal (struct page *page) {
+	struct frame *frame = page->frame;
+	void *kva = frame->kva;
+
+	ASSERT (!frame->pinned);
+	frame_detach (page);
+	frame_unlink (frame);
+	free (frame);
+	return kva;
+}
+
+/* Makes PAGE's frame evictable again. */
+void
+vm_unpin_page (struct page *page) {
+	lock_acquire (&frame_lock);
+	if (page->frame != NULL)
+		page->frame->pinned = false;
+	lock_release (&frame_lock);
+}
+
+/* Returns true if PAGE has no frame and its contents are known to be all
+ * zeroes: an anonymous page that was never loaded and has nothing to read
+ * from a file (bss, stack), or one that was swapped out as a zero page. */
+static bool
+vm_is_zero_fill (struct page *page) {
+	if (page->frame != NULL)
+		return false;
+
+	if (VM_TYPE (page->operations->type) == VM_UNINIT) {
+		struct lazy_load_info *info = page->uninit.aux;
+
+		if (VM_TYPE (page->uninit.type) != VM_ANON)
+			return false;
+		return page->uninit.init == NULL
+			|| (info != NULL && info->read_bytes == 0);
+	}
+	return page_get_type (page) == VM_ANON
+		&& page->anon.state == ANON_SWAP_ZERO;
+}
+
+/* Maps the shared zero frame read-only at PAGE's address. */
+static bool
+vm_zero_map (struct page *page) {
+	if (!pml4_set_page (page->owner->pml4, page->va, zero_kva, false))
+		return false;
+	page->zero_mapped = true;
+	zero_map_cnt++;
+	return true;
+}
+
+/* Drops PAGE's mapping of the shared zero frame, if it has one.  The zero
+ * frame itself is never freed. */
+void
+vm_zero_unmap (struct page *page) {
+	if (page->zero_mapped) {
+		if (page->owner->pml4 != NULL)
+			pml4_clear_page (page->owner->pml4, page->va);
+		page->zero_mapped = false;
+	}
+}
+
+static uint64_t
+share_hash (const struct hash_elem *e, void *aux UNUSED) {
+	const struct frame_share *s = hash_entry (e, struct frame_share, elem);
+	return hash_bytes (&s->key, sizeof s->key);
+}
+
+static bool
+share_less (const struct hash_elem *a, const struct hash_elem *b,
+		void *aux UNUSED) {
+	return memcmp (&hash_entry (a, struct frame_share, elem)->key,
+			&hash_entry (b, struct frame_share, elem)->key,
+			sizeof (struct share_key)) < 0;
+}
+
+/* Returns true if PAGE's contents may come from the page index: it is
+ * read-only and backed by a file. */
+static bool
+vm_is_shareable (struct page *page) {
+	return !page->writable && page_get_type (page) == VM_FILE;
+}
+
+/* Returns true if PAGE maps a shared frame from the page index. */
+static bool
+vm_is_share_mapped (struct page *page) {
+	return VM_TYPE (page->operations->type) == VM_FILE
+		&& page->file.share != NULL;
+}
+
+/* Returns the entry of the page index for KEY, or a null pointer.  Must be
+ * called with frame_lock held. */
+static struct frame_share *
+share_find (const struct share_key *key) {
+	struct frame_share s;
+	struct hash_elem *e;
+
+	s.key = *key;
+	e = hash_find (&page_index, &s.elem);
+	return e != NULL ? hash_entry (e, struct frame_share, elem) : NULL;
+}
+
+/* Maps SHARE's frame read-only at PAGE's address.  Must be called with
+ * frame_lock held. */
+static bool
+share_attach (struct frame_share *share, struct page *page) {
+	if (!pml4_set_page (page->owner->pml4, page->va, share->frame->kva, false))
+		return false;
+	if (share->idle) {
+		list_remove (&share->idle_elem);
+		share->idle = false;
+		idle_share_cnt--;
+	}
+	list_push_back (&share->mappers, &page->file.share_elem);
+	page->file.share = share;
+	shared_map_cnt++;
+	return true;
+}
+
+/* Undoes share_attach().  Must be called with frame_lock held. */
+static void
+share_detach (struct page *page) {
+	if (page->owner->pml4 != NULL)
+		pml4_clear_page (page->owner->pml4, page->va);
+	list_remove (&page->file.share_elem);
+	page->file.share = NULL;
+	shared_map_cnt--;
+}
+
+/* Removes SHARE from the page index and frees it, but not its frame.  Must
+ * be called with frame_lock held. */
+static void
+share_remove (struct frame_share *share) {
+	ASSERT (list_empty (&share->mappers));
+
+	if (share->idle) {
+		list_remove (&share->idle_elem);
+		idle_share_cnt--;
+	}
+	hash_delete (&page_index, &share->elem);
+	share->frame->share = NULL;
+	free (share);
+	shared_frame_cnt--;
+}
+
+/* Returns true if any page accessed SHARE's frame since the last call,
+ * clearing their accessed bits.  Must be called with frame_lock held. */
+static bool
+share_accessed (struct frame_share *share) {
+	bool accessed = false;
+
+	for (struct list_elem *e = list_begin (&share->mappers);
+			e != list_end (&share->mappers); e = list_next (e)) {
+		struct page *page = list_entry (e, struct page, file.share_elem);
+		uint64_t *pml4 = page->owner->pml4;
+
+		if (pml4 != NULL && pml4_is_accessed (pml4, page->va)) {
+			pml4_set_accessed (pml4, page->va, false);
+			accessed = true;
+		}
+	}
+	return accessed;
+}
+
+/* Unmaps SHARE's frame from all its pages and removes SHARE from the page
+ * index, leaving the frame to the caller.  Must be called with frame_lock
+ * held. */
+static void
+share_evict (struct frame_share *share) {
+	while (!list_empty (&share->mappers)) {
+		struct page *page = list_entry (list_front (&share->mappers),
+				struct page, file.share_elem);
+
+		page->owner->mem.evicted++;
+		share_detach (page);
+	}
+	share_remove (share);
+}
+
+/* Maps read-only file PAGE to the frame of the page index that holds its
+ * contents, reading them into a new frame first if no page maps them yet.
+ * If MAY_EVICT is false, fails instead of evicting to get that frame. */
+static bool
+vm_share_map (struct page *page, bool may_evict) {
+	struct frame_share *share;
+	struct share_key key;
+	struct inode *inode;
+	struct frame *frame;
+	bool success;
+
+	ASSERT (vm_is_shareable (page));
+
+	if (VM_TYPE (page->operations->type) == VM_UNINIT)
+		file_backed_adopt (page);
+	inode = file_get_inode (page->file.file);
+	key.inumber = inode_get_inumber (inode);
+	key.write_cnt = inode_write_count (inode);
+	key.ofs = page->file.ofs;
+	key.read_bytes = page->file.read_bytes;
+
+	lock_acquire (&frame_lock);
+	share = share_find (&key);
+	if (share != NULL) {
+		index_hit_cnt++;
+		success = share_attach (share, page);
+		lock_release (&frame_lock);
+		return success;
+	}
+	lock_release (&frame_lock);
+
+	/* Read it without the lock, then check that no other process entered
+	 * the same page meanwhile. */
+	frame = vm_alloc_frame (may_evict);
+	if (frame == NULL)
+		return false;
+	if (!swap_in (page, frame->kva)) {
+		lock_acquire (&frame_lock);
+		frame_free (frame);
+		lock_release (&frame_lock);
+		return false;
+	}
+
+	lock_acquire (&frame_lock);
+	share = share_find (&key);
+	if (share != NULL) {
+		index_hit_cnt++;
+		frame_free (frame);
+	} else {
+		share = malloc (sizeof *share);
+		if (share == NULL) {
+			frame_free (frame);
+			lock_release (&frame_lock);
+			return false;
+		}
+		index_miss_cnt++;
+		share->key = key;
+		share->frame = frame;
+		list_init (&share->mappers);
+		share->idle = false;
+		hash_insert (&page_index, &share->elem);
+		shared_frame_cnt++;
+		frame->share = share;
+		frame->pinned = false;
+	}
+	success = share_attach (share, page);
+	if (!success && list_empty (&share->mappers)) {
+		frame = share->frame;
+		share_remove (share);
+		frame_free (frame);
+	}
+	lock_release (&frame_lock);
+	return success;
+}
+
+/* Returns true if the frames of INUMBER stay in the page index with no
+ * page mapping them.  Must be called with frame_lock held. */
+static bool
+share_is_retained (disk_sector_t inumber) {
+	for (int i = 0; i < retained_cnt; i++)
+		if (retained[i] == inumber)
+			return true;
+	return false;
+}
+
+/* Unmaps PAGE from the shared frame it maps, if it still does.  The frame
+ * is freed along with the last page that maps it, or kept idle if its
+ * inode is retained. */
+void
+vm_share_unmap (struct page *page) {
+	struct frame_share *share;
+
+	lock_acquire (&frame_lock);
+	share = page->file.share;
+	if (share != NULL) {
+		share_detach (page);
+		if (!list_empty (&share->mappers))
+			;
+		else if (share_is_retained (share->key.inumber)) {
+			share->idle = true;
+			list_push_back (&idle_shares, &share->idle_elem);
+			idle_share_cnt++;
+		} else {
+			struct frame *frame = share->frame;
+
+			share_remove (share);
+			frame_free (frame);
+		}
+	}
+	lock_release (&frame_lock);
+}
+
+/* Keeps the shared frames of the file with inode INUMBER in the page
+ * index after the last page that maps them goes away, until
+ * vm_share_release().  The caller must keep the inode open meanwhile, so
+ * that its sector is not reused.  Does nothing if too many inodes are
+ * retained already. */
+void
+vm_share_retain (disk_sector_t inumber) {
+	lock_acquire (&frame_lock);
+	if (retained_cnt < RETAIN_MAX && !share_is_retained (inumber))
+		retained[retained_cnt++] = inumber;
+	lock_release (&frame_lock);
+}
+
+/* Undoes vm_share_retain() and frees the frames of INUMBER that no page
+ * maps.  Also used to drop contents that are out of date because the file
+ * was written. */
+void
+vm_share_release (disk_sector_t inumber) {
+	struct list_elem *e;
+
+	lock_acquire (&frame_lock);
+	for (int i = 0; i < retained_cnt; i++)
+		if (retained[i] == inumber) {
+			retained[i] = retained[--retained_cnt];
+			break;
+		}
+	for (e = list_begin (&idle_shares); e != list_end (&idle_shares); ) {
+		struct frame_share *share = list_entry (e, struct frame_share,
+				idle_elem);
+		e = list_next (e);
+		if (share->key.inumber == inumber) {
+			struct frame *frame = share->frame;
+
+			share_remove (share);
+			frame_free (frame);
+		}
+	}
+	lock_release (&frame_lock);
+}
+
+/* Creates a vm_area for [START, END) backed by FILE in the current process.
+ * MMAPPED areas own FILE and close it when destroyed. */
+struct vm_area *
+vm_area_create (void *start, void *end, struct file *file, bool mmapped) {
+	struct vm_area *area = malloc (sizeof *area);
+
+	if (area == NULL)
+		return NULL;
+	area->start = start;
+	area->end = end;
+	area->file = file;
+	area->mmapped = mmapped;
+	area->next_fault = NULL;
+	area->ra_pages = 0;
+	area->advice = MADV_NORMAL;
+	area->last_fault = NULL;
+	area->stride = 0;
+	area->stride_cnt = 0;
+	list_push_back (&thread_current ()->spt.areas, &area->elem);
+	return area;
+}
+
+/* Returns the vm_area of the current process that contains VA, or a null
+ * pointer if there is none. */
+struct vm_area *
+vm_area_find (void *va) {
+	struct list *areas = &thread_current ()->spt.areas;
+
+	for (struct list_elem *e = list_begin (areas); e != list_end (areas);
+			e = list_next (e)) {
+		struct vm_area *area = list_entry (e, struct vm_area, elem);
+		if (va >= area->start && va < area->end)
+			return area;
+	}
+	return NULL;
+}
+
+/* Removes AREA from its process and frees it.  Its pages must already be
+ * gone. */
+void
+vm_area_destroy (struct vm_area *area) {
+	list_remove (&area->elem);
+	if (area->mmapped) {
+		bool lock_held = lock_held_by_current_thread (&filesys_lock);
+
+		if (!lock_held)
+			lock_acquire (&filesys_lock);
+		file_close (area->file);
+		if (!lock_held)
+			lock_release (&filesys_lock);
+	}
+	free (area);
+}
+
+/* Returns true if loading PAGE means reading its file: a lazily loaded
+ * page with file contents that was never touched, or a file-backed page
+ * that was dropped from memory. */
+static bool
+vm_needs_read (struct page *page) {
+	if (page->frame != NULL || page->zero_mapped)
+		return false;
+	if (VM_TYPE (page->operations->type) == VM_UNINIT) {
+		struct lazy_load_info *info = page->uninit.aux;
+		return page->uninit.init != NULL && info != NULL
+			&& info->read_bytes > 0;
+	}
+	return VM_TYPE (page->operations->type) == VM_FILE
+		&& page->file.share == NULL;
+}
+
+/* Returns true if fault-around may load PAGE before it is touched: it
+ * still needs reading and all of it comes from the file.  A page that is
+ * partly zero-fill may hold the start of the bss, which must stay
+ * unloaded until it is used. */
+static bool
+vm_may_load_around (struct page *page) {
+	size_t read_bytes;
+
+	if (!vm_needs_read (page))
+		return false;
+	if (VM_TYPE (page->operations->type) == VM_UNINIT)
+		read_bytes = ((struct lazy_load_info *) page->uninit.aux)->read_bytes;
+	else
+		read_bytes = page->file.read_bytes;
+	return read_bytes == PGSIZE;
+}
+
+/* Loads PAGE before it is used, into a free frame or from the page index.
+ * Returns false if that would take evicting another page. */
+static bool
+vm_load_ahead (struct page *page) {
+	if (vm_is_shareable (page))
+		return vm_share_map (page, false);
+	return vm_claim_frame (page, vm_alloc_frame (false));
+}
+
+/* Fault-around and readahead after PAGE was loaded on a fault.  Picks a
+ * window of neighbouring pages in PAGE's vm_area from the area's access
+ * pattern and loads those that still need reading, as long as there are
+ * free frames.  Pages of mmap()ed regions are only ever loaded by a fault
+ * on them, as mmap() promises, unless madvise() asked for readahead. */
+static void
+vm_fault_around (struct page *page) {
+	struct supplemental_page_table *spt = &page->owner->spt;
+	struct vm_area *area = vm_area_find (page->va);
+	uint8_t *start, *end;
+
+	if (area == NULL || area->advice == MADV_RANDOM
+			|| (area->mmapped && area->advice != MADV_SEQUENTIAL))
+		return;
+	area_fault_cnt++;
+
+	if (area->advice == MADV_SEQUENTIAL) {
+		/* Told to expect a scan: the largest window from the start. */
+		seq_fault_cnt++;
+		area->ra_pages = READAHEAD_MAX_PAGES;
+		start = page->va;
+		end = start + area->ra_pages * PGSIZE;
+	} else if (page->va == area->next_fault) {
+		/* Sequential scan: read ahead of it, more each time. */
+		seq_fault_cnt++;
+		area->ra_pages = area->ra_pages * 2;
+		if (area->ra_pages < FAULT_AROUND_PAGES)
+			area->ra_pages = FAULT_AROUND_PAGES;
+		if (area->ra_pages > READAHEAD_MAX_PAGES)
+			area->ra_pages = READAHEAD_MAX_PAGES;
+		start = page->va;
+		end = start + area->ra_pages * PGSIZE;
+	} else {
+		/* Random access: just the aligned block around the fault. */
+		area->ra_pages = 0;
+		start = (uint8_t *) ((uintptr_t) page->va
+				& ~((uintptr_t) FAULT_AROUND_PAGES * PGSIZE - 1));
+		end = start + FAULT_AROUND_PAGES * PGSIZE;
+	}
+	if (start < (uint8_t *) area->start)
+		start = area->start;
+	if (end > (uint8_t *) area->end || end < start)
+		end = area->end;
+	area->next_fault = end;
+
+	for (uint8_t *va = start; va < end; va += PGSIZE) {
+		struct page *p = spt_find_page (spt, va);
+
+		if (p == NULL || !vm_may_load_around (p))
+			continue;
+		if (!vm_load_ahead (p))
+			break;
+		around_page_cnt++;
+	}
+}
+
+/* Returns true if anonymous PAGE has contents stored in the zswap pool or
+ * on the swap disk. */
+static bool
+vm_is_swapped (struct page *page) {
+	return VM_TYPE (page->operations->type) == VM_ANON
+		&& (page->anon.state == ANON_SWAP_POOL
+				|| page->anon.state == ANON_SWAP_DISK);
+}
+
+/* Loads PAGE, the target of a predicted fault, if it is not in memory yet
+ * and there is a free frame for it.  Zero-fill pages are only loaded if
+ * the prediction came from a WRITE fault: reads of them are cheap anyway.
+ * Returns false if there was no free frame. */
+static bool
+vm_prefetch_page (struct page *page, bool write) {
+	if (vm_may_load_around (page) || vm_is_swapped (page)) {
+		if (!vm_load_ahead (page))
+			return false;
+	} else if (write && page->writable && vm_is_zero_fill (page)) {
+		if (!vm_claim_frame (page, vm_alloc_frame (false)))
+			return false;
+	} else
+		return true;
+
+	prefetch_cnt++;
+	page->owner->mem.prefetched++;
+	/* Pages mapped from the page index have no frame to track. */
+	lock_acquire (&frame_lock);
+	if (page->frame != NULL)
+		page->prefetched = true;
+	lock_release (&frame_lock);
+	return true;
+}
+
+/* Stride prefetching after a WRITE or read fault on PAGE was resolved.
+ * Feeds the fault to the stride detector of PAGE's vm_area and loads the
+ * pages of the next predicted faults. */
+static void
+vm_prefetch (struct page *page, bool write) {
+	struct supplemental_page_table *spt = &page->owner->spt;
+	struct vm_area *area = vm_area_find (page->va);
+	intptr_t stride;
+	size_t depth;
+	uint8_t *va;
+
+	if (area == NULL || area->advice == MADV_RANDOM
+			|| (area->mmapped && area->advice != MADV_SEQUENTIAL))
+		return;
+
+	stride = area->last_fault != NULL
+		? (uint8_t *) page->va - (uint8_t *) area->last_fault : 0;
+	area->last_fault = page->va;
+	if (stride == 0 || stride != area->stride) {
+		area->stride = stride;
+		area->stride_cnt = 1;
+		return;
+	}
+	if (++area->stride_cnt <= PREFETCH_CONFIRM)
+		return;
+	if (timer_ticks () - last_evict_ticks < PREFETCH_PRESSURE_TICKS) {
+		prefetch_skip_cnt++;
+		return;
+	}
+
+	depth = 1;
+	for (int i = PREFETCH_CONFIRM + 1; i < area->stride_cnt; i++)
+		if ((depth *= 2) >= PREFETCH_MAX_PAGES) {
+			depth = PREFETCH_MAX_PAGES;
+			break;
+		}
+
+	/* The next fault that fits the pattern is one stride past the last
+	 * page handled here. */
+	for (va = page->va; depth-- > 0; ) {
+		struct page *p;
+
+		va += stride;
+		if (va < (uint8_t *) area->start || va >= (uint8_t *) area->end)
+			break;
+		p = spt_find_page (spt, va);
+		if (p == NULL || !vm_prefetch_page (p, write))
+			break;
+		area->last_fault = va;
+	}
+}
+
+/* Takes one working-set sample of every resident page. */
+static void
+ws_sample (void) {
+	lock_acquire (&frame_lock);
+	for (struct list_elem *e = list_begin (&frame_table);
+			e != list_end (&frame_table); e = list_next (e)) {
+		struct frame *frame = list_entry (e, struct frame, frame_elem);
+		struct page *page = frame->page;
+
+		if (page == NULL || page->owner->pml4 == NULL)
+			continue;
+
+		struct memstat *mem = &page->owner->mem;
+		uint8_t old = page->ws_history;
+		bool accessed = pml4_is_accessed (page->owner->pml4, page->va);
+
+		/* The clock still gets to see the bit through ws_ref. */
+		if (accessed) {
+			pml4_set_accessed (page->owner->pml4, page->va, false);
+			page->ws_ref = true;
+		}
+		page->ws_history = (old << 1) | accessed;
+		if (old == 0 && page->ws_history != 0)
+			mem->wss++;
+		else if (old != 0 && page->ws_history == 0)
+			mem->wss--;
+	}
+	lock_release (&frame_lock);
+}
+
+/* The working-set sampler thread. */
+static void
+ws_sampler (void *aux UNUSED) {
+	for (;;) {
+		timer_sleep (vm_ws_sample_ticks);
+		ws_sample ();
+	}
+}
+
+/* Returns true if an access to ADDR, with the user's stack pointer at
+ * RSP, is the current process's stack growing downward. */
+static bool
+vm_is_stack_access (void *addr, void *rsp) {
+	struct supplemental_page_table *spt = &thread_current ()->spt;
+	uint8_t *limit = (uint8_t *) USER_STACK - vm_stack_limit;
+
+	if (spt->stack_bottom == NULL || addr >= spt->stack_bottom)
+		return false;
+	if ((uint8_t *) addr < limit || limit > (uint8_t *) USER_STACK)
+		return false;
+	return (uint8_t *) addr >= (uint8_t *) rsp - 8;
+}
+
+/* Growing the stack.  Adds the pages from the one that contains ADDR up
+ * to the current bottom of the stack, loads the one at ADDR and as many of
+ * the others as there are free frames for.  Returns false if ADDR would
+ * bring the stack too close to another mapping. */
+static bool
+vm_stack_growth (void *addr) {
+	struct supplemental_page_table *spt = &thread_current ()->spt;
+	uint8_t *bottom = pg_round_down (addr);
+	uint8_t *old_bottom = spt->stack_bottom;
+
+	for (size_t i = 1; i <= STACK_GUARD_PAGES; i++) {
+		uint8_t *guard = bottom - i * PGSIZE;
+
+		if (guard < bottom && spt_find_page (spt, guard) != NULL)
+			return false;
+	}
+	for (uint8_t *va = bottom; va < old_bottom; va += PGSIZE)
+		if (spt_find_page (spt, va) != NULL)
+			return false;
+
+	for (uint8_t *va = bottom; va < old_bottom; va += PGSIZE)
+		if (!vm_alloc_page (VM_ANON | VM_STACK, va, true)) {
+			/* Take back what was added so far. */
+			while (va > bottom) {
+				va -= PGSIZE;
+				spt_remove_page (spt, spt_find_page (spt, va));
+			}
+			return false;
+		}
+	spt->stack_bottom = bottom;
+	stack_grow_cnt++;
+	stack_page_cnt += (old_bottom - bottom) / PGSIZE;
+
+	if (!vm_do_claim_page (spt_find_page (spt, bottom)))
+		return false;
+	for (uint8_t *va = bottom + PGSIZE; va < old_bottom; va += PGSIZE)
+		if (!vm_claim_frame (spt_find_page (spt, va), vm_alloc_frame (false)))
+			break;
+	return true;
+}
+
+/* Grows the stack to cover ADDR if it is a valid stack address for the
+ * user's rsp at entry to the current system call, for system calls that
+ * are handed a buffer on the stack before it is touched. */
+bool
+vm_stack_grow_for (void *addr) {
+	struct thread *curr = thread_current ();
+
+	if (is_kernel_vaddr (addr) || !vm_is_stack_access (addr, curr->user_rsp))
+		return false;
+	return vm_stack_growth (addr);
+}
+
+/* Drops PAGE from memory for MADV_DONTNEED.  File pages are written back
+ * and read in again when next used; anonymous pages lose their contents
+ * and read back as zeroes.  Fails for mlock()ed pages and for file pages
+ * whose frame could not be taken away. */
+static bool
+vm_reclaim_page (struct page *page) {
+	struct frame *frame;
+
+	if (page->locked)
+		return false;
+
+	switch (VM_TYPE (page->operations->type)) {
+		case VM_UNINIT:
+			vm_zero_unmap (page);
+			return true;
+		case VM_ANON: {
+			void *va = page->va;
+			bool writable = page->writable;
+
+			if (page->frame != NULL)
+				dontneed_cnt++;
+			spt_remove_page (&page->owner->spt, page);
+			return vm_alloc_page (VM_ANON, va, writable);
+		}
+		default: {
+			bool lock_held = lock_held_by_current_thread (&filesys_lock);
+			bool success = true;
+
+			if (page->file.share != NULL)
+				vm_share_unmap (page);
+			/* With the file system lock held, the write-back of a dirty
+			 * page cannot fail for want of it. */
+			if (!lock_held)
+				lock_acquire (&filesys_lock);
+			lock_acquire (&frame_lock);
+			frame = page->frame;
+			if (frame != NULL) {
+				success = !frame->pinned && frame_evict (frame);
+				if (success) {
+					frame_free (frame);
+					dontneed_cnt++;
+				}
+			}
+			lock_release (&frame_lock);
+			if (!lock_held)
+				lock_release (&filesys_lock);
+			return success;
+		}
+	}
+}
+
+/* Applies madvise() ADVICE to PAGE. */
+static bool
+vm_advise_page (struct page *page, int advice) {
+	switch (advice) {
+		case MADV_WILLNEED:
+			if ((vm_needs_read (page) || vm_is_swapped (page))
+					&& vm_load_ahead (page))
+				willneed_cnt++;
+			return true;
+		case MADV_DONTNEED:
+			return vm_reclaim_page (page);
+		case MADV_FREE:
+			/* Only anonymous contents can be thrown away. */
+			if (VM_TYPE (page->operations->type) != VM_ANON || page->locked)
+				return true;
+			lock_acquire (&frame_lock);
+			if (page->frame != NULL && !page->frame->pinned) {
+				pml4_set_dirty (page->owner->pml4, page->va, false);
+				pml4_set_accessed (page->owner->pml4, page->va, false);
+				page->ws_ref = false;
+				page->advice = MADV_FREE;
+			}
+			lock_release (&frame_lock);
+			return true;
+		default:
+			page->advice = advice;
+			return true;
+	}
+}
+
+/* Returns true if [START, END) is a range of user pages. */
+static bool
+is_user_range (uint8_t *start, uint8_t *end) {
+	return pg_ofs (start) == 0 && pg_ofs (end) == 0 && start <= end
+		&& is_user_vaddr (start) && (end == start || is_user_vaddr (end - 1));
+}
+
+/* Applies madvise() ADVICE, one of MADV_*, to the pages of the current
+ * process in the LENGTH bytes at page-aligned ADDR.  Returns false if
+ * the arguments are invalid or some of the pages are not mapped or
+ * locked. */
+bool
+vm_madvise (void *addr, size_t length, int advice) {
+	struct thread *curr = thread_current ();
+	uint8_t *start = addr;
+	uint8_t *end = start + ROUND_UP (length, PGSIZE);
+	bool success = true;
+
+	if (advice < MADV_NORMAL || advice > MADV_FREE
+			|| !is_user_range (start, end))
+		return false;
+
+	/* The access pattern also steers readahead in the areas. */
+	if (advice <= MADV_SEQUENTIAL)
+		for (struct list_elem *e = list_begin (&curr->spt.areas);
+				e != list_end (&curr->spt.areas); e = list_next (e)) {
+			struct vm_area *area = list_entry (e, struct vm_area, elem);
+
+			if ((uint8_t *) area->start < end && (uint8_t *) area->end > start) {
+				area->advice = advice;
+				area->ra_pages = 0;
+			}
+		}
+
+	for (uint8_t *va = start; va < end; va += PGSIZE) {
+		struct page *page = spt_find_page (&curr->spt, va);
+
+		if (page == NULL || !vm_advise_page (page, advice))
+			success = false;
+	}
+	return success;
+}
+
+/* Locks the pages of the current process in the LENGTH bytes at ADDR in
+ * memory if LOCK, loading them first, or unlocks them otherwise.  Returns
+ * false if some of the pages are not mapped, could not be loaded, or
+ * would take the process over MLOCK_LIMIT_PAGES locked pages. */
+bool
+vm_mlock (void *addr, size_t length, bool lock) {
+	struct thread *curr = thread_current ();
+	uint8_t *start = pg_round_down (addr);
+	uint8_t *end = pg_round_up ((uint8_t *) addr + length);
+
+	if ((uint8_t *) addr + length < (uint8_t *) addr
+			|| !is_user_range (start, end))
+		return false;
+
+	for (uint8_t *va = start; va < end; va += PGSIZE) {
+		struct page *page = spt_find_page (&curr->spt, va);
+
+		if (page == NULL)
+			return false;
+		if (!lock) {
+			if (page->locked)
+				curr->mem.locked--;
+			page->locked = false;
+		} else if (!page->locked) {
+			if (curr->mem.locked >= MLOCK_LIMIT_PAGES || !vm_pin_page (page))
+				return false;
+			page->locked = true;
+			curr->mem.locked++;
+			vm_unpin_page (page);
+		}
+	}
+	return true;
 }
 
 /* Handle the fault on write_protected page */
 static bool
-vm_handle_wp (struct page *page UNUSED) {
+vm_handle_wp (struct page *page) {
+	/* First write to a page that was only read so far: give it a frame of
+	 * its own. */
+	if (page->zero_mapped && page->writable) {
+		zero_break_cnt++;
+		return vm_do_claim_page (page);
+	}
+
+	/* Same for a page merged with others of the same contents. */
+	if (VM_TYPE (page->operations->type) == VM_ANON
+			&& page->anon.state == ANON_KSM && page->writable)
+		return vm_do_claim_page (page);
+	return false;
+}
+
+/* Returns true if PAGE is an anonymous page whose contents are out on the
+ * swap disk. */
+static bool
+vm_on_swap_disk (struct page *page) {
+	return VM_TYPE (page->operations->type) == VM_ANON
+		&& page->anon.state == ANON_SWAP_DISK;
 }
 
 /* Return true on success */
 bool
-vm_try_handle_fault (struct intr_frame *f UNUSED, void *addr UNUSED,
-		bool user UNUSED, bool write UNUSED, bool not_present UNUSED) {
-	struct supplemental_page_table *spt UNUSED = &thread_current ()->spt;
+vm_try_handle_fault (struct intr_frame *f, void *addr,
+		bool user, bool write, bool not_present) {
+	struct thread *curr = thread_current ();
 	struct page *page = NULL;
-	/* TODO: Validate the fault */
-	/* TODO: Your code goes here */
+	bool major;
 
-	return vm_do_claim_page (page);
+	/* Validate the fault */
+	if (addr == NULL || is_kernel_vaddr (addr))
+		return false;
+
+	page = spt_find_page (&curr->spt, addr);
+	if (page == NULL) {
+		/* In the kernel, rsp is the kernel stack's: use the user's from
+		 * system call entry. */
+		void *rsp = user ? (void *) f->rsp : curr->user_rsp;
+
+		if (!not_present || !vm_is_stack_access (addr, rsp)
+				|| !vm_stack_growth (addr))
+			return false;
+		curr->mem.minor_faults++;
+		return true;
+	}
+
+	/* Faults that have to wait for a file or the swap disk are major. */
+	major = not_present && (vm_needs_read (page) || vm_on_swap_disk (page));
+	if (!vm_handle_fault (page, write, not_present))
+		return false;
+	if (major)
+		curr->mem.major_faults++;
+	else
+		curr->mem.minor_faults++;
+	return true;
+}
+
+/* Resolves a fault on PAGE. */
+static bool
+vm_handle_fault (struct page *page, bool write, bool not_present) {
+	if (!not_present)
+		return vm_handle_wp (page);
+
+	if (write && !page->writable)
+		return false;
+
+	/* Reads of untouched anonymous memory all share one zero frame. */
+	if (!write && vm_is_zero_fill (page))
+		return vm_zero_map (page);
+
+	if (page->frame != NULL || vm_is_share_mapped (page)) {
+		/* The page is being evicted or merged right now.  Let that finish,
+		 * then load it back, or just retry if it got mapped again. */
+		lock_acquire (&frame_lock);
+		lock_release (&frame_lock);
+		if (pml4_get_page (page->owner->pml4, page->va) != NULL)
+			return true;
+		if (page->frame != NULL)
+			return false;
+	}
+
+	if (vm_is_shareable (page) ? !vm_share_map (page, true)
+			: !vm_do_claim_page (page))
+		return false;
+	vm_fault_around (page);
+	vm_prefetch (page, write);
+	return true;
 }
 
 /* Free the page.
@@ -150,41 +1590,261 @@ vm_dealloc_page (struct page *page) {
 
 /* Claim the page that allocate on VA. */
 bool
-vm_claim_page (void *va UNUSED) {
-	struct page *page = NULL;
-	/* TODO: Fill this function */
+vm_claim_page (void *va) {
+	struct page *page = spt_find_page (&thread_current ()->spt, va);
 
+	if (page == NULL)
+		return false;
 	return vm_do_claim_page (page);
 }
 
 /* Claim the PAGE and set up the mmu. */
 static bool
 vm_do_claim_page (struct page *page) {
-	struct frame *frame = vm_get_frame ();
+	return vm_claim_frame (page, vm_get_frame ());
+}
+
+/* Loads PAGE into FRAME, a pinned frame from vm_alloc_frame(), and maps
+ * it.  FRAME may be null, in which case this fails. */
+static bool
+vm_claim_frame (struct page *page, struct frame *frame) {
+	if (frame == NULL)
+		return false;
+
+	/* The page stops sharing the zero frame or a frame of the page index;
+	 * its own copy is mapped below. */
+	vm_zero_unmap (page);
+	if (vm_is_share_mapped (page))
+		vm_share_unmap (page);
+	/* The contents are live again until the next madvise(). */
+	if (page->advice == MADV_FREE)
+		page->advice = MADV_NORMAL;
+
+	/* Swapped-out anonymous contents are about to come back. */
+	bool was_swapped = VM_TYPE (page->operations->type) == VM_ANON
+		&& (page->anon.state == ANON_SWAP_ZERO
+				|| page->anon.state == ANON_SWAP_POOL
+				|| page->anon.state == ANON_SWAP_DISK);
 
 	/* Set links */
-	frame->page = page;
-	page->frame = frame;
+	lock_acquire (&frame_lock);
+	frame_attach (page, frame);
+	lock_release (&frame_lock);
+
+	/* Fill the frame before the user can see it, then map it. */
+	if (!swap_in (page, frame->kva)
+			|| !pml4_set_page (page->owner->pml4, page->va, frame->kva,
+				page->writable)) {
+		vm_free_frame (page);
+		return false;
+	}
+
+	lock_acquire (&frame_lock);
+	if (was_swapped)
+		page->owner->mem.swapped--;
+	frame->pinned = false;
+	lock_release (&frame_lock);
+	return true;
+}
 
-	/* TODO: Insert page table entry to map page's VA to frame's PA. */
+/* Hash function and ordering for the pages of a supplemental page table. */
+static uint64_t
+page_hash (const struct hash_elem *e, void *aux UNUSED) {
+	const struct page *p = hash_entry (e, struct page, spt_elem);
+	return hash_bytes (&p->va, sizeof p->va);
+}
 
-	return swap_in (page, frame->kva);
+static bool
+page_less (const struct hash_elem *a, const struct hash_elem *b,
+		void *aux UNUSED) {
+	return hash_entry (a, struct page, spt_elem)->va
+		< hash_entry (b, struct page, spt_elem)->va;
 }
 
 /* Initialize new supplemental page table */
 void
-supplemental_page_table_init (struct supplemental_page_table *spt UNUSED) {
+supplemental_page_table_init (struct supplemental_page_table *spt) {
+	hash_init (&spt->pages, page_hash, page_less, NULL);
+	list_init (&spt->areas);
+	spt->stack_bottom = NULL;
+}
+
+/* Returns the file that backs VA in the child (the current thread), given
+ * that it is FILE in the parent. */
+static struct file *
+copy_file_of (void *va, struct file *file) {
+	struct vm_area *area = vm_area_find (va);
+	return area != NULL ? area->file : file;
+}
+
+/* Copies one page of the parent into the child (the current thread). */
+static bool
+copy_page (struct page *src) {
+	struct thread *curr = thread_current ();
+	enum vm_type type = page_get_type (src);
+	struct page *dst;
+	bool success;
+
+	if (VM_TYPE (src->operations->type) == VM_UNINIT) {
+		/* Not touched yet: just share how to load it. */
+		struct lazy_load_info *aux = NULL;
+
+		if (src->uninit.aux != NULL) {
+			aux = malloc (sizeof *aux);
+			if (aux == NULL)
+				return false;
+			memcpy (aux, src->uninit.aux, sizeof *aux);
+			aux->file = copy_file_of (src->va, aux->file);
+		}
+		if (!vm_alloc_page_with_initializer (src->uninit.type, src->va,
+					src->writable, src->uninit.init, aux)) {
+			free (aux);
+			return false;
+		}
+		return true;
+	}
+
+	if (type == VM_FILE) {
+		/* Same place in the child's copy of the file.  If the parent has
+		 * the page in memory its contents may differ from the file, so
+		 * they are copied below like an anonymous page's. */
+		struct lazy_load_info *aux = malloc (sizeof *aux);
+
+		if (aux == NULL)
+			return false;
+		aux->file = copy_file_of (src->va, src->file.file);
+		aux->ofs = src->file.ofs;
+		aux->read_bytes = src->file.read_bytes;
+		aux->zero_bytes = src->file.zero_bytes;
+		if (!vm_alloc_page_with_initializer (VM_FILE, src->va, src->writable,
+					file_lazy_load, aux)) {
+			free (aux);
+			return false;
+		}
+		if (!vm_pin_resident (src))
+			return true;
+	} else {
+		if (!vm_alloc_page (type, src->va, src->writable))
+			return false;
+		if (!vm_pin_page (src))
+			return false;
+	}
+	dst = spt_find_page (&curr->spt, src->va);
+
+	success = vm_pin_page (dst);
+	if (success) {
+		memcpy (dst->frame->kva, src->frame->kva, PGSIZE);
+		if (type == VM_FILE && pml4_is_dirty (src->owner->pml4, src->va))
+			pml4_set_dirty (curr->pml4, dst->va, true);
+		vm_unpin_page (dst);
+	}
+	vm_unpin_page (src);
+	return success;
+}
+
+/* Copies the parent's vm_area SRC into the child (the current thread).
+ * Areas of the executable use the child's copy of it; mmap()ed areas get
+ * their own handle on the file. */
+static bool
+copy_area (struct vm_area *src, struct thread *parent) {
+	struct thread *curr = thread_current ();
+	struct vm_area *area;
+	struct file *file;
+
+	if (src->file == parent->running)
+		file = curr->running;
+	else if (src->mmapped)
+		file = file_duplicate (src->file);
+	else
+		file = src->file;
+	if (file == NULL)
+		return false;
+
+	area = vm_area_create (src->start, src->end, file, src->mmapped);
+	if (area == NULL) {
+		if (src->mmapped)
+			file_close (file);
+		return false;
+	}
+	area->advice = src->advice;
+	return true;
 }
 
 /* Copy supplemental page table from src to dst */
 bool
-supplemental_page_table_copy (struct supplemental_page_table *dst UNUSED,
-		struct supplemental_page_table *src UNUSED) {
+supplemental_page_table_copy (struct supplemental_page_table *dst,
+		struct supplemental_page_table *src) {
+	struct thread *parent = (struct thread *) ((uint8_t *) src
+			- offsetof (struct thread, spt));
+	struct hash_iterator i;
+
+	/* Areas first, so that copy_page() can find the child's files. */
+	for (struct list_elem *e = list_begin (&src->areas);
+			e != list_end (&src->areas); e = list_next (e))
+		if (!copy_area (list_entry (e, struct vm_area, elem), parent))
+			return false;
+
+	dst->stack_bottom = src->stack_bottom;
+	hash_first (&i, &src->pages);
+	while (hash_next (&i))
+		if (!copy_page (hash_entry (hash_cur (&i), struct page, spt_elem)))
+			return false;
+	return true;
+}
+
+static void
+spt_destroy_page (struct hash_elem *e, void *aux UNUSED) {
+	vm_dealloc_page (hash_entry (e, struct page, spt_elem));
+}
+
+/* Moves the elements of list A to list B and those of B to A. */
+static void
+swap_lists (struct list *a, struct list *b) {
+	struct list tmp;
+
+	list_init (&tmp);
+	while (!list_empty (a))
+		list_push_back (&tmp, list_pop_front (a));
+	while (!list_empty (b))
+		list_push_back (a, list_pop_front (b));
+	while (!list_empty (&tmp))
+		list_push_back (b, list_pop_front (&tmp));
+}
+
+/* Hands the address space of FROM, its pages, areas and memory counters,
+ * to TO in exchange for TO's, without copying any page.  This is how a
+ * vfork()ed child borrows its parent's address space and gives it back.
+ * FROM must not run meanwhile. */
+void
+supplemental_page_table_move (struct thread *to, struct thread *from) {
+	struct hash pages = to->spt.pages;
+	void *stack_bottom = to->spt.stack_bottom;
+	struct memstat mem = to->mem;
+	struct hash_iterator i;
+
+	to->spt.pages = from->spt.pages;
+	from->spt.pages = pages;
+	to->spt.stack_bottom = from->spt.stack_bottom;
+	from->spt.stack_bottom = stack_bottom;
+	swap_lists (&to->spt.areas, &from->spt.areas);
+	to->mem = from->mem;
+	from->mem = mem;
+
+	/* The evictor finds page tables through the owners. */
+	lock_acquire (&frame_lock);
+	hash_first (&i, &to->spt.pages);
+	while (hash_next (&i))
+		hash_entry (hash_cur (&i), struct page, spt_elem)->owner = to;
+	lock_release (&frame_lock);
 }
 
 /* Free the resource hold by the supplemental page table */
 void
-supplemental_page_table_kill (struct supplemental_page_table *spt UNUSED) {
-	/* TODO: Destroy all the supplemental_page_table hold by thread and
-	 * TODO: writeback all the modified contents to the storage. */
+supplemental_page_table_kill (struct supplemental_page_table *spt) {
+	/* Destroy all the supplemental_page_table hold by thread and
+	 * writeback all the modified contents to the storage. */
+	hash_destroy (&spt->pages, spt_destroy_page);
+	while (!list_empty (&spt->areas))
+		vm_area_destroy (list_entry (list_front (&spt->areas),
+					struct vm_area, elem));
 }
@@ -0,0 +1,373 @@
+/* zswap.c: Compressed in-memory cache in front of the swap disk.
+ *
+ * Swapping a page to the disk costs 8 synchronous sector transfers, while
+ * most anonymous pages compress well (sparse arrays, freshly touched stack
+ * pages, ...).  anon_swap_out() therefore first tries to compress the page
+ * with a small LZ77 compressor and keep it in a pool of kernel pages.  Two
+ * compressed pages share one pool page ("zbud"): the first is packed at the
+ * start of the page, the last at the end.  When the pool reaches
+ * zswap_pool_limit pages, or a page does not compress below what fits in a
+ * buddy slot, the page goes to the swap disk as before. */
+
+#include "vm/zswap.h"
+#include <debug.h>
+#include <list.h>
+#include <stdio.h>
+#include <string.h>
+#include "threads/palloc.h"
+#include "threads/synch.h"
+#include "threads/vaddr.h"
+
+/* Default size of the compressed pool, in pages (512 kB). */
+#define ZSWAP_DEFAULT_POOL_PAGES 128
+
+size_t zswap_pool_limit = ZSWAP_DEFAULT_POOL_PAGES;
+
+/* Header at the start of every pool page. */
+struct zbud_page {
+	struct list_elem elem;      /* Element of unbuddied or buddied. */
+	uint16_t first_size;        /* Bytes of the first buddy, 0 if free. */
+	uint16_t last_size;         /* Bytes of the last buddy, 0 if free. */
+};
+
+#define ZBUD_DATA_OFS sizeof (struct zbud_page)
+#define ZBUD_DATA_SIZE (PGSIZE - ZBUD_DATA_OFS)
+
+/* Low bits of a handle tell which buddy of the pool page it is. */
+#define ZBUD_FIRST 1
+#define ZBUD_LAST 2
+#define ZBUD_MASK 3
+
+static struct list unbuddied;   /* Pool pages with one free buddy. */
+static struct list buddied;     /* Pool pages with both buddies used. */
+static size_t pool_pages;       /* Pages currently in the pool. */
+static struct lock zswap_lock;  /* Protects the pool and the buffers. */
+
+/* Statistics. */
+static long long out_cnt[ZSWAP_TIER_CNT];   /* Pages swapped out per tier. */
+static long long in_cnt[ZSWAP_TIER_CNT];    /* Pages swapped in per tier. */
+static uint64_t in_cycles[ZSWAP_TIER_CNT];  /* TSC cycles spent in swap-in. */
+static long long reject_cnt;                /* Did not compress enough. */
+static long long pool_full_cnt;             /* Spilled because pool full. */
+static uint64_t orig_bytes;                 /* Bytes before compression. */
+static uint64_t comp_bytes;                 /* Bytes after compression. */
+
+/* LZ77 compressor in the spirit of LZ4.  The stream is a series of
+ * sequences, each one a token byte (literal count in the high nibble, match
+ * length minus LZ_MIN_MATCH in the low nibble, 15 meaning "more length
+ * bytes follow"), the literals, and a 2-byte little-endian match offset.
+ * The final sequence carries literals only. */
+#define LZ_MIN_MATCH 4
+#define LZ_HASH_BITS 12
+#define LZ_MAX_OFFSET 0xffff
+
+static uint16_t lz_table[1 << LZ_HASH_BITS];
+static uint8_t lz_buf[PGSIZE];
+
+static inline uint32_t
+lz_read32 (const uint8_t *p) {
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+static inline size_t
+lz_hash (uint32_t seq) {
+	return (seq * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+/* Appends the extra bytes of a length that did not fit in its nibble. */
+static bool
+lz_put_len (uint8_t **op, uint8_t *oend, size_t len) {
+	for (; len >= 255; len -= 255) {
+		if (*op >= oend)
+			return false;
+		*(*op)++ = 255;
+	}
+	if (*op >= oend)
+		return false;
+	*(*op)++ = len;
+	return true;
+}
+
+/* Emits one sequence.  MATCH_LEN == 0 means literals only. */
+static bool
+lz_put_seq (uint8_t **op, uint8_t *oend, const uint8_t *lit, size_t lit_len,
+		size_t offset, size_t match_len) {
+	uint8_t *token = *op;
+	size_t ml = match_len ? match_len - LZ_MIN_MATCH : 0;
+
+	if (*op >= oend)
+		return false;
+	(*op)++;
+	*token = (lit_len < 15 ? lit_len : 15) << 4 | (ml < 15 ? ml : 15);
+	if (lit_len >= 15 && !lz_put_len (op, oend, lit_len - 15))
+		return false;
+	if ((size_t) (oend - *op) < lit_len)
+		return false;
+	memcpy (*op, lit, lit_len);
+	*op += lit_len;
+
+	if (match_len == 0)
+		return true;
+	if (oend - *op < 2)
+		return false;
+	*(*op)++ = offset & 0xff;
+	*(*op)++ = offset >> 8;
+	return ml < 15 || lz_put_len (op, oend, ml - 15);
+}
+
+/* Compresses LEN bytes at SRC into at most CAP bytes at DST.  Returns the
+ * compressed size, or 0 if it does not fit. */
+static size_t
+lz_compress (const uint8_t *src, size_t len, uint8_t *dst, size_t cap) {
+	const uint8_t *ip = src, *anchor = src;
+	const uint8_t *end = src + len;
+	uint8_t *op = dst, *oend = dst + cap;
+
+	memset (lz_table, 0, sizeof lz_table);
+	while (ip + LZ_MIN_MATCH <= end) {
+		uint32_t seq = lz_read32 (ip);
+		size_t h = lz_hash (seq);
+		const uint8_t *ref = src + lz_table[h];
+
+		lz_table[h] = ip - src;
+		if (ref >= ip || ip - ref > LZ_MAX_OFFSET || lz_read32 (ref) != seq) {
+			ip++;
+			continue;
+		}
+
+		const uint8_t *mp = ip + LZ_MIN_MATCH;
+		ref += LZ_MIN_MATCH;
+		while (mp < end && *mp == *ref) {
+			mp++;
+			ref++;
+		}
+		if (!lz_put_seq (&op, oend, anchor, ip - anchor, mp - ref,
+					mp - ip))
+			return 0;
+		ip = anchor = mp;
+	}
+	if (!lz_put_seq (&op, oend, anchor, end - anchor, 0, 0))
+		return 0;
+	return op - dst;
+}
+
+/* Reads the extra bytes of a length. */
+static bool
+lz_get_len (const uint8_t **ip, const uint8_t *iend, size_t *len) {
+	uint8_t b;
+	do {
+		if (*ip >= iend)
+			return false;
+		b = *(*ip)++;
+		*len += b;
+	} while (b == 255);
+	return true;
+}
+
+/* Decompresses SRC_LEN bytes at SRC into exactly LEN bytes at DST.
+ * Returns false if the stream is corrupt. */
+static bool
+lz_decompress (const uint8_t *src, size_t src_len, uint8_t *dst, size_t len) {
+	const uint8_t *ip = src, *iend = src + src_len;
+	uint8_t *op = dst, *oend = dst + len;
+
+	while (ip < iend) {
+		uint8_t token = *ip++;
+		size_t lit_len = token >> 4;
+		size_t match_len = token & 15;
+
+		if (lit_len == 15 && !lz_get_len (&ip, iend, &lit_len))
+			return false;
+		if ((size_t) (iend - ip) < lit_len || (size_t) (oend - op) < lit_len)
+			return false;
+		memcpy (op, ip, lit_len);
+		ip += lit_len;
+		op += lit_len;
+		if (ip == iend)
+			break;
+
+		if (iend - ip < 2)
+			return false;
+		size_t offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+		if (match_len == 15 && !lz_get_len (&ip, iend, &match_len))
+			return false;
+		match_len += LZ_MIN_MATCH;
+		if (offset == 0 || offset > (size_t) (op - dst)
+				|| (size_t) (oend - op) < match_len)
+			return false;
+
+		/* Byte by byte: the match may overlap what it produces. */
+		const uint8_t *ref = op - offset;
+		while (match_len-- > 0)
+			*op++ = *ref++;
+	}
+	return op == oend;
+}
+
+/* Initializes the compressed pool. */
+void
+zswap_init (void) {
+	list_init (&unbuddied);
+	list_init (&buddied);
+	lock_init (&zswap_lock);
+	pool_pages = 0;
+}
+
+/* Returns the free bytes between the two buddies of ZP. */
+static size_t
+zbud_free_bytes (const struct zbud_page *zp) {
+	return ZBUD_DATA_SIZE - zp->first_size - zp->last_size;
+}
+
+/* Finds room for SIZE bytes, growing the pool if allowed.  Returns the
+ * handle of the reserved buddy, or 0 if the pool is full. */
+static zswap_handle_t
+zbud_alloc (size_t size) {
+	struct zbud_page *zp = NULL;
+	struct list_elem *e;
+
+	for (e = list_begin (&unbuddied); e != list_end (&unbuddied);
+			e = list_next (e)) {
+		struct zbud_page *cand = list_entry (e, struct zbud_page, elem);
+		if (zbud_free_bytes (cand) >= size) {
+			zp = cand;
+			break;
+		}
+	}
+
+	if (zp == NULL) {
+		if (pool_pages >= zswap_pool_limit)
+			return 0;
+		zp = palloc_get_page (0);
+		if (zp == NULL)
+			return 0;
+		zp->first_size = zp->last_size = 0;
+		pool_pages++;
+	} else
+		list_remove (&zp->elem);
+
+	if (zp->first_size == 0) {
+		zp->first_size = size;
+		list_push_back (zp->last_size ? &buddied : &unbuddied, &zp->elem);
+		return (zswap_handle_t) zp | ZBUD_FIRST;
+	}
+	zp->last_size = size;
+	list_push_back (&buddied, &zp->elem);
+	return (zswap_handle_t) zp | ZBUD_LAST;
+}
+
+/* Returns the data and size of the buddy HANDLE refers to. */
+static uint8_t *
+zbud_map (zswap_handle_t handle, size_t *size) {
+	struct zbud_page *zp = (struct zbud_page *) (handle & ~ZBUD_MASK);
+
+	if ((handle & ZBUD_MASK) == ZBUD_FIRST) {
+		*size = zp->first_size;
+		return (uint8_t *) zp + ZBUD_DATA_OFS;
+	}
+	*size = zp->last_size;
+	return (uint8_t *) zp + PGSIZE - zp->last_size;
+}
+
+/* Compresses the page at KVA into the pool.  On success stores the handle
+ * in *HANDLE and returns true; returns false if the page has to go to the
+ * disk instead. */
+bool
+zswap_store (const void *kva, zswap_handle_t *handle) {
+	size_t size, slot_size;
+	uint8_t *slot;
+	bool success = false;
+
+	if (zswap_pool_limit == 0)
+		return false;
+
+	lock_acquire (&zswap_lock);
+	size = lz_compress (kva, PGSIZE, lz_buf, ZBUD_DATA_SIZE);
+	if (size == 0)
+		reject_cnt++;
+	else if ((*handle = zbud_alloc (size)) == 0)
+		pool_full_cnt++;
+	else {
+		slot = zbud_map (*handle, &slot_size);
+		memcpy (slot, lz_buf, size);
+		orig_bytes += PGSIZE;
+		comp_bytes += size;
+		success = true;
+	}
+	lock_release (&zswap_lock);
+	return success;
+}
+
+/* Decompresses the page HANDLE refers to into KVA.  The pool keeps its
+ * copy until zswap_free(). */
+bool
+zswap_load (zswap_handle_t handle, void *kva) {
+	size_t size;
+	bool success;
+
+	lock_acquire (&zswap_lock);
+	uint8_t *slot = zbud_map (handle, &size);
+	success = lz_decompress (slot, size, kva, PGSIZE);
+	lock_release (&zswap_lock);
+	return success;
+}
+
+/* Releases the buddy HANDLE refers to, and its pool page once both of the
+ * buddies are free. */
+void
+zswap_free (zswap_handle_t handle) {
+	struct zbud_page *zp = (struct zbud_page *) (handle & ~ZBUD_MASK);
+
+	lock_acquire (&zswap_lock);
+	if ((handle & ZBUD_MASK) == ZBUD_FIRST)
+		zp->first_size = 0;
+	else
+		zp->last_size = 0;
+
+	list_remove (&zp->elem);
+	if (zp->first_size == 0 && zp->last_size == 0) {
+		palloc_free_page (zp);
+		pool_pages--;
+	} else
+		list_push_back (&unbuddied, &zp->elem);
+	lock_release (&zswap_lock);
+}
+
+/* Accounts for one page swapped out to TIER. */
+void
+zswap_count_out (enum zswap_tier tier) {
+	out_cnt[tier]++;
+}
+
+/* Accounts for one page swapped in from TIER in CYCLES TSC cycles. */
+void
+zswap_count_in (enum zswap_tier tier, uint64_t cycles) {
+	in_cnt[tier]++;
+	in_cycles[tier] += cycles;
+}
+
+/* Prints swap statistics. */
+void
+zswap_print_stats (void) {
+	static const char *names[ZSWAP_TIER_CNT] = { "zero", "zswap", "disk" };
+	long long ins = 0, hits;
+	int i;
+
+	for (i = 0; i < ZSWAP_TIER_CNT; i++)
+		ins += in_cnt[i];
+	hits = in_cnt[ZSWAP_TIER_ZERO] + in_cnt[ZSWAP_TIER_POOL];
+
+	printf ("Swap: %lld zero, %lld compressed, %lld disk pages out "
+			"(%lld incompressible, %lld pool full)\n",
+			out_cnt[ZSWAP_TIER_ZERO], out_cnt[ZSWAP_TIER_POOL],
+			out_cnt[ZSWAP_TIER_DISK], reject_cnt, pool_full_cnt);
+	printf ("Swap: compression %llu%% of %llu bytes, %zu pool pages, "
+			"%lld%% swap-in hit rate\n",
+			orig_bytes ? comp_bytes * 100 / orig_bytes : 0, orig_bytes,
+			pool_pages, ins ? hits * 100 / ins : 0);
+	for (i = 0; i < ZSWAP_TIER_CNT; i++)
+		if (in_cnt[i] > 0)
+			printf ("Swap: %lld %s swap-ins, %llu cycles avg\n", in_cnt[i],
+					names[i], in_cycles[i] / in_cnt[i]);
+}